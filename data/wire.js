@@ -0,0 +1,110 @@
+// Décodeur du protocole binaire du flux temps réel (voir src/WireProtocol.h)
+//
+// Utilisation :
+//   const decoder = new WireDecoder(ws);
+//   ws.onmessage = (event) => { const data = decoder.decode(event.data); if (data) ... };
+// decode() retourne une trame au même format que le flux JSON
+// ({timestamp, objectCount, confidence, fps, latency, points, labels, sequence})
+// ou null pour un message de table d'étiquettes ou une trame ignorée.
+class WireDecoder {
+    static MSG_LABELS = 1;
+    static MSG_KEYFRAME = 2;
+    static MSG_DELTA = 3;
+
+    constructor(ws) {
+        this.ws = ws;
+        this.labels = [];
+        this.previousPoints = [];
+        this.lastSequence = null;
+        this.lostFrames = 0;
+        ws.binaryType = 'arraybuffer';
+    }
+
+    // À appeler dans onopen
+    negotiate() {
+        this.labels = [];
+        this.previousPoints = [];
+        this.lastSequence = null;
+        this.ws.send(JSON.stringify({command: 'protocol', value: 'binary'}));
+    }
+
+    decode(message) {
+        // Le serveur reste en JSON tant que la négociation n'a pas abouti
+        if (typeof message === 'string') {
+            return JSON.parse(message);
+        }
+
+        const bytes = new Uint8Array(message);
+        const reader = {offset: 1};
+        const varint = () => {
+            let value = 0;
+            let shift = 0;
+            while (reader.offset < bytes.length) {
+                const byte = bytes[reader.offset++];
+                value += (byte & 0x7F) * Math.pow(2, shift);
+                if (!(byte & 0x80)) return value;
+                shift += 7;
+            }
+            throw new Error('varint tronqué');
+        };
+        const unzigzag = (value) => (value % 2) ? -(value + 1) / 2 : value / 2;
+
+        const type = bytes[0];
+        if (type === WireDecoder.MSG_LABELS) {
+            const start = varint();
+            const count = varint();
+            if (start === 0) this.labels = [];
+            const text = new TextDecoder();
+            for (let i = 0; i < count; i++) {
+                const length = varint();
+                this.labels[start + i] = text.decode(bytes.subarray(reader.offset, reader.offset + length));
+                reader.offset += length;
+            }
+            return null;
+        }
+
+        if (type !== WireDecoder.MSG_KEYFRAME && type !== WireDecoder.MSG_DELTA) {
+            return null;
+        }
+
+        const frame = {
+            sequence: varint(),
+            timestamp: varint(),
+            confidence: varint() / 1000,
+            objectCount: varint(),
+            fps: varint() / 10,
+            latency: varint(),
+            points: [],
+            labels: []
+        };
+
+        // Un DELTA ne vaut que si la trame précédente a été reçue
+        if (type === WireDecoder.MSG_DELTA && this.lastSequence !== frame.sequence - 1) {
+            this.lostFrames++;
+            this.lastSequence = null;
+            this.ws.send(JSON.stringify({command: 'keyframe'}));
+            return null;
+        }
+
+        const pointCount = varint();
+        for (let i = 0; i < pointCount; i++) {
+            let x = unzigzag(varint());
+            let y = unzigzag(varint());
+            if (type === WireDecoder.MSG_DELTA && i < this.previousPoints.length) {
+                x += this.previousPoints[i].x;
+                y += this.previousPoints[i].y;
+            }
+            frame.points.push({x, y});
+        }
+
+        const labelCount = varint();
+        for (let i = 0; i < labelCount; i++) {
+            const id = varint();
+            frame.labels.push(this.labels[id] !== undefined ? this.labels[id] : '?');
+        }
+
+        this.previousPoints = frame.points;
+        this.lastSequence = frame.sequence;
+        return frame;
+    }
+}
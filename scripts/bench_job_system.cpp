@@ -0,0 +1,33 @@
+// Mesure de montée en charge du JobSystem sur l'hôte (1 à 8 participants).
+// Sur la carte, la même mesure (1 et 2 participants) est journalisée au
+// démarrage quand le firmware est compilé avec -DJOB_SYSTEM_BENCHMARK.
+//
+//   g++ -O2 -std=c++17 -pthread -Isrc/performance scripts/bench_job_system.cpp src/performance/JobSystem.cpp -o /tmp/bench_jobs
+//   /tmp/bench_jobs [itérations]
+
+#include "JobSystem.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    uint32_t iterations = argc > 1 ? atoi(argv[1]) : 2000;
+    
+    JobSystem jobs;
+    jobs.begin(JobSystem::MAX_WORKERS);
+    
+    printf("participants  us/convolution  accélération\n");
+    float reference = 0.0f;
+    for (size_t workers = 1; workers <= jobs.getWorkerCount(); workers++) {
+        JobSystemBenchmark result = JobSystem::benchmark(jobs, workers, iterations);
+        if (workers == 1) reference = result.usPerRun;
+        printf("%12zu  %14.1f  %11.2fx\n", result.workers, result.usPerRun,
+               result.usPerRun > 0 ? reference / result.usPerRun : 0.0f);
+    }
+    
+    JobSystemStats stats = jobs.getStats();
+    printf("boucles réparties %u, séquentielles %u\n", stats.loops, stats.serialLoops);
+    for (size_t i = 0; i < jobs.getWorkerCount(); i++) {
+        printf("  participant %zu : %u tranches, %u vols\n", i, stats.chunks[i], stats.steals[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// Banc du programme de règles compilé sur l'hôte : coût de compilation par
+// règle, coût d'évaluation par trame, et allocations pendant l'évaluation,
+// comptées par les crochets new/delete de HeapProfiler. Le chemin chaud doit
+// n'en faire aucune : le code de sortie est non nul sinon. Sur la carte, le
+// même banc est journalisé avec -DAUTOMATION_BENCHMARK (allocations à -1
+// sans CONFIG_HEAP_TRACING_STANDALONE).
+//
+//   g++ -O2 -std=c++17 -Wall -Wextra -pthread -Iscripts/host -Isrc scripts/bench_rule_program.cpp src/automation/RuleProgram.cpp src/automation/RuleParser.cpp src/automation/TemporalState.cpp src/performance/HeapProfiler.cpp -o /tmp/bench_rules
+//   /tmp/bench_rules [trames]
+
+#include "automation/RuleProgram.h"
+#include "performance/HeapProfiler.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    uint32_t frames = argc > 1 ? atoi(argv[1]) : 20000;
+    const uint16_t ruleCounts[] = {16, 64, 256};
+    
+    if (!HeapProfiler::isAvailable()) {
+        printf("profileur de tas indisponible : allocations non comptées\n");
+        return 1;
+    }
+    
+    int failures = 0;
+    printf("règles  us/règle (compilation)  us/trame  allocations\n");
+    for (uint16_t rules : ruleCounts) {
+        RuleProgramBenchmark result = RuleProgram::benchmark(rules, frames);
+        printf("%6u  %24.2f  %8.3f  %11d\n", result.rules, result.usCompilePerRule,
+               result.usPerFrame, result.allocations);
+        if (result.allocations != 0) failures++;
+    }
+    
+    printf(failures ? "%d banc(s) avec allocations\n" : "ok\n", failures);
+    return failures ? 1 : 0;
+}
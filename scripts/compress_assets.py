@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Prépare l'image du système de fichiers à partir de data/.
+
+- Les ressources web (.html, .js, .css, .svg, .ico) sont compressées en
+  gzip (niveau 9, sans horodatage : sortie reproductible) ; seule la
+  version .gz est embarquée.
+- Les ressources autres que HTML reçoivent un nom haché
+  (wire.js -> wire.3fa2c1d0.js) et les références sont réécrites dans les
+  pages : elles peuvent être mises en cache sans limite (immutable).
+- Les pages HTML gardent leur URL et sont revalidées (ETag fort + 304).
+- Les autres fichiers (VERSION, configurations JSON lues par le
+  firmware...) sont copiés tels quels.
+- /assets.idx décrit chaque ressource, une par ligne :
+  url<TAB>fichier<TAB>etag<TAB>type<TAB>immutable(0/1)
+
+Le répertoire produit est le data_dir de platformio.ini (.pio/www).
+Utilisation hors PlatformIO :
+    python3 scripts/compress_assets.py [--report]
+"""
+import gzip
+import hashlib
+import os
+import shutil
+import sys
+
+WEB_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+INDEX_FILE = "assets.idx"
+
+try:
+    Import("env")  # noqa: F821 (fourni par PlatformIO)
+except NameError:
+    env = None
+
+
+def project_dir():
+    if env is not None:
+        return env.subst("$PROJECT_DIR")
+    return os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def gzip_bytes(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def build(source_dir, output_dir):
+    """Construit output_dir, retourne la liste des ressources web"""
+    if os.path.exists(output_dir):
+        shutil.rmtree(output_dir)
+    os.makedirs(output_dir)
+
+    files = sorted(f for f in os.listdir(source_dir)
+                   if os.path.isfile(os.path.join(source_dir, f)))
+    contents = {}
+    for name in files:
+        with open(os.path.join(source_dir, name), "rb") as f:
+            contents[name] = f.read()
+
+    # Noms hachés d'abord, pour réécrire les références dans les pages
+    renamed = {}
+    for name in files:
+        base, ext = os.path.splitext(name)
+        if ext in WEB_TYPES and ext != ".html":
+            renamed[name] = "%s.%s%s" % (base, content_hash(contents[name])[:8], ext)
+
+    assets = []
+    for name in files:
+        base, ext = os.path.splitext(name)
+        data = contents[name]
+
+        if ext not in WEB_TYPES:
+            shutil.copy2(os.path.join(source_dir, name), os.path.join(output_dir, name))
+            continue
+
+        if ext in (".html", ".js", ".css"):
+            text = data.decode("utf-8")
+            for original, hashed in renamed.items():
+                text = text.replace('"/%s"' % original, '"/%s"' % hashed)
+                text = text.replace("'/%s'" % original, "'/%s'" % hashed)
+            data = text.encode("utf-8")
+
+        url_name = renamed.get(name, name)
+        compressed = gzip_bytes(data)
+        with open(os.path.join(output_dir, url_name + ".gz"), "wb") as f:
+            f.write(compressed)
+
+        assets.append({
+            "url": "/" + url_name,
+            "file": "/" + url_name + ".gz",
+            "etag": content_hash(data),
+            "type": WEB_TYPES[ext],
+            "immutable": name in renamed,
+            "raw": len(contents[name]),
+            "gz": len(compressed),
+        })
+
+    with open(os.path.join(output_dir, INDEX_FILE), "w") as f:
+        for asset in assets:
+            f.write("%s\t%s\t%s\t%s\t%d\n" % (asset["url"], asset["file"], asset["etag"],
+                                             asset["type"], asset["immutable"]))
+    return assets
+
+
+def report(assets):
+    """Octets transférés et lus en flash par chargement de page, avant/après.
+
+    Avant : chaque chargement relit et transfère les fichiers bruts.
+    Après : 1er chargement en gzip ; rechargement = 304 pour la page
+    (en-têtes seuls, ETag comparé en RAM, aucune lecture flash) et
+    ressources immutables servies par le cache du navigateur.
+    """
+    by_url = {a["url"]: a for a in assets}
+    print("\n%-22s %14s %16s %14s" % ("Page", "avant", "1er chargement", "rechargement"))
+    for asset in assets:
+        if asset["type"] != "text/html":
+            continue
+        with open(os.path.join(OUTPUT_DIR, asset["file"].lstrip("/")), "rb") as f:
+            html = gzip.decompress(f.read()).decode("utf-8")
+        page = [asset] + [a for url, a in by_url.items() if url != asset["url"] and url in html]
+
+        raw = sum(a["raw"] for a in page)
+        gz = sum(a["gz"] for a in page)
+        print("%-22s %12d o %14d o %12d o" % (asset["url"], raw, gz, 0))
+
+    total_raw = sum(a["raw"] for a in assets)
+    total_gz = sum(a["gz"] for a in assets)
+    print("Ressources web : %d o -> %d o en flash et sur le réseau (%.0f %%)\n" %
+          (total_raw, total_gz, 100.0 * total_gz / max(total_raw, 1)))
+
+
+PROJECT_DIR = project_dir()
+SOURCE_DIR = os.path.join(PROJECT_DIR, "data")
+OUTPUT_DIR = os.path.join(PROJECT_DIR, ".pio", "www")
+
+
+def main():
+    print("\n=== Compression des ressources web ===")
+    assets = build(SOURCE_DIR, OUTPUT_DIR)
+    for asset in assets:
+        print("  %-28s %6d -> %6d o  etag %s" % (asset["url"], asset["raw"], asset["gz"], asset["etag"]))
+    if "--report" in sys.argv:
+        report(assets)
+
+
+main()
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Décodeur hôte des journaux binaires de télémétrie (/logs/log_N.bin).
+
+Le format est décrit dans src/TelemetryFormat.h.
+
+Utilisation :
+    python3 scripts/decode_telemetry.py log_1.bin log_0.bin > trames.csv
+    python3 scripts/decode_telemetry.py --format json log_0.bin > trames.json
+"""
+import argparse
+import csv
+import json
+import struct
+import sys
+from datetime import datetime
+
+MAGIC = b"HLT1"
+FILE_HEADER_SIZE = 16
+RECORD_HEADER_SIZE = 8
+
+RECORD_FRAME = 1
+RECORD_LABEL_DEF = 2
+RECORD_MESSAGE = 3
+RECORD_BATCH = 4
+
+BATCH_FLAG_REPLAY = 0x01
+
+LEVELS = {1: "INFO", 2: "DEBUG", 3: "ERROR"}
+
+
+def read_varint(data, pos):
+    """Lit un entier varint, retourne (valeur, nouvelle position)"""
+    value = 0
+    shift = 0
+    while pos < len(data):
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+    raise ValueError("varint tronqué")
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def format_time(epoch, millis_base, timestamp):
+    """Heure réelle si l'horloge était réglée, millisecondes sinon"""
+    if epoch < 1000000000:
+        return str(timestamp)
+    seconds = epoch + ((timestamp - millis_base) & 0xFFFFFFFF) / 1000.0
+    return datetime.fromtimestamp(seconds).strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
+
+
+def decode_frame(payload, dictionary):
+    """Décode une charge utile FRAME"""
+    (confidence,) = struct.unpack_from("<f", payload, 0)
+    pos = 4
+    objects, pos = read_varint(payload, pos)
+    count, pos = read_varint(payload, pos)
+
+    points = []
+    x = y = 0
+    for _ in range(count):
+        dx, pos = read_varint(payload, pos)
+        dy, pos = read_varint(payload, pos)
+        x += unzigzag(dx)
+        y += unzigzag(dy)
+        points.append((x, y))
+
+    labels = []
+    count, pos = read_varint(payload, pos)
+    for _ in range(count):
+        label_id, pos = read_varint(payload, pos)
+        if label_id == 0:
+            length, pos = read_varint(payload, pos)
+            labels.append(payload[pos:pos + length].decode("utf-8", "replace"))
+            pos += length
+        else:
+            labels.append(dictionary.get(label_id, "#%d" % label_id))
+
+    return {
+        "objects": objects,
+        "confidence": round(confidence, 3),
+        "points": points,
+        "labels": labels,
+    }
+
+
+def decode_file(path, dictionary):
+    """Générateur des enregistrements d'un fichier (trames et messages)"""
+    with open(path, "rb") as f:
+        data = f.read()
+    yield from decode_bytes(data, dictionary, path)
+
+
+def decode_bytes(data, dictionary, name="<paquet>"):
+    """Générateur des enregistrements d'un flux HLT1 (fichier ou paquet d'export)"""
+    if len(data) < FILE_HEADER_SIZE or data[:4] != MAGIC:
+        print(f"{name}: en-tête invalide, ignoré", file=sys.stderr)
+        return
+
+    epoch, millis_base = struct.unpack_from("<II", data, 8)
+    pos = FILE_HEADER_SIZE
+    batch = None
+
+    while pos + RECORD_HEADER_SIZE <= len(data):
+        rtype, level, length, timestamp = struct.unpack_from("<BBHI", data, pos)
+        pos += RECORD_HEADER_SIZE
+        payload = data[pos:pos + length]
+        if len(payload) < length:
+            print(f"{name}: enregistrement tronqué en fin de données", file=sys.stderr)
+            break
+        pos += length
+
+        if rtype == RECORD_LABEL_DEF:
+            label_id, start = read_varint(payload, 0)
+            dictionary[label_id] = payload[start:].decode("utf-8", "replace")
+            continue
+
+        if rtype == RECORD_BATCH:
+            unit, sequence, flags, dropped = struct.unpack_from("<IIBI", payload, 0)
+            batch = {
+                "unit": "%08x" % unit,
+                "batch": sequence,
+                "replay": bool(flags & BATCH_FLAG_REPLAY),
+                "dropped": dropped,
+            }
+            continue
+
+        record = {
+            "timestamp": timestamp,
+            "time": format_time(epoch, millis_base, timestamp),
+            "level": LEVELS.get(level, str(level)),
+        }
+        if rtype == RECORD_FRAME:
+            record.update(decode_frame(payload, dictionary))
+        elif rtype == RECORD_MESSAGE:
+            record["message"] = payload.decode("utf-8", "replace")
+        else:
+            continue
+        if batch:
+            record.update(batch)
+        yield record
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Décode les journaux binaires HuskyLens")
+    parser.add_argument("files", nargs="+", help="fichiers .bin, du plus ancien au plus récent")
+    parser.add_argument("--format", choices=["csv", "json"], default="csv")
+    args = parser.parse_args()
+
+    dictionary = {}
+    records = [r for path in args.files for r in decode_file(path, dictionary)]
+
+    if args.format == "json":
+        json.dump(records, sys.stdout, ensure_ascii=False, indent=1)
+        print()
+        return
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["Timestamp", "Level", "Objects", "Confidence", "Points", "Labels"])
+    for r in records:
+        if "message" in r:
+            writer.writerow([r["time"], r["level"], "", "", "", r["message"]])
+        else:
+            points = " ".join("%d:%d" % p for p in r["points"])
+            writer.writerow([r["time"], r["level"], r["objects"], r["confidence"],
+                             points, "|".join(r["labels"])])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,124 @@
+#pragma once
+
+// Substitut hôte minimal d'Arduino.h pour les bancs de scripts/ : String
+// et horloge. String alloue toujours sur le tas (pas de tampon interne),
+// par new[] pour passer par les crochets de HeapProfiler : toute copie est
+// comptée, comme sur la carte au-delà de quelques octets.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+class String {
+public:
+    String() { assign("", 0); }
+    String(const char* text) { assign(text ? text : "", text ? strlen(text) : 0); }
+    String(const String& other) { assign(other.c_str(), other.m_length); }
+    String(String&& other) noexcept : m_data(other.m_data), m_length(other.m_length), m_capacity(other.m_capacity) {
+        other.m_data = nullptr;
+        other.m_length = other.m_capacity = 0;
+    }
+    String(char c) { assign(&c, 1); }
+    String(int value) { format("%d", value); }
+    String(unsigned int value) { format("%u", value); }
+    String(long value) { format("%ld", value); }
+    String(unsigned long value) { format("%lu", value); }
+    String(float value, unsigned int decimals = 2) { format("%.*f", decimals, (double)value); }
+    String(double value, unsigned int decimals = 2) { format("%.*f", decimals, value); }
+    ~String() { delete[] m_data; }
+    
+    String& operator=(const String& other) {
+        if (this != &other) assign(other.c_str(), other.m_length);
+        return *this;
+    }
+    String& operator=(String&& other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_length, other.m_length);
+        std::swap(m_capacity, other.m_capacity);
+        return *this;
+    }
+    String& operator=(const char* text) { return *this = String(text); }
+    
+    const char* c_str() const { return m_data ? m_data : ""; }
+    unsigned int length() const { return m_length; }
+    char operator[](unsigned int index) const { return index < m_length ? m_data[index] : 0; }
+    
+    bool reserve(unsigned int size) {
+        if (size <= m_capacity && m_data) return true;
+        char* data = new char[size + 1];
+        memcpy(data, c_str(), m_length + 1);
+        delete[] m_data;
+        m_data = data;
+        m_capacity = size;
+        return true;
+    }
+    
+    bool concat(const char* text, unsigned int length) {
+        if (!reserve(m_length + length)) return false;
+        memcpy(m_data + m_length, text, length);
+        m_length += length;
+        m_data[m_length] = 0;
+        return true;
+    }
+    String& operator+=(const String& other) { concat(other.c_str(), other.m_length); return *this; }
+    String& operator+=(const char* text) { concat(text, strlen(text)); return *this; }
+    String& operator+=(char c) { concat(&c, 1); return *this; }
+    
+    int indexOf(char c, unsigned int from = 0) const {
+        const char* found = from < m_length ? strchr(c_str() + from, c) : nullptr;
+        return found ? found - c_str() : -1;
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        String result;
+        if (to > m_length) to = m_length;
+        if (from < to) result.concat(c_str() + from, to - from);
+        return result;
+    }
+    String substring(unsigned int from) const { return substring(from, m_length); }
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    
+    bool operator==(const String& other) const { return strcmp(c_str(), other.c_str()) == 0; }
+    bool operator!=(const String& other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return strcmp(c_str(), other.c_str()) < 0; }
+
+private:
+    char* m_data = nullptr;
+    unsigned int m_length = 0;
+    unsigned int m_capacity = 0;
+    
+    void assign(const char* text, unsigned int length) {
+        m_length = 0;
+        concat(text, length);
+    }
+    
+    template<typename T>
+    void format(const char* pattern, T value) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), pattern, value);
+        assign(buffer, strlen(buffer));
+    }
+    
+    void format(const char* pattern, unsigned int decimals, double value) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), pattern, decimals, value);
+        assign(buffer, strlen(buffer));
+    }
+};
+
+inline String operator+(String left, const String& right) { return left += right; }
+inline String operator+(String left, const char* right) { return left += right; }
+inline String operator+(const char* left, const String& right) { return String(left) += right; }
+
+inline unsigned long micros() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+inline unsigned long millis() {
+    return micros() / 1000;
+}
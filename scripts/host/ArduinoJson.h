@@ -0,0 +1,8 @@
+#pragma once
+
+// Substitut hôte : le banc n'utilise pas la sérialisation des règles
+struct JsonObject {};
+struct JsonVariant {};
+struct DynamicJsonDocument {
+    explicit DynamicJsonDocument(size_t) {}
+};
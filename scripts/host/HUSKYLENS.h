@@ -0,0 +1,3 @@
+#pragma once
+
+// Substitut hôte : Config.h n'utilise rien du pilote HUSKYLENS
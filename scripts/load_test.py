@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Charge l'API d'une unité et mesure la réponse de RequestScheduler.
+
+Plusieurs clients simulés envoient en boucle des requêtes légères et
+lourdes ; on compte les codes (200, 429, 503) et les latences. Le débit
+de trames de la boucle de vision est relevé avant et pendant la charge
+sur /api/stream (fps), puis l'état du répartiteur sur /api/scheduler.
+
+Utilisation :
+    python3 scripts/load_test.py 192.168.4.1 --clients 8 --duration 20
+"""
+import argparse
+import json
+import threading
+import time
+import urllib.error
+import urllib.request
+from collections import Counter
+
+LIGHT = [("GET", "/api/wifi/status"), ("GET", "/api/performance/metrics")]
+HEAVY = [("POST", "/api/performance/optimize"), ("POST", "/api/performance/balance")]
+
+
+def call(base, method, path, timeout=10.0):
+    request = urllib.request.Request(base + path, method=method, data=b"" if method == "POST" else None)
+    start = time.monotonic()
+    try:
+        with urllib.request.urlopen(request, timeout=timeout) as response:
+            response.read()
+            status = response.status
+    except urllib.error.HTTPError as error:
+        status = error.code
+    except (urllib.error.URLError, OSError):
+        status = "erreur"
+    return status, (time.monotonic() - start) * 1000.0
+
+
+def get_json(base, path):
+    try:
+        with urllib.request.urlopen(base + path, timeout=5.0) as response:
+            return json.loads(response.read())
+    except (urllib.error.URLError, OSError, ValueError):
+        return {}
+
+
+def client(base, routes, deadline, results, lock):
+    i = 0
+    while time.monotonic() < deadline:
+        method, path = routes[i % len(routes)]
+        status, latency = call(base, method, path)
+        with lock:
+            results.append((path, status, latency))
+        i += 1
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100.0))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Test de charge de l'API HTTP")
+    parser.add_argument("host")
+    parser.add_argument("--clients", type=int, default=8)
+    parser.add_argument("--heavy", type=int, default=2, help="clients n'envoyant que des requêtes lourdes")
+    parser.add_argument("--duration", type=float, default=20.0)
+    args = parser.parse_args()
+
+    base = "http://" + args.host
+    fps_before = get_json(base, "/api/stream").get("fps")
+
+    results, lock = [], threading.Lock()
+    deadline = time.monotonic() + args.duration
+    threads = [threading.Thread(target=client,
+                                args=(base, HEAVY if i < args.heavy else LIGHT, deadline, results, lock))
+               for i in range(args.clients)]
+    for thread in threads:
+        thread.start()
+
+    time.sleep(args.duration / 2)
+    fps_during = get_json(base, "/api/stream").get("fps")
+    for thread in threads:
+        thread.join()
+
+    print("%-30s %6s %6s %6s %6s %9s %9s" % ("Route", "200", "429", "503", "autres", "p50 ms", "p99 ms"))
+    for path in sorted({r[0] for r in results}):
+        rows = [r for r in results if r[0] == path]
+        codes = Counter(r[1] for r in rows)
+        others = sum(n for code, n in codes.items() if code not in (200, 429, 503))
+        ok = [r[2] for r in rows if r[1] == 200]
+        print("%-30s %6d %6d %6d %6d %9.0f %9.0f" % (path, codes[200], codes[429], codes[503], others,
+                                                     percentile(ok, 50), percentile(ok, 99)))
+
+    print("\nfps avant : %s, pendant la charge : %s" % (fps_before, fps_during))
+    print("répartiteur :", json.dumps(get_json(base, "/api/scheduler")))
+
+
+if __name__ == "__main__":
+    main()
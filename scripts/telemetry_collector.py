@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Collecteur des paquets d'export de télémétrie (TelemetryPublisher).
+
+Chaque paquet est un flux HLT1 autonome (voir src/TelemetryFormat.h) :
+en-tête de fichier, enregistrement BATCH (unité, séquence), trames.
+Les trames sont écrites en JSON, une par ligne ; les trous de séquence
+par unité sont signalés sur stderr.
+
+Utilisation :
+    python3 scripts/telemetry_collector.py --udp 5005 > trames.jsonl
+    python3 scripts/telemetry_collector.py --mqtt localhost --topic huskylens/frames
+(le mode MQTT nécessite paho-mqtt, par exemple avec un broker mosquitto local)
+"""
+import argparse
+import json
+import socket
+import sys
+
+from decode_telemetry import decode_bytes
+
+
+class Collector:
+    def __init__(self):
+        self.last_sequence = {}
+
+    def handle(self, data):
+        records = list(decode_bytes(data, {}))
+        if not records:
+            return
+
+        unit = records[0].get("unit")
+        sequence = records[0].get("batch")
+        if unit is not None and not records[0].get("replay"):
+            last = self.last_sequence.get(unit)
+            if last is not None and sequence > last + 1:
+                print(f"{unit}: {sequence - last - 1} paquet(s) manquant(s)", file=sys.stderr)
+            self.last_sequence[unit] = max(sequence, last or 0)
+
+        for record in records:
+            print(json.dumps(record, ensure_ascii=False))
+        sys.stdout.flush()
+
+
+def run_udp(port, collector):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("0.0.0.0", port))
+    print(f"Écoute UDP sur le port {port}", file=sys.stderr)
+    while True:
+        data, _ = sock.recvfrom(2048)
+        collector.handle(data)
+
+
+def run_mqtt(host, port, topic, collector):
+    import paho.mqtt.client as mqtt
+
+    client = mqtt.Client()
+    client.on_message = lambda _client, _userdata, message: collector.handle(message.payload)
+    client.connect(host, port)
+    client.subscribe(topic)
+    print(f"Abonné à {topic} sur {host}:{port}", file=sys.stderr)
+    client.loop_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Collecte les trames exportées par les unités HuskyLens")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--udp", type=int, metavar="PORT", help="écoute UDP")
+    source.add_argument("--mqtt", metavar="HÔTE", help="broker MQTT")
+    parser.add_argument("--mqtt-port", type=int, default=1883)
+    parser.add_argument("--topic", default="huskylens/frames")
+    args = parser.parse_args()
+
+    collector = Collector()
+    try:
+        if args.udp:
+            run_udp(args.udp, collector)
+        else:
+            run_mqtt(args.mqtt, args.mqtt_port, args.topic, collector)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
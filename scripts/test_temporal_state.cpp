@@ -0,0 +1,190 @@
+// Test des états temporels des règles sur l'hôte : SlidingWindow et
+// SequenceMatcher comparés à un recalcul exhaustif sur des trames
+// aléatoires (cadence irrégulière, trous plus longs que la fenêtre).
+//
+//   g++ -O2 -std=c++17 -Wall -Wextra -Isrc/automation scripts/test_temporal_state.cpp src/automation/TemporalState.cpp -o /tmp/test_temporal
+//   /tmp/test_temporal [trames]
+
+#include "TemporalState.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <utility>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("  ÉCHEC ligne %d : %s\n", __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+static const char* functionName(WindowSpec::Function function) {
+    switch (function) {
+        case WindowSpec::AVERAGE: return "avg";
+        case WindowSpec::MINIMUM: return "min";
+        case WindowSpec::MAXIMUM: return "max";
+    }
+    return "?";
+}
+
+// Intervalle entre trames : cadence nominale, parfois un trou
+static uint32_t nextInterval(std::mt19937& rng) {
+    if (rng() % 200 == 0) return 500 + rng() % 3000;
+    return SlidingWindow::MIN_FRAME_INTERVAL_MS + rng() % 40;
+}
+
+static void testWindow(WindowSpec spec, uint32_t frames, uint32_t seed) {
+    std::mt19937 rng(seed);
+    SlidingWindow window;
+    window.configure(spec);
+    size_t footprint = window.footprint();
+    
+    std::deque<std::pair<uint32_t, float>> reference;
+    uint32_t now = 1000;
+    uint32_t start = now;
+    uint32_t mismatches = 0;
+    
+    for (uint32_t i = 0; i < frames; i++) {
+        now += nextInterval(rng);
+        if (i == 0) start = now;
+        // Valeurs répétées fréquentes : égalités dans la file monotone
+        float value = (rng() % 4 == 0) ? (rng() % 5) : (rng() % 1000) / 1000.0f;
+        
+        window.push(now, value);
+        reference.push_back({now, value});
+        if (spec.frames) {
+            while (reference.size() > spec.frames) reference.pop_front();
+        } else {
+            while (reference.size() > 1 && now - reference.front().first > spec.durationMs) {
+                reference.pop_front();
+            }
+        }
+        
+        double sum = 0.0;
+        float minimum = reference.front().second;
+        float maximum = minimum;
+        for (const auto& sample : reference) {
+            sum += sample.second;
+            if (sample.second < minimum) minimum = sample.second;
+            if (sample.second > maximum) maximum = sample.second;
+        }
+        float expected = spec.function == WindowSpec::AVERAGE ? sum / reference.size() :
+                         spec.function == WindowSpec::MINIMUM ? minimum : maximum;
+        bool ready = spec.frames ? reference.size() >= spec.frames : now - start >= spec.durationMs;
+        
+        if (window.size() != reference.size() || std::fabs(window.value() - expected) > 1e-4f ||
+            window.ready() != ready) {
+            if (mismatches++ == 0) {
+                printf("  trame %u : %zu/%zu échantillons, %f au lieu de %f\n", i, window.size(),
+                       reference.size(), window.value(), expected);
+            }
+        }
+    }
+    
+    printf("%s(%u %s) : %u écart(s)\n", functionName(spec.function),
+           spec.frames ? spec.frames : spec.durationMs, spec.frames ? "frames" : "ms", mismatches);
+    CHECK(mismatches == 0);
+    // Aucune allocation après configure()
+    CHECK(window.footprint() == footprint);
+}
+
+static void testWindows(uint32_t frames) {
+    const WindowSpec::Function functions[] = {WindowSpec::AVERAGE, WindowSpec::MINIMUM, WindowSpec::MAXIMUM};
+    const uint16_t frameCounts[] = {1, 7, SlidingWindow::MAX_SAMPLES};
+    const uint32_t durations[] = {20, 500, SlidingWindow::MAX_DURATION_MS};
+    uint32_t seed = 1;
+    
+    for (WindowSpec::Function function : functions) {
+        for (uint16_t count : frameCounts) {
+            WindowSpec spec = {};
+            spec.function = function;
+            spec.frames = count;
+            testWindow(spec, frames, seed++);
+        }
+        for (uint32_t duration : durations) {
+            WindowSpec spec = {};
+            spec.function = function;
+            spec.durationMs = duration;
+            testWindow(spec, frames, seed++);
+        }
+    }
+}
+
+// Référence : existe-t-il des trames j0 < j1 < ... < i, postérieures au
+// dernier déclenchement, où chaque étape est vraie, avec i - j0 <= délai ?
+static bool chainExists(const std::vector<std::vector<bool>>& results, const std::vector<uint32_t>& times,
+                        int step, int frame, int after, uint32_t deadlineStart) {
+    if (step < 0) return true;
+    for (int j = frame; j > after; j--) {
+        if (times[j] < deadlineStart) break;
+        if (results[j][step] && chainExists(results, times, step - 1, j - 1, after, deadlineStart)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void testSequence(uint8_t steps, uint32_t withinMs, uint32_t frames, uint32_t seed) {
+    std::mt19937 rng(seed);
+    SequenceMatcher matcher;
+    matcher.configure(steps, withinMs);
+    
+    std::vector<std::vector<bool>> results;
+    std::vector<uint32_t> times;
+    uint32_t now = 1000;
+    int lastFire = -1;
+    uint32_t fired = 0;
+    uint32_t mismatches = 0;
+    
+    for (uint32_t i = 0; i < frames; i++) {
+        now += nextInterval(rng);
+        bool stepResults[SequenceMatcher::MAX_STEPS] = {};
+        std::vector<bool> row(steps);
+        for (uint8_t k = 0; k < steps; k++) {
+            stepResults[k] = rng() % 4 == 0;
+            row[k] = stepResults[k];
+        }
+        results.push_back(row);
+        times.push_back(now);
+        
+        bool actual = matcher.advance(stepResults, now);
+        int frame = i;
+        bool expected = stepResults[steps - 1] &&
+                        chainExists(results, times, steps - 2, frame - 1, lastFire,
+                                    now > withinMs ? now - withinMs : 0);
+        if (expected) {
+            lastFire = frame;
+            fired++;
+        }
+        if (actual != expected && mismatches++ == 0) {
+            printf("  trame %u : %d au lieu de %d\n", i, actual, expected);
+        }
+    }
+    
+    printf("séquence %u étapes en %u ms : %u déclenchements, %u écart(s)\n", steps, withinMs, fired, mismatches);
+    CHECK(mismatches == 0);
+    CHECK(fired > 0);
+}
+
+static void testSequences(uint32_t frames) {
+    uint32_t seed = 100;
+    for (uint8_t steps = 1; steps <= SequenceMatcher::MAX_STEPS; steps++) {
+        testSequence(steps, 100, frames, seed++);
+        testSequence(steps, 1000, frames, seed++);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = argc > 1 ? atoi(argv[1]) : 20000;
+    
+    testWindows(frames);
+    testSequences(frames);
+    
+    printf(failures ? "%d échec(s)\n" : "ok\n", failures);
+    return failures ? 1 : 0;
+}
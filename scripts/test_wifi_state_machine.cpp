@@ -0,0 +1,182 @@
+// Test de la machine d'états Wi-Fi sur l'hôte, avec un pilote simulé :
+// délai de connexion, croissance et plafond du backoff, reconnexion après
+// perte de lien, bascule en point d'accès.
+//
+//   g++ -O2 -std=c++17 -Wall -Wextra -Isrc scripts/test_wifi_state_machine.cpp src/WiFiStateMachine.cpp -o /tmp/test_wifi
+//   /tmp/test_wifi
+
+#include "WiFiStateMachine.h"
+#include <cstdio>
+
+// Pilote simulé : compte les appels, la radio n'existe pas
+class FakeWiFiDriver : public WiFiDriver {
+public:
+    uint32_t connects = 0;
+    uint32_t disconnects = 0;
+    uint32_t apStarts = 0;
+    uint32_t apStops = 0;
+    
+    void beginConnect() override { connects++; }
+    void disconnect() override { disconnects++; }
+    void startAccessPoint() override { apStarts++; }
+    void stopAccessPoint() override { apStops++; }
+};
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("  ÉCHEC ligne %d : %s\n", __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+// Gigue déterministe : le délai tiré est dans [base, base * 1,25[
+static bool inBackoffRange(uint32_t delay, uint32_t base) {
+    return delay >= base && delay < base + base / 4 + 1;
+}
+
+static WiFiTiming testTiming() {
+    WiFiTiming timing;
+    timing.connectTimeoutMs = 10000;
+    timing.initialBackoffMs = 1000;
+    timing.maxBackoffMs = 8000;
+    timing.apFallbackAttempts = 100;
+    timing.jitterSeed = 42;
+    return timing;
+}
+
+static void testConnectTimeout() {
+    printf("délai de connexion\n");
+    FakeWiFiDriver driver;
+    WiFiStateMachine wifi(driver, testTiming());
+    
+    wifi.start(true, 0);
+    CHECK(wifi.getState() == WiFiLinkState::CONNECTING);
+    CHECK(driver.connects == 1);
+    
+    wifi.tick(9999);
+    CHECK(wifi.getState() == WiFiLinkState::CONNECTING);
+    
+    wifi.tick(10000);
+    CHECK(wifi.getState() == WiFiLinkState::BACKOFF);
+    CHECK(wifi.getFailedAttempts() == 1);
+    CHECK(driver.disconnects == 1);
+    CHECK(inBackoffRange(wifi.getRetryInMs(10000), 1000));
+}
+
+static void testBackoffGrowthAndCap() {
+    printf("croissance et plafond du backoff\n");
+    FakeWiFiDriver driver;
+    WiFiTiming timing = testTiming();
+    WiFiStateMachine wifi(driver, timing);
+    
+    uint32_t now = 0;
+    uint32_t expected = timing.initialBackoffMs;
+    wifi.start(true, now);
+    for (uint32_t attempt = 1; attempt <= 8; attempt++) {
+        now += timing.connectTimeoutMs;
+        wifi.tick(now);
+        CHECK(wifi.getState() == WiFiLinkState::BACKOFF);
+        CHECK(wifi.getFailedAttempts() == attempt);
+        
+        uint32_t delay = wifi.getRetryInMs(now);
+        printf("  tentative %u : %u ms\n", attempt, delay);
+        CHECK(inBackoffRange(delay, expected));
+        
+        // Pas de nouvelle tentative avant l'échéance
+        wifi.tick(now + delay - 1);
+        CHECK(wifi.getState() == WiFiLinkState::BACKOFF);
+        now += delay;
+        wifi.tick(now);
+        CHECK(wifi.getState() == WiFiLinkState::CONNECTING);
+        CHECK(driver.connects == attempt + 1);
+        
+        expected = expected * 2 > timing.maxBackoffMs ? timing.maxBackoffMs : expected * 2;
+    }
+}
+
+static void testReconnectAfterDisconnect() {
+    printf("reconnexion après perte de lien\n");
+    FakeWiFiDriver driver;
+    WiFiTiming timing = testTiming();
+    WiFiStateMachine wifi(driver, timing);
+    
+    wifi.start(true, 0);
+    wifi.tick(10000);
+    wifi.tick(20000);
+    wifi.handleEvent(WiFiLinkEvent::GOT_IP, 20500);
+    CHECK(wifi.isConnected());
+    CHECK(wifi.getFailedAttempts() == 0);
+    CHECK(wifi.getReconnects() == 0);
+    
+    // Perte de lien : première relance au délai initial
+    wifi.handleEvent(WiFiLinkEvent::DISCONNECTED, 30000);
+    CHECK(wifi.getState() == WiFiLinkState::BACKOFF);
+    uint32_t delay = wifi.getRetryInMs(30000);
+    CHECK(inBackoffRange(delay, timing.initialBackoffMs));
+    
+    wifi.tick(30000 + delay);
+    CHECK(wifi.getState() == WiFiLinkState::CONNECTING);
+    wifi.handleEvent(WiFiLinkEvent::GOT_IP, 30000 + delay + 200);
+    CHECK(wifi.isConnected());
+    CHECK(wifi.getReconnects() == 1);
+    
+    // GOT_IP hors tentative : ignoré
+    wifi.handleEvent(WiFiLinkEvent::GOT_IP, 40000);
+    CHECK(wifi.getReconnects() == 1);
+}
+
+static void testAccessPointFallback() {
+    printf("bascule en point d'accès\n");
+    FakeWiFiDriver driver;
+    WiFiTiming timing = testTiming();
+    timing.apFallbackAttempts = 3;
+    WiFiStateMachine wifi(driver, timing);
+    
+    // Échecs signalés par le pilote (DISCONNECTED pendant la tentative)
+    uint32_t now = 0;
+    wifi.start(true, now);
+    for (uint32_t attempt = 1; attempt <= 5; attempt++) {
+        now += 500;
+        wifi.handleEvent(WiFiLinkEvent::DISCONNECTED, now);
+        CHECK(wifi.getFailedAttempts() == attempt);
+        CHECK(wifi.isAccessPointActive() == (attempt >= timing.apFallbackAttempts));
+        now += wifi.getRetryInMs(now);
+        wifi.tick(now);
+        CHECK(wifi.getState() == WiFiLinkState::CONNECTING);
+    }
+    CHECK(driver.apStarts == 1);
+    CHECK(driver.apStops == 0);
+    
+    // Connexion rétablie : le point d'accès est refermé
+    wifi.handleEvent(WiFiLinkEvent::GOT_IP, now + 100);
+    CHECK(wifi.isConnected());
+    CHECK(!wifi.isAccessPointActive());
+    CHECK(driver.apStops == 1);
+    
+    // Sans identifiants : point d'accès seul, aucune tentative
+    FakeWiFiDriver idle;
+    WiFiStateMachine unconfigured(idle, timing);
+    unconfigured.start(false, 0);
+    unconfigured.tick(60000);
+    CHECK(unconfigured.getState() == WiFiLinkState::AP_ONLY);
+    CHECK(unconfigured.isAccessPointActive());
+    CHECK(idle.connects == 0);
+    CHECK(idle.apStarts == 1);
+    
+    unconfigured.stop();
+    CHECK(unconfigured.getState() == WiFiLinkState::IDLE);
+    CHECK(idle.apStops == 1);
+}
+
+int main() {
+    testConnectTimeout();
+    testBackoffGrowthAndCap();
+    testReconnectAfterDisconnect();
+    testAccessPointFallback();
+    
+    printf(failures ? "%d échec(s)\n" : "ok\n", failures);
+    return failures ? 1 : 0;
+}
@@ -1,7 +1,8 @@
 #include "AutomationSystem.h"
+#include "automation/RuleParser.h"
 #include <SPIFFS.h>
 
-AutomationSystem::AutomationSystem() : defaultCooldown(1000) {}
+AutomationSystem::AutomationSystem() : defaultCooldown(1000), compiled(false) {}
 
 bool AutomationSystem::begin() {
     return SPIFFS.begin(true);
@@ -10,24 +11,29 @@ bool AutomationSystem::begin() {
 void AutomationSystem::update(const SensorData& data) {
     unsigned long now = millis();
     
-    for (auto& rule : rules) {
-        if (!rule.second.enabled) continue;
+    if (!compiled) {
+        program.compile(rules);
+        compiled = true;
+    }
+    
+    // Seules les règles dont les conditions sont vraies sont rendues
+    for (uint16_t index : program.evaluate(data, now)) {
+        Rule& rule = program.rule(index);
+        if (!rule.enabled) continue;
         
         // Vérifier le cooldown
-        if (now - rule.second.lastTriggered < rule.second.cooldown) {
+        if (now - rule.lastTriggered < rule.cooldown) {
             continue;
         }
         
-        // Évaluer les conditions
-        if (evaluateConditions(rule.second, data)) {
-            executeActions(rule.second, data);
-            rule.second.lastTriggered = now;
-            updateTriggerCount(rule.first);
-            
-            // Désactiver la règle si oneShot
-            if (rule.second.oneShot) {
-                rule.second.enabled = false;
-            }
+        executeActions(rule, data);
+        rule.lastTriggered = now;
+        updateTriggerCount(rule.name);
+        
+        // Désactiver la règle si oneShot
+        if (rule.oneShot) {
+            rule.enabled = false;
+            program.disable(index);
         }
     }
 }
@@ -40,82 +46,75 @@ void AutomationSystem::addRule(const Rule& rule) {
     } else {
         rules[rule.name] = rule;
     }
+    compiled = false;
 }
 
 void AutomationSystem::removeRule(const String& name) {
     rules.erase(name);
+    compiled = false;
 }
 
 void AutomationSystem::enableRule(const String& name, bool enable) {
     auto it = rules.find(name);
     if (it != rules.end()) {
         it->second.enabled = enable;
+        compiled = false;
     }
 }
 
 void AutomationSystem::clearRules() {
     rules.clear();
     triggerCounts.clear();
+    compiled = false;
 }
 
-std::function<bool(const SensorData&)> AutomationSystem::objectDetected(const String& objectName) {
-    return [objectName](const SensorData& data) {
-        for (const auto& label : data.labels) {
-            if (label == objectName) return true;
-        }
-        return false;
-    };
+Condition AutomationSystem::objectDetected(const String& objectName) {
+    return Condition(TriggerType::OBJECT_DETECTED, {objectName});
 }
 
-std::function<bool(const SensorData&)> AutomationSystem::gestureDetected(const String& gestureName) {
-    return [gestureName](const SensorData& data) {
-        for (const auto& label : data.labels) {
-            if (label == gestureName) return true;
-        }
-        return false;
-    };
+Condition AutomationSystem::gestureDetected(const String& gestureName) {
+    return Condition(TriggerType::GESTURE_RECOGNIZED, {gestureName});
 }
 
-std::function<bool(const SensorData&)> AutomationSystem::positionInZone(const Point& center, float radius) {
-    return [center, radius](const SensorData& data) {
-        for (const auto& point : data.points) {
-            float dx = point.x - center.x;
-            float dy = point.y - center.y;
-            float distance = sqrt(dx*dx + dy*dy);
-            if (distance <= radius) return true;
-        }
-        return false;
-    };
+Condition AutomationSystem::positionInZone(const Point& center, float radius) {
+    return Condition(TriggerType::POSITION_REACHED,
+                     {String(center.x), String(center.y), String(radius)});
+}
+
+Condition AutomationSystem::objectCountAbove(int count) {
+    return Condition(TriggerType::OBJECT_COUNT, {String(count)});
+}
+
+Condition AutomationSystem::confidenceAbove(float threshold) {
+    return Condition(TriggerType::CONFIDENCE_LEVEL, {String(threshold)});
+}
+
+Condition AutomationSystem::when(const String& expression) {
+    return Condition(TriggerType::EXPRESSION, {expression});
 }
 
-std::function<bool(const SensorData&)> AutomationSystem::objectCountAbove(int count) {
-    return [count](const SensorData& data) {
-        return data.objectCount > count;
-    };
+bool AutomationSystem::validateExpression(const String& expression, String& error) {
+    return RuleParser::validate(expression, error);
 }
 
-std::function<bool(const SensorData&)> AutomationSystem::confidenceAbove(float threshold) {
-    return [threshold](const SensorData& data) {
-        return data.confidence > threshold;
-    };
+Action AutomationSystem::changeMode(HuskyMode mode) {
+    return Action(ActionType::CHANGE_MODE, {String(static_cast<int>(mode))});
 }
 
-std::function<void(const SensorData&)> AutomationSystem::changeMode(HuskyMode mode) {
-    return [mode](const SensorData&) {
-        // TODO: Implémenter le changement de mode
-    };
+Action AutomationSystem::captureImage(const String& filename) {
+    return Action(ActionType::CAPTURE_IMAGE, {filename});
 }
 
-std::function<void(const SensorData&)> AutomationSystem::captureImage(const String& filename) {
-    return [filename](const SensorData&) {
-        // TODO: Implémenter la capture d'image
-    };
+Action AutomationSystem::sendNotification(const String& message) {
+    return Action(ActionType::SEND_NOTIFICATION, {message});
 }
 
-std::function<void(const SensorData&)> AutomationSystem::sendNotification(const String& message) {
-    return [message](const SensorData&) {
-        // TODO: Implémenter l'envoi de notification
-    };
+void AutomationSystem::registerAction(ActionType type, ActionHandler handler) {
+    actionHandlers[type] = handler;
+}
+
+void AutomationSystem::registerAction(const String& name, ActionHandler handler) {
+    customActions[name] = handler;
 }
 
 bool AutomationSystem::saveRules(const String& filename) {
@@ -140,6 +139,7 @@ bool AutomationSystem::loadRules(const String& filename) {
     
     DynamicJsonDocument doc(16384);
     DeserializationError error = deserializeJson(doc, file);
+    file.close();
     if (error) return false;
     
     rules.clear();
@@ -149,8 +149,7 @@ bool AutomationSystem::loadRules(const String& filename) {
         Rule rule = deserializeRule(ruleObj);
         rules[rule.name] = rule;
     }
-    
-    file.close();
+    compiled = false;
     return true;
 }
 
@@ -178,19 +177,29 @@ std::map<String, int> AutomationSystem::getTriggerCounts() const {
     return triggerCounts;
 }
 
-bool AutomationSystem::evaluateConditions(const Rule& rule, const SensorData& data) {
-    for (const auto& condition : rule.conditions) {
-        if (condition.evaluator && !condition.evaluator(data)) {
-            return false;
-        }
-    }
-    return true;
+RuleProgramStats AutomationSystem::getStats() const {
+    return program.getStats();
 }
 
 void AutomationSystem::executeActions(const Rule& rule, const SensorData& data) {
     for (const auto& action : rule.actions) {
         if (action.executor) {
             action.executor(data);
+            continue;
+        }
+        
+        // Liaison par le registre (actions rechargées depuis SPIFFS)
+        if (action.type == ActionType::CUSTOM_ACTION) {
+            if (action.parameters.empty()) continue;
+            auto it = customActions.find(action.parameters[0]);
+            if (it != customActions.end()) {
+                it->second(action.parameters, data);
+            }
+        } else {
+            auto it = actionHandlers.find(action.type);
+            if (it != actionHandlers.end()) {
+                it->second(action.parameters, data);
+            }
         }
     }
 }
@@ -214,7 +223,7 @@ DynamicJsonDocument AutomationSystem::serializeRule(const Rule& rule) {
     
     JsonArray actionsArray = doc.createNestedArray("actions");
     for (const auto& action : rule.actions) {
-        actionsArray.add(serializeAction(action));
+        serializeAction(action, actionsArray.createNestedObject());
     }
     
     return doc;
@@ -235,13 +244,18 @@ Rule AutomationSystem::deserializeRule(const JsonObject& obj) {
     
     JsonArray actionsArray = obj["actions"];
     for (JsonVariant v : actionsArray) {
-        rule.actions.push_back(deserializeAction(v.as<String>()));
+        rule.actions.push_back(deserializeAction(v));
     }
     
     return rule;
 }
 
 String AutomationSystem::serializeCondition(const Condition& condition) {
+    // Expression conservée telle quelle (virgules et deux-points permis)
+    if (condition.type == TriggerType::EXPRESSION) {
+        return condition.parameters.empty() ? String("") : condition.parameters[0];
+    }
+    
     String result = String(static_cast<int>(condition.type)) + ":";
     for (const auto& param : condition.parameters) {
         result += param + ",";
@@ -249,41 +263,46 @@ String AutomationSystem::serializeCondition(const Condition& condition) {
     return result;
 }
 
-String AutomationSystem::serializeAction(const Action& action) {
-    String result = String(static_cast<int>(action.type)) + ":";
+void AutomationSystem::serializeAction(const Action& action, JsonObject obj) {
+    obj["type"] = static_cast<int>(action.type);
+    JsonArray params = obj.createNestedArray("params");
     for (const auto& param : action.parameters) {
-        result += param + ",";
+        params.add(param);
     }
-    return result;
 }
 
 Condition AutomationSystem::deserializeCondition(const String& str) {
+    // Ancien format « type:param,param, » ; une expression ne commence pas par un chiffre
     int separatorPos = str.indexOf(':');
-    if (separatorPos < 0) return Condition(TriggerType::OBJECT_DETECTED);
-    
-    TriggerType type = static_cast<TriggerType>(str.substring(0, separatorPos).toInt());
-    std::vector<String> params;
-    
-    String paramsStr = str.substring(separatorPos + 1);
-    int startPos = 0;
-    while (true) {
-        int commaPos = paramsStr.indexOf(',', startPos);
-        if (commaPos < 0) break;
-        params.push_back(paramsStr.substring(startPos, commaPos));
-        startPos = commaPos + 1;
+    if (separatorPos <= 0 || !isdigit((unsigned char)str[0])) {
+        return Condition(TriggerType::EXPRESSION, {str});
     }
     
-    return Condition(type, params);
+    TriggerType type = static_cast<TriggerType>(str.substring(0, separatorPos).toInt());
+    return Condition(type, splitParameters(str.substring(separatorPos + 1)));
 }
 
-Action AutomationSystem::deserializeAction(const String& str) {
+Action AutomationSystem::deserializeAction(JsonVariant value) {
+    if (value.is<JsonObject>()) {
+        ActionType type = static_cast<ActionType>(value["type"] | 0);
+        std::vector<String> params;
+        for (JsonVariant param : value["params"].as<JsonArray>()) {
+            params.push_back(param.as<String>());
+        }
+        return Action(type, params);
+    }
+    
+    // Ancien format « type:param,param, »
+    String str = value.as<String>();
     int separatorPos = str.indexOf(':');
     if (separatorPos < 0) return Action(ActionType::CHANGE_MODE);
     
     ActionType type = static_cast<ActionType>(str.substring(0, separatorPos).toInt());
+    return Action(type, splitParameters(str.substring(separatorPos + 1)));
+}
+
+std::vector<String> AutomationSystem::splitParameters(const String& paramsStr) {
     std::vector<String> params;
-    
-    String paramsStr = str.substring(separatorPos + 1);
     int startPos = 0;
     while (true) {
         int commaPos = paramsStr.indexOf(',', startPos);
@@ -291,6 +310,5 @@ Action AutomationSystem::deserializeAction(const String& str) {
         params.push_back(paramsStr.substring(startPos, commaPos));
         startPos = commaPos + 1;
     }
-    
-    return Action(type, params);
+    return params;
 }
\ No newline at end of file
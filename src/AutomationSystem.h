@@ -4,6 +4,7 @@
 #include <functional>
 #include <map>
 #include "Config.h"
+#include "automation/RuleProgram.h"
 #include <ArduinoJson.h>
 
 enum class TriggerType {
@@ -14,7 +15,8 @@ enum class TriggerType {
     DISTANCE_THRESHOLD,
     OBJECT_COUNT,
     CONFIDENCE_LEVEL,
-    CUSTOM_EVENT
+    CUSTOM_EVENT,
+    EXPRESSION          // parameters[0] : texte du langage de conditions (RuleParser.h)
 };
 
 enum class ActionType {
@@ -46,6 +48,10 @@ struct Action {
         : type(t), parameters(params) {}
 };
 
+// Action sans executor : liée par son type (ou son nom, CUSTOM_ACTION) aux
+// gestionnaires enregistrés, ce qui la rend persistante
+using ActionHandler = std::function<void(const std::vector<String>& parameters, const SensorData& data)>;
+
 struct Rule {
     String name;
     String description;
@@ -71,17 +77,24 @@ public:
     void enableRule(const String& name, bool enable);
     void clearRules();
     
-    // Prédicats communs
-    static std::function<bool(const SensorData&)> objectDetected(const String& objectName);
-    static std::function<bool(const SensorData&)> gestureDetected(const String& gestureName);
-    static std::function<bool(const SensorData&)> positionInZone(const Point& center, float radius);
-    static std::function<bool(const SensorData&)> objectCountAbove(int count);
-    static std::function<bool(const SensorData&)> confidenceAbove(float threshold);
+    // Prédicats communs : conditions typées, compilées par RuleProgram
+    static Condition objectDetected(const String& objectName);
+    static Condition gestureDetected(const String& gestureName);
+    static Condition positionInZone(const Point& center, float radius);
+    static Condition objectCountAbove(int count);
+    static Condition confidenceAbove(float threshold);
+    // Ex. : when("count > 2 and object chat for 500 ms")
+    static Condition when(const String& expression);
+    static bool validateExpression(const String& expression, String& error);
+    
+    // Actions communes : exécutées par les gestionnaires enregistrés
+    static Action changeMode(HuskyMode mode);
+    static Action captureImage(const String& filename);
+    static Action sendNotification(const String& message);
     
-    // Actions communes
-    static std::function<void(const SensorData&)> changeMode(HuskyMode mode);
-    static std::function<void(const SensorData&)> captureImage(const String& filename);
-    static std::function<void(const SensorData&)> sendNotification(const String& message);
+    void registerAction(ActionType type, ActionHandler handler);
+    // CUSTOM_ACTION dont parameters[0] vaut name
+    void registerAction(const String& name, ActionHandler handler);
     
     // Configuration
     bool saveRules(const String& filename);
@@ -92,13 +105,19 @@ public:
     std::vector<String> getRuleNames() const;
     const Rule* getRule(const String& name) const;
     std::map<String, int> getTriggerCounts() const;
+    RuleProgramStats getStats() const;
+    // Dernière règle ignorée à la compilation et pourquoi
+    const String& getLastError() const { return program.getLastError(); }
     
 private:
     std::map<String, Rule> rules;
     std::map<String, int> triggerCounts;
+    std::map<ActionType, ActionHandler> actionHandlers;
+    std::map<String, ActionHandler> customActions;
     unsigned long defaultCooldown;
+    RuleProgram program;
+    bool compiled;              // false : règles modifiées depuis la compilation
     
-    bool evaluateConditions(const Rule& rule, const SensorData& data);
     void executeActions(const Rule& rule, const SensorData& data);
     void updateTriggerCount(const String& ruleName);
     
@@ -106,7 +125,8 @@ private:
     DynamicJsonDocument serializeRule(const Rule& rule);
     Rule deserializeRule(const JsonObject& obj);
     String serializeCondition(const Condition& condition);
-    String serializeAction(const Action& action);
+    void serializeAction(const Action& action, JsonObject obj);
     Condition deserializeCondition(const String& str);
-    Action deserializeAction(const String& str);
+    Action deserializeAction(JsonVariant value);
+    static std::vector<String> splitParameters(const String& paramsStr);
 };
\ No newline at end of file
@@ -75,14 +75,70 @@ struct SensorData {
     {}
 };
 
+// Étiquettes d'affichage typées : le texte n'est formaté qu'au dessin
+// (DisplayManager::formatLabel), jamais dans la boucle de traitement
+enum class DisplayDirection : uint8_t {
+    NONE,
+    RIGHT,
+    LEFT,
+    DOWN,
+    UP
+};
+
+enum class DisplayLabelKind : uint8_t {
+    NONE,
+    OBJECT_INDEX,    // "Obj <value>"
+    DISTANCE_CM,     // "<value> cm"
+    SPEED,           // "<value> px/s <direction>"
+    NEW_OBJECT,      // "Nouvel objet"
+    GESTURE          // "<direction> Droite/Gauche/Bas/Haut"
+};
+
+struct DisplayLabel {
+    DisplayLabelKind kind;
+    DisplayDirection direction;
+    float value;
+    
+    DisplayLabel(DisplayLabelKind k = DisplayLabelKind::NONE, float v = 0.0f,
+                 DisplayDirection d = DisplayDirection::NONE) :
+        kind(k), direction(d), value(v) {}
+    
+    bool operator==(const DisplayLabel& other) const {
+        return kind == other.kind && direction == other.direction && value == other.value;
+    }
+    bool operator!=(const DisplayLabel& other) const { return !(*this == other); }
+};
+
+// Barre d'état : "Objets: <objectCount> | Tend.: <trend>"
+struct DisplayStatus {
+    uint16_t objectCount;
+    DisplayDirection trend;
+    
+    DisplayStatus() : objectCount(0), trend(DisplayDirection::RIGHT) {}
+    
+    bool operator==(const DisplayStatus& other) const {
+        return objectCount == other.objectCount && trend == other.trend;
+    }
+    bool operator!=(const DisplayStatus& other) const { return !(*this == other); }
+};
+
 struct DisplayData {
     std::vector<Point> points;
-    std::vector<String> labels;
+    std::vector<DisplayLabel> labels;
     std::vector<float> confidences;
-    String statusMessage;
+    DisplayStatus status;
     bool needsUpdate;
     
     DisplayData() : needsUpdate(false) {}
+    
+    // Vide le contenu en gardant la capacité des vecteurs
+    void clear() {
+        points.clear();
+        labels.clear();
+        confidences.clear();
+        status = DisplayStatus();
+        needsUpdate = false;
+    }
 };
 
 // Énumérations
@@ -125,7 +181,7 @@ namespace Constants {
     const int MAX_QR_DATA_LENGTH = 256;
     const int MAX_QR_LOG_ENTRIES = 1000;
     const int QR_MIN_CONFIDENCE = 75;
-    const String QR_LOG_FILE = "/qr_log.txt";
+    const String QR_LOG_FILE = "/qr_log.bin";
     
     // Model management constants
     const int MAX_SAVED_MODELS = 20;
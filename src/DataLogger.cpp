@@ -1,56 +1,83 @@
 #include "DataLogger.h"
+#include "performance/Trace.h"
 #include <time.h>
+#include <esp_heap_caps.h>
 
-DataLogger::DataLogger() : initialized(false), logLevel(1) {}
+DataLogger::DataLogger() :
+    initialized(false),
+    logLevel(1),
+    fileSize(0),
+    flushBlock(nullptr),
+    flushTaskHandle(nullptr),
+    fileMutex(nullptr),
+    labelMutex(nullptr),
+    bytesWritten(0),
+    blocksWritten(0),
+    rotations(0) {}
 
 bool DataLogger::begin() {
     if (!SD.begin()) {
         return false;
     }
     
-    initialized = checkAndCreateDirectory();
+    if (!checkAndCreateDirectory() || !ring.allocate(RING_SIZE)) {
+        return false;
+    }
+    
+    // Bloc d'écriture en RAM interne (DMA SD)
+    flushBlock = static_cast<uint8_t*>(heap_caps_malloc(FLUSH_BLOCK_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    fileMutex = xSemaphoreCreateMutex();
+    labelMutex = xSemaphoreCreateMutex();
+    if (!flushBlock || !fileMutex || !labelMutex || !openCurrentLog(FILE_APPEND)) {
+        return false;
+    }
+    
+    // Tâche de vidage basse priorité sur le core 0 (loop() tourne sur le core 1)
+    if (xTaskCreatePinnedToCore(flushTask, "log_flush", 4096, this, 1,
+                                &flushTaskHandle, 0) != pdPASS) {
+        return false;
+    }
+    
+    initialized = true;
     return initialized;
 }
 
 void DataLogger::log(const SensorData& data) {
     if (!initialized || logLevel < 1) return;
     
-    String message = "Objects: " + String(data.objectCount);
-    message += ", Confidence: " + String(data.confidence);
-    message += ", Points: " + String(data.points.size());
+    using namespace TelemetryFormat;
+    uint8_t record[MAX_RECORD_SIZE];
+    Writer payload(record + RECORD_HEADER_SIZE, MAX_RECORD_SIZE - RECORD_HEADER_SIZE);
     
-    if (!data.labels.empty()) {
-        message += ", Labels: ";
-        for (const auto& label : data.labels) {
-            message += label + ",";
-        }
+    // Étiquettes par référence au dictionnaire, en ligne s'il est plein
+    if (!encodeFrame(payload, data, [this](const String& label) { return internLabel(label); })) {
+        return;
     }
     
-    writeToFile(formatLogMessage(message, "INFO"));
+    writeRecordHeader(record, RECORD_FRAME, LEVEL_INFO, payload.size(), data.timestamp);
+    writeToFile(record, RECORD_HEADER_SIZE + payload.size());
 }
 
 void DataLogger::logError(const String& error) {
     if (!initialized) return;
     
-    String message = formatLogMessage(error, "ERROR");
-    writeToFile(message);
+    writeMessage(TelemetryFormat::LEVEL_ERROR, error);
     
     if (logBuffer.size() >= MAX_BUFFER_SIZE) {
         logBuffer.pop_front();
     }
-    logBuffer.push_back(message);
+    logBuffer.push_back(formatLogMessage(error, "ERROR"));
 }
 
 void DataLogger::logDebug(const String& message) {
     if (!initialized || logLevel < 2) return;
     
-    String logMessage = formatLogMessage(message, "DEBUG");
-    writeToFile(logMessage);
+    writeMessage(TelemetryFormat::LEVEL_DEBUG, message);
     
     if (logBuffer.size() >= MAX_BUFFER_SIZE) {
         logBuffer.pop_front();
     }
-    logBuffer.push_back(logMessage);
+    logBuffer.push_back(formatLogMessage(message, "DEBUG"));
 }
 
 void DataLogger::setLogLevel(int level) {
@@ -71,6 +98,9 @@ std::vector<String> DataLogger::getLastLogs(int count) {
 void DataLogger::clearLogs() {
     if (!initialized) return;
     
+    xSemaphoreTake(fileMutex, portMAX_DELAY);
+    logFile.close();
+    
     File root = SD.open(LOG_DIRECTORY);
     File file = root.openNextFile();
     
@@ -81,37 +111,156 @@ void DataLogger::clearLogs() {
         file = root.openNextFile();
     }
     
+    openCurrentLog(FILE_WRITE);
+    xSemaphoreGive(fileMutex);
+    
     logBuffer.clear();
 }
 
 bool DataLogger::exportCSV(const String& filename) {
     if (!initialized) return false;
     
-    File file = SD.open(LOG_DIRECTORY + "/" + filename, FILE_WRITE);
-    if (!file) return false;
+    File out = SD.open(LOG_DIRECTORY + "/" + filename, FILE_WRITE);
+    if (!out) return false;
+    
+    out.println("Timestamp,Level,Objects,Confidence,Points,Labels");
     
-    file.println("Timestamp,Level,Message");
-    for (const auto& log : logBuffer) {
-        file.println(log);
+    // Décoder les journaux binaires du plus ancien au plus récent
+    flush();
+    xSemaphoreTake(fileMutex, portMAX_DELAY);
+    std::map<uint16_t, String> dictionary;
+    for (int i = MAX_LOG_FILES; i >= 0; i--) {
+        String name = LOG_DIRECTORY + "/log_" + String(i) + LOG_EXTENSION;
+        if (!SD.exists(name)) continue;
+        
+        File in = SD.open(name, FILE_READ);
+        if (in) {
+            exportFile(in, out, dictionary);
+            in.close();
+        }
     }
+    xSemaphoreGive(fileMutex);
     
-    file.close();
+    out.close();
     return true;
 }
 
+void DataLogger::exportFile(File& in, File& out, std::map<uint16_t, String>& dictionary) {
+    using namespace TelemetryFormat;
+    uint8_t header[FILE_HEADER_SIZE];
+    if (in.read(header, FILE_HEADER_SIZE) != FILE_HEADER_SIZE ||
+        memcmp(header, MAGIC, 4) != 0) {
+        return;
+    }
+    
+    // Heure réelle = epoch du fichier + (horodatage - millis de référence)
+    uint32_t epoch = readU32(header + 8);
+    uint32_t millisBase = readU32(header + 12);
+    uint8_t record[MAX_RECORD_SIZE];
+    
+    while (in.read(record, RECORD_HEADER_SIZE) == RECORD_HEADER_SIZE) {
+        uint8_t type = record[0];
+        uint8_t level = record[1];
+        uint16_t length = readU16(record + 2);
+        uint32_t timestamp = readU32(record + 4);
+        
+        if (length > MAX_RECORD_SIZE || in.read(record, length) != length) break;
+        
+        if (type == RECORD_LABEL_DEF) {
+            uint32_t id;
+            size_t n = readVarint(record, length, id);
+            if (n > 0) {
+                String label;
+                label.concat(reinterpret_cast<const char*>(record + n), length - n);
+                dictionary[id] = label;
+            }
+        } else if (type == RECORD_MESSAGE) {
+            String text;
+            text.concat(reinterpret_cast<const char*>(record), length);
+            out.println(formatTimestamp(epoch, millisBase, timestamp) + "," +
+                        (level == LEVEL_ERROR ? "ERROR" : "DEBUG") + ",,,,\"" + text + "\"");
+        } else if (type == RECORD_FRAME) {
+            out.println(formatTimestamp(epoch, millisBase, timestamp) + ",INFO," +
+                        decodeFrame(record, length, dictionary));
+        }
+    }
+}
+
+String DataLogger::decodeFrame(const uint8_t* data, size_t length,
+                               const std::map<uint16_t, String>& dictionary) {
+    using namespace TelemetryFormat;
+    if (length < 4) return "";
+    
+    float confidence;
+    uint32_t raw = readU32(data);
+    memcpy(&confidence, &raw, 4);
+    size_t pos = 4;
+    
+    uint32_t objects = 0, count = 0;
+    pos += readVarint(data + pos, length - pos, objects);
+    pos += readVarint(data + pos, length - pos, count);
+    
+    // Points "x:y" séparés par des espaces
+    String points;
+    int32_t x = 0, y = 0;
+    for (uint32_t i = 0; i < count && pos < length; i++) {
+        uint32_t dx = 0, dy = 0;
+        pos += readVarint(data + pos, length - pos, dx);
+        pos += readVarint(data + pos, length - pos, dy);
+        x += unzigzag(dx);
+        y += unzigzag(dy);
+        if (i > 0) points += " ";
+        points += String(x) + ":" + String(y);
+    }
+    
+    String labels;
+    pos += readVarint(data + pos, length - pos, count);
+    for (uint32_t i = 0; i < count && pos < length; i++) {
+        uint32_t id = 0;
+        pos += readVarint(data + pos, length - pos, id);
+        if (i > 0) labels += "|";
+        
+        if (id == 0) {
+            uint32_t textLength = 0;
+            pos += readVarint(data + pos, length - pos, textLength);
+            textLength = std::min<uint32_t>(textLength, length - pos);
+            labels.concat(reinterpret_cast<const char*>(data + pos), textLength);
+            pos += textLength;
+        } else {
+            auto it = dictionary.find(id);
+            labels += it != dictionary.end() ? it->second : "#" + String(id);
+        }
+    }
+    
+    return String(objects) + "," + String(confidence) + "," + points + ",\"" + labels + "\"";
+}
+
+String DataLogger::formatTimestamp(uint32_t epoch, uint32_t millisBase, uint32_t timestamp) {
+    // Sans horloge réglée, l'horodatage relatif en millisecondes est conservé
+    if (epoch < 1000000000UL) {
+        return String(timestamp);
+    }
+    
+    time_t now = epoch + (int32_t)(timestamp - millisBase) / 1000;
+    struct tm timeinfo;
+    char buffer[32];
+    localtime_r(&now, &timeinfo);
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    return String(buffer);
+}
+
 void DataLogger::rotateLogFiles() {
     if (!initialized) return;
     
-    const int MAX_LOG_FILES = 5;
     String baseFilename = LOG_DIRECTORY + "/log_";
     
     // Supprimer le plus ancien fichier
-    SD.remove(baseFilename + String(MAX_LOG_FILES) + ".txt");
+    SD.remove(baseFilename + String(MAX_LOG_FILES) + LOG_EXTENSION);
     
     // Rotation des fichiers
     for (int i = MAX_LOG_FILES - 1; i >= 0; i--) {
-        String oldName = baseFilename + String(i) + ".txt";
-        String newName = baseFilename + String(i + 1) + ".txt";
+        String oldName = baseFilename + String(i) + LOG_EXTENSION;
+        String newName = baseFilename + String(i + 1) + LOG_EXTENSION;
         if (SD.exists(oldName)) {
             SD.rename(oldName, newName);
         }
@@ -122,21 +271,158 @@ String DataLogger::formatLogMessage(const String& message, const String& level)
     return getCurrentDateTime() + "," + level + "," + message;
 }
 
-void DataLogger::writeToFile(const String& message) {
-    File file = SD.open(LOG_DIRECTORY + "/log_0.txt", FILE_APPEND);
-    if (file) {
-        file.println(message);
-        file.close();
+bool DataLogger::writeToFile(const uint8_t* record, size_t length) {
+    TRACE_SCOPE("DataLogger::writeToFile");
+    
+    // Chemin critique : une copie dans le tampon, jamais d'accès SD ici
+    bool queued = ring.push(record, length);
+    
+    if (ring.used() >= FLUSH_BLOCK_SIZE && flushTaskHandle) {
+        xTaskNotifyGive(flushTaskHandle);
+    }
+    return queued;
+}
+
+void DataLogger::writeMessage(uint8_t level, const String& message) {
+    using namespace TelemetryFormat;
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t length = std::min<size_t>(message.length(), MAX_RECORD_SIZE - RECORD_HEADER_SIZE);
+    
+    writeRecordHeader(record, RECORD_MESSAGE, level, length, millis());
+    memcpy(record + RECORD_HEADER_SIZE, message.c_str(), length);
+    writeToFile(record, RECORD_HEADER_SIZE + length);
+}
+
+uint16_t DataLogger::internLabel(const String& label) {
+    xSemaphoreTake(labelMutex, portMAX_DELAY);
+    auto it = labelIds.find(label);
+    if (it != labelIds.end()) {
+        uint16_t id = it->second;
+        xSemaphoreGive(labelMutex);
+        return id;
+    }
+    
+    // Dictionnaire plein : l'étiquette sera écrite en ligne
+    if (labelNames.size() >= MAX_LABELS ||
+        label.length() > TelemetryFormat::MAX_RECORD_SIZE / 2) {
+        xSemaphoreGive(labelMutex);
+        return 0;
+    }
+    
+    // La définition précède dans le flux la première trame qui l'utilise.
+    // L'identifiant n'est retenu qu'une fois la définition en file : tampon
+    // plein, l'étiquette part en ligne et sera réinternée au prochain usage
+    uint16_t id = labelNames.size() + 1;
+    uint8_t record[TelemetryFormat::MAX_RECORD_SIZE];
+    size_t length = encodeLabelDef(record, id, label);
+    if (!writeToFile(record, length)) {
+        xSemaphoreGive(labelMutex);
+        return 0;
+    }
+    
+    labelIds[label] = id;
+    labelNames.push_back(label);
+    xSemaphoreGive(labelMutex);
+    return id;
+}
+
+size_t DataLogger::encodeLabelDef(uint8_t* record, uint16_t id, const String& label) {
+    using namespace TelemetryFormat;
+    Writer payload(record + RECORD_HEADER_SIZE, MAX_RECORD_SIZE - RECORD_HEADER_SIZE);
+    payload.varint(id);
+    payload.bytes(label.c_str(), label.length());
+    
+    writeRecordHeader(record, RECORD_LABEL_DEF, 0, payload.size(), millis());
+    return RECORD_HEADER_SIZE + payload.size();
+}
+
+void DataLogger::writeFilePreamble() {
+    using namespace TelemetryFormat;
+    uint8_t header[FILE_HEADER_SIZE];
+    writeFileHeader(header, time(nullptr), millis());
+    logFile.write(header, FILE_HEADER_SIZE);
+    fileSize += FILE_HEADER_SIZE;
+    
+    // Chaque fichier embarque le dictionnaire courant pour rester autonome
+    xSemaphoreTake(labelMutex, portMAX_DELAY);
+    std::vector<String> names = labelNames;
+    xSemaphoreGive(labelMutex);
+    
+    uint8_t record[MAX_RECORD_SIZE];
+    for (size_t i = 0; i < names.size(); i++) {
+        size_t length = encodeLabelDef(record, i + 1, names[i]);
+        logFile.write(record, length);
+        fileSize += length;
+    }
+}
+
+void DataLogger::flush() {
+    if (!initialized) return;
+    drainRing();
+}
+
+LoggerStats DataLogger::getStats() const {
+    LoggerStats stats;
+    stats.droppedMessages = ring.droppedRecords();
+    stats.droppedBytes = ring.droppedBytes();
+    stats.bufferHighWatermark = ring.highWatermark();
+    stats.bufferUsed = ring.used();
+    stats.bytesWritten = bytesWritten;
+    stats.blocksWritten = blocksWritten;
+    stats.rotations = rotations;
+    stats.currentFileSize = fileSize;
+    return stats;
+}
+
+bool DataLogger::openCurrentLog(const char* mode) {
+    logFile = SD.open(LOG_DIRECTORY + "/log_0" + LOG_EXTENSION, mode);
+    fileSize = logFile ? logFile.size() : 0;
+    
+    if (logFile && fileSize == 0) {
+        writeFilePreamble();
+    }
+    return (bool)logFile;
+}
+
+void DataLogger::drainRing() {
+    TRACE_SCOPE("DataLogger::drainRing");
+    
+    // Consommateur unique : protégé par le mutex fichier
+    xSemaphoreTake(fileMutex, portMAX_DELAY);
+    
+    size_t length;
+    while ((length = ring.pop(flushBlock, FLUSH_BLOCK_SIZE)) > 0) {
+        if (!logFile) break;
+        
+        logFile.write(flushBlock, length);
+        fileSize += length;
+        bytesWritten += length;
+        blocksWritten++;
         
-        // Vérifier la taille du fichier et faire une rotation si nécessaire
-        file = SD.open(LOG_DIRECTORY + "/log_0.txt");
-        if (file.size() > 1024 * 1024) { // 1MB
-            file.close();
+        // Rotation sur la taille suivie en mémoire
+        if (fileSize > MAX_LOG_FILE_SIZE) {
+            logFile.close();
             rotateLogFiles();
-        } else {
-            file.close();
+            openCurrentLog(FILE_WRITE);
+            rotations++;
         }
     }
+    
+    if (logFile) {
+        logFile.flush();
+    }
+    
+    xSemaphoreGive(fileMutex);
+}
+
+void DataLogger::flushTask(void* parameter) {
+    DataLogger* logger = static_cast<DataLogger*>(parameter);
+    
+    while (true) {
+        // Réveil sur seuil de remplissage ou à intervalle fixe
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_INTERVAL_MS));
+        logger->drainRing();
+    }
 }
 
 bool DataLogger::checkAndCreateDirectory() {
@@ -1,9 +1,36 @@
 #pragma once
 
 #include <SD.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "Config.h"
+#include "LogRingBuffer.h"
+#include "TelemetryFormat.h"
 #include <vector>
 #include <deque>
+#include <map>
+
+// Statistiques de l'écriture asynchrone
+struct LoggerStats {
+    uint32_t droppedMessages;
+    uint32_t droppedBytes;
+    uint32_t bytesWritten;
+    uint32_t blocksWritten;
+    uint32_t rotations;
+    uint32_t bufferHighWatermark;
+    size_t bufferUsed;
+    size_t currentFileSize;
+    
+    LoggerStats() :
+        droppedMessages(0),
+        droppedBytes(0),
+        bytesWritten(0),
+        blocksWritten(0),
+        rotations(0),
+        bufferHighWatermark(0),
+        bufferUsed(0),
+        currentFileSize(0) {}
+};
 
 class DataLogger {
 public:
@@ -16,6 +43,8 @@ public:
     std::vector<String> getLastLogs(int count = 10);
     void clearLogs();
     bool exportCSV(const String& filename);
+    void flush();
+    LoggerStats getStats() const;
     
 private:
     bool initialized;
@@ -24,9 +53,43 @@ private:
     const size_t MAX_BUFFER_SIZE = 1000;
     const String LOG_DIRECTORY = "/logs";
     
+    // Écriture asynchrone : les producteurs remplissent le tampon circulaire,
+    // la tâche de vidage écrit des blocs sur un fichier gardé ouvert
+    static const size_t RING_SIZE = 32 * 1024;
+    static const size_t FLUSH_BLOCK_SIZE = 8 * 1024;
+    static const size_t MAX_LOG_FILE_SIZE = 1024 * 1024;
+    static const uint32_t FLUSH_INTERVAL_MS = 500;
+    static const int MAX_LOG_FILES = 5;
+    static const size_t MAX_LABELS = 256;
+    const String LOG_EXTENSION = ".bin";
+    
+    LogRingBuffer ring;
+    File logFile;
+    size_t fileSize;
+    uint8_t* flushBlock;
+    TaskHandle_t flushTaskHandle;
+    SemaphoreHandle_t fileMutex;
+    SemaphoreHandle_t labelMutex;
+    std::map<String, uint16_t> labelIds;
+    std::vector<String> labelNames;
+    uint32_t bytesWritten;
+    uint32_t blocksWritten;
+    uint32_t rotations;
+    
     void rotateLogFiles();
     String formatLogMessage(const String& message, const String& level);
-    void writeToFile(const String& message);
+    bool writeToFile(const uint8_t* record, size_t length);
+    void writeMessage(uint8_t level, const String& message);
+    uint16_t internLabel(const String& label);
+    size_t encodeLabelDef(uint8_t* record, uint16_t id, const String& label);
+    void writeFilePreamble();
+    void exportFile(File& in, File& out, std::map<uint16_t, String>& dictionary);
+    String decodeFrame(const uint8_t* data, size_t length,
+                       const std::map<uint16_t, String>& dictionary);
+    String formatTimestamp(uint32_t epoch, uint32_t millisBase, uint32_t timestamp);
     bool checkAndCreateDirectory();
     String getCurrentDateTime();
-};
\ No newline at end of file
+    bool openCurrentLog(const char* mode);
+    void drainRing();
+    static void flushTask(void* parameter);
+};
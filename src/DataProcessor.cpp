@@ -1,4 +1,5 @@
 #include "DataProcessor.h"
+#include "performance/Trace.h"
 #include <cmath>
 
 DataProcessor::DataProcessor() : currentMode(HuskyMode::FACE_RECOGNITION) {
@@ -10,7 +11,10 @@ void DataProcessor::begin() {
 }
 
 void DataProcessor::process(const SensorData& data) {
-    displayData = DisplayData();
+    TRACE_SCOPE("DataProcessor::process");
+    
+    // Vecteurs réutilisés d'une trame à l'autre : pas d'allocation en régime établi
+    displayData.clear();
     displayData.needsUpdate = true;
     displayData.points = data.points;
     
@@ -53,14 +57,14 @@ void DataProcessor::processGestureData(const SensorData& data) {
         int dx = gesturePoints.back().x - gesturePoints.front().x;
         int dy = gesturePoints.back().y - gesturePoints.front().y;
         
-        String gesture;
+        DisplayDirection gesture;
         if (abs(dx) > abs(dy)) {
-            gesture = dx > 0 ? "→ Droite" : "← Gauche";
+            gesture = dx > 0 ? DisplayDirection::RIGHT : DisplayDirection::LEFT;
         } else {
-            gesture = dy > 0 ? "↓ Bas" : "↑ Haut";
+            gesture = dy > 0 ? DisplayDirection::DOWN : DisplayDirection::UP;
         }
         
-        displayData.labels.push_back(gesture);
+        displayData.labels.push_back(DisplayLabel(DisplayLabelKind::GESTURE, 0.0f, gesture));
         displayData.confidences.push_back(100.0f);
         gesturePoints.clear();
     }
@@ -77,7 +81,7 @@ void DataProcessor::processDistanceData(const SensorData& data) {
         
         float distance = screenDistance * CALIBRATION_FACTOR;
         
-        displayData.labels.push_back(String(distance, 1) + " cm");
+        displayData.labels.push_back(DisplayLabel(DisplayLabelKind::DISTANCE_CM, distance));
         displayData.confidences.push_back(data.confidence);
     }
 }
@@ -89,20 +93,19 @@ void DataProcessor::processMultiObjectData(const SensorData& data) {
     float deltaTime = (currentTime - lastUpdateTime) / 1000.0f;
     
     for (size_t i = 0; i < data.points.size(); i++) {
-        String info;
+        DisplayLabel info(DisplayLabelKind::NEW_OBJECT);
         if (i < lastPositions.size() && deltaTime > 0) {
             int dx = data.points[i].x - lastPositions[i].x;
             int dy = data.points[i].y - lastPositions[i].y;
             float speed = sqrt(dx*dx + dy*dy) / deltaTime;
             
-            info = String(speed, 1) + " px/s ";
+            DisplayDirection direction;
             if (abs(dx) > abs(dy)) {
-                info += dx > 0 ? "→" : "←";
+                direction = dx > 0 ? DisplayDirection::RIGHT : DisplayDirection::LEFT;
             } else {
-                info += dy > 0 ? "↓" : "↑";
+                direction = dy > 0 ? DisplayDirection::DOWN : DisplayDirection::UP;
             }
-        } else {
-            info = "Nouvel objet";
+            info = DisplayLabel(DisplayLabelKind::SPEED, speed, direction);
         }
         
         displayData.labels.push_back(info);
@@ -115,7 +118,7 @@ void DataProcessor::processMultiObjectData(const SensorData& data) {
 
 void DataProcessor::processStandardData(const SensorData& data) {
     for (size_t i = 0; i < data.points.size(); i++) {
-        displayData.labels.push_back("Obj " + String(i + 1));
+        displayData.labels.push_back(DisplayLabel(DisplayLabelKind::OBJECT_INDEX, i + 1));
         displayData.confidences.push_back(data.confidence);
     }
 }
@@ -146,13 +149,10 @@ void DataProcessor::analyzeData() {
         avgTrend /= trends.size();
     }
     
-    String status = "Objets: " + String(displayData.points.size());
-    status += " | Tend.: ";
-    if (avgTrend > 0.1f) status += "↑";
-    else if (avgTrend < -0.1f) status += "↓";
-    else status += "→";
-    
-    displayData.statusMessage = status;
+    displayData.status.objectCount = displayData.points.size();
+    if (avgTrend > 0.1f) displayData.status.trend = DisplayDirection::UP;
+    else if (avgTrend < -0.1f) displayData.status.trend = DisplayDirection::DOWN;
+    else displayData.status.trend = DisplayDirection::RIGHT;
 }
 
 std::vector<float> DataProcessor::calculateTrends() const {
@@ -176,6 +176,6 @@ void DataProcessor::setMode(HuskyMode mode) {
     }
 }
 
-DisplayData DataProcessor::getDisplayData() const {
+const DisplayData& DataProcessor::getDisplayData() const {
     return displayData;
 }
\ No newline at end of file
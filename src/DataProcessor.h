@@ -9,7 +9,7 @@ public:
     DataProcessor();
     void begin();
     void process(const SensorData& data);
-    DisplayData getDisplayData() const;
+    const DisplayData& getDisplayData() const;
     void setMode(HuskyMode mode);
     
 private:
@@ -1,67 +1,207 @@
 #include "DisplayManager.h"
+#include "performance/Trace.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
 
-DisplayManager::DisplayManager() : 
+DisplayManager::DisplayManager() :
     currentMode(DisplayMode::GRAPHIC_INTERFACE),
-    nightMode(false) {}
+    nightMode(false),
+    mailboxMutex(xSemaphoreCreateMutex()),
+    taskHandle(nullptr),
+    framePending(false),
+    pendingSubmittedUs(0),
+    overlayPending(false),
+    requestedMode(DisplayMode::GRAPHIC_INTERFACE),
+    canvas(&M5.Lcd),
+    canvasReady(false),
+    fullRedraw(true),
+    dmaStrips{nullptr, nullptr},
+    drawnContentHash(0),
+    stats{} {}
 
 void DisplayManager::begin() {
     M5.Lcd.setTextSize(2);
     clearScreen();
+    
+    // Tampon arrière plein écran en PSRAM, bandes DMA en RAM interne
+    canvas.setColorDepth(16);
+    canvas.setPsram(true);
+    canvasReady = canvas.createSprite(M5.Lcd.width(), M5.Lcd.height()) != nullptr;
+    
+    for (int i = 0; i < 2 && canvasReady; i++) {
+        dmaStrips[i] = static_cast<uint16_t*>(
+            heap_caps_malloc(DMA_STRIP_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+        canvasReady = dmaStrips[i] != nullptr;
+    }
+    
+    if (canvasReady) {
+        canvas.setTextSize(2);
+    } else {
+        canvas.deleteSprite();
+        for (int i = 0; i < 2; i++) {
+            heap_caps_free(dmaStrips[i]);
+            dmaStrips[i] = nullptr;
+        }
+        Serial.println("Affichage : pas de tampon arrière, dessin direct");
+    }
+    
+    // Sans cache, les textes sont dessinés directement avec la police
+    if (!labelCache.begin(2)) {
+        Serial.println("Affichage : cache d'étiquettes indisponible");
+    }
+    fullRedraw = true;
+    
+    // À partir d'ici, seule la tâche d'affichage touche l'écran
+    if (xTaskCreatePinnedToCore(displayTask, "display", TASK_STACK_SIZE, this,
+                                TASK_PRIORITY, &taskHandle, TASK_CORE) != pdPASS) {
+        taskHandle = nullptr;
+        Serial.println("Affichage : tâche non créée, rendu synchrone");
+    }
 }
 
 void DisplayManager::update(const DisplayData& data) {
     if (!data.needsUpdate) return;
+    TRACE_SCOPE("DisplayManager::update");
     
-    clearScreen();
-    drawStatusBar(data.statusMessage);
+    if (!taskHandle) {
+        renderFrame(data);
+        return;
+    }
+    
+    // Copie sous verrou ; une trame pas encore prise par la tâche est remplacée
+    xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+    if (framePending) {
+        stats.framesDropped++;
+    }
+    pendingFrame = data;
+    framePending = true;
+    pendingSubmittedUs = esp_timer_get_time();
+    stats.framesSubmitted++;
+    xSemaphoreGive(mailboxMutex);
+    
+    xTaskNotifyGive(taskHandle);
+}
+
+void DisplayManager::runTask() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+        bool hasOverlay = overlayPending;
+        if (hasOverlay) {
+            std::swap(pendingOverlay, workingOverlay);
+            overlayPending = false;
+        }
+        bool hasFrame = framePending;
+        int64_t submittedUs = pendingSubmittedUs;
+        if (hasFrame) {
+            std::swap(pendingFrame, workingFrame);
+            framePending = false;
+        }
+        DisplayMode mode = requestedMode;
+        xSemaphoreGive(mailboxMutex);
+        
+        applyMode(mode);
+        
+        if (hasOverlay) {
+            if (workingOverlay.isMenu) {
+                drawMenu(workingOverlay.items, workingOverlay.selectedIndex);
+            } else {
+                drawError(workingOverlay.message, workingOverlay.recoverable);
+            }
+        }
+        
+        if (hasFrame) {
+            renderFrame(workingFrame);
+            stats.lastLatencyUs = esp_timer_get_time() - submittedUs;
+        }
+    }
+}
+
+void DisplayManager::displayTask(void* parameter) {
+    static_cast<DisplayManager*>(parameter)->runTask();
+}
+
+void DisplayManager::renderFrame(const DisplayData& data) {
+    TRACE_SCOPE("DisplayManager::renderFrame");
+    
+    if (!canvasReady) {
+        drawFrame(M5.Lcd, data);
+        stats.framesRendered++;
+        return;
+    }
+    
+    collectDirtyRegions(data);
+    if (dirtyRects.empty()) {
+        stats.framesSkipped++;
+        return;
+    }
+    
+    // Chaque zone est redessinée entièrement, les autres pixels restent intacts
+    int64_t start = esp_timer_get_time();
+    for (const Rect& rect : dirtyRects) {
+        canvas.setClipRect(rect.x, rect.y, rect.w, rect.h);
+        drawFrame(canvas, data);
+    }
+    canvas.clearClipRect();
+    stats.lastRenderUs = esp_timer_get_time() - start;
+    stats.maxRenderUs = std::max(stats.maxRenderUs, stats.lastRenderUs);
+    
+    pushDirtyRegions();
+    stats.framesRendered++;
+}
+
+void DisplayManager::drawFrame(lgfx::LovyanGFX& gfx, const DisplayData& data) {
+    gfx.fillScreen(nightMode ? TFT_BLACK : TFT_WHITE);
+    drawStatusBar(gfx, data.status);
     
     switch (currentMode) {
         case DisplayMode::RAW_DATA:
-            drawInterface(data);
+            drawInterface(gfx, data);
             break;
         case DisplayMode::ANALYTICS_VIEW:
-            drawAnalytics(data);
+            drawAnalytics(gfx, data);
             break;
         case DisplayMode::DEBUGGING_VIEW:
-            drawDebugInfo(data);
+            drawDebugInfo(gfx, data);
             break;
         default:
-            drawInterface(data);
+            drawInterface(gfx, data);
     }
 }
 
-void DisplayManager::drawInterface(const DisplayData& data) {
+void DisplayManager::drawInterface(lgfx::LovyanGFX& gfx, const DisplayData& data) {
+    uint32_t textColor = nightMode ? TFT_WHITE : TFT_BLACK;
+    char text[32];
+    
     for (size_t i = 0; i < data.points.size(); i++) {
         const Point& p = data.points[i];
-        M5.Lcd.fillCircle(p.x, p.y, 3, TFT_GREEN);
+        gfx.fillCircle(p.x, p.y, 3, TFT_GREEN);
         
         if (i < data.labels.size()) {
-            M5.Lcd.drawString(data.labels[i], p.x + 5, p.y - 10);
+            formatLabel(data.labels[i], text, sizeof(text));
+            labelCache.draw(gfx, text, p.x + 5, p.y - 10, textColor);
         }
         
         if (i < data.confidences.size()) {
-            M5.Lcd.drawFloat(data.confidences[i], 1, p.x + 5, p.y + 10);
+            formatConfidence(lroundf(data.confidences[i] * 10.0f), text, sizeof(text));
+            labelCache.draw(gfx, text, p.x + 5, p.y + 10, textColor);
         }
     }
 }
 
-void DisplayManager::drawAnalytics(const DisplayData& data) {
+void DisplayManager::drawAnalytics(lgfx::LovyanGFX& gfx, const DisplayData& data) {
     const int GRAPH_X = 10;
     const int GRAPH_Y = 50;
     const int GRAPH_W = 300;
     const int GRAPH_H = 150;
     
-    M5.Lcd.drawRect(GRAPH_X, GRAPH_Y, GRAPH_W, GRAPH_H, TFT_WHITE);
-    
-    std::vector<float> graphData;
-    for (float conf : data.confidences) {
-        graphData.push_back(conf);
-    }
-    
-    drawGraph(graphData, GRAPH_X, GRAPH_Y, GRAPH_W, GRAPH_H);
+    gfx.drawRect(GRAPH_X, GRAPH_Y, GRAPH_W, GRAPH_H, TFT_WHITE);
+    drawGraph(gfx, data.confidences, GRAPH_X, GRAPH_Y, GRAPH_W, GRAPH_H);
 }
 
-void DisplayManager::drawGraph(const std::vector<float>& data, int x, int y, int width, int height) {
+void DisplayManager::drawGraph(lgfx::LovyanGFX& gfx, const std::vector<float>& data,
+                               int x, int y, int width, int height) {
     if (data.empty()) return;
     
     float maxVal = *std::max_element(data.begin(), data.end());
@@ -75,26 +215,289 @@ void DisplayManager::drawGraph(const std::vector<float>& data, int x, int y, int
         int y1 = y + height - (height * (data[i-1] - minVal)) / range;
         int y2 = y + height - (height * (data[i] - minVal)) / range;
         
-        M5.Lcd.drawLine(x1, y1, x2, y2, TFT_YELLOW);
+        gfx.drawLine(x1, y1, x2, y2, TFT_YELLOW);
     }
 }
 
-void DisplayManager::drawDebugInfo(const DisplayData& data) {
-    M5.Lcd.setCursor(0, 30);
-    M5.Lcd.printf("Points: %d\n", data.points.size());
-    M5.Lcd.printf("Labels: %d\n", data.labels.size());
-    M5.Lcd.printf("Conf: %d\n", data.confidences.size());
-    M5.Lcd.println(data.statusMessage);
+void DisplayManager::drawDebugInfo(lgfx::LovyanGFX& gfx, const DisplayData& data) {
+    gfx.setCursor(0, 30);
+    gfx.printf("Points: %d\n", data.points.size());
+    gfx.printf("Labels: %d\n", data.labels.size());
+    gfx.printf("Conf: %d\n", data.confidences.size());
+    
+    char status[48];
+    formatStatus(data.status, status, sizeof(status));
+    gfx.println(status);
 }
 
-void DisplayManager::drawStatusBar(const String& status) {
-    M5.Lcd.fillRect(0, 0, 320, 20, TFT_BLUE);
-    M5.Lcd.setTextColor(TFT_WHITE);
-    M5.Lcd.drawString(status, 5, 5);
-    M5.Lcd.setTextColor(nightMode ? TFT_WHITE : TFT_BLACK);
+void DisplayManager::drawStatusBar(lgfx::LovyanGFX& gfx, const DisplayStatus& status) {
+    char text[48];
+    formatStatus(status, text, sizeof(text));
+    
+    gfx.fillRect(0, 0, 320, STATUS_BAR_HEIGHT, TFT_BLUE);
+    labelCache.draw(gfx, text, 5, 5, TFT_WHITE);
+    gfx.setTextColor(nightMode ? TFT_WHITE : TFT_BLACK);
+}
+
+bool DisplayManager::usesPointView() const {
+    return currentMode != DisplayMode::ANALYTICS_VIEW &&
+           currentMode != DisplayMode::DEBUGGING_VIEW;
+}
+
+void DisplayManager::collectDirtyRegions(const DisplayData& data) {
+    dirtyRects.clear();
+    
+    if (data.status != drawnStatus) {
+        addDirty({0, 0, (int16_t)canvas.width(), STATUS_BAR_HEIGHT});
+        drawnStatus = data.status;
+    }
+    
+    if (usesPointView()) {
+        // Un point modifié invalide son ancienne et sa nouvelle emprise
+        std::vector<DrawnPoint> points(data.points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            DrawnPoint& point = points[i];
+            point.position = data.points[i];
+            point.label = i < data.labels.size() ? data.labels[i] : DisplayLabel();
+            point.confidence = i < data.confidences.size() ?
+                (int16_t)lroundf(data.confidences[i] * 10.0f) : INT16_MIN;
+            point.box = pointBox(point);
+            
+            if (i >= drawnPoints.size()) {
+                addDirty(point.box);
+                continue;
+            }
+            
+            const DrawnPoint& previous = drawnPoints[i];
+            if (previous.position.x != point.position.x || previous.position.y != point.position.y ||
+                previous.confidence != point.confidence || previous.label != point.label) {
+                addDirty(previous.box);
+                addDirty(point.box);
+            }
+        }
+        for (size_t i = points.size(); i < drawnPoints.size(); i++) {
+            addDirty(drawnPoints[i].box);
+        }
+        drawnPoints.swap(points);
+    } else {
+        uint32_t hash = contentHash(data);
+        if (hash != drawnContentHash) {
+            addDirty({0, STATUS_BAR_HEIGHT, (int16_t)canvas.width(),
+                      (int16_t)(canvas.height() - STATUS_BAR_HEIGHT)});
+            drawnContentHash = hash;
+        }
+    }
+    
+    if (fullRedraw) {
+        dirtyRects.clear();
+        dirtyRects.push_back({0, 0, (int16_t)canvas.width(), (int16_t)canvas.height()});
+        fullRedraw = false;
+        stats.fullRedraws++;
+    }
+}
+
+void DisplayManager::addDirty(Rect rect) {
+    // Limité à l'écran
+    int16_t x2 = std::min<int16_t>(rect.x + rect.w, canvas.width());
+    int16_t y2 = std::min<int16_t>(rect.y + rect.h, canvas.height());
+    rect.x = std::max<int16_t>(rect.x, 0);
+    rect.y = std::max<int16_t>(rect.y, 0);
+    rect.w = x2 - rect.x;
+    rect.h = y2 - rect.y;
+    if (rect.w <= 0 || rect.h <= 0) return;
+    
+    // Fusion avec les zones qui le chevauchent (en chaîne)
+    for (size_t i = 0; i < dirtyRects.size();) {
+        const Rect& other = dirtyRects[i];
+        if (rect.x < other.x + other.w && other.x < rect.x + rect.w &&
+            rect.y < other.y + other.h && other.y < rect.y + rect.h) {
+            int16_t left = std::min(rect.x, other.x);
+            int16_t top = std::min(rect.y, other.y);
+            rect.w = std::max(rect.x + rect.w, other.x + other.w) - left;
+            rect.h = std::max(rect.y + rect.h, other.y + other.h) - top;
+            rect.x = left;
+            rect.y = top;
+            dirtyRects.erase(dirtyRects.begin() + i);
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    dirtyRects.push_back(rect);
+    
+    // Trop de zones : une seule emprise globale
+    if (dirtyRects.size() > MAX_DIRTY_RECTS) {
+        Rect bounds = dirtyRects[0];
+        for (const Rect& other : dirtyRects) {
+            int16_t left = std::min(bounds.x, other.x);
+            int16_t top = std::min(bounds.y, other.y);
+            bounds.w = std::max(bounds.x + bounds.w, other.x + other.w) - left;
+            bounds.h = std::max(bounds.y + bounds.h, other.y + other.h) - top;
+            bounds.x = left;
+            bounds.y = top;
+        }
+        dirtyRects.assign(1, bounds);
+    }
+}
+
+DisplayManager::Rect DisplayManager::pointBox(const DrawnPoint& point) {
+    // Cercle de rayon 3, étiquette au-dessus, confiance en dessous (voir drawInterface)
+    int left = point.position.x - 3;
+    int top = point.position.y - 3;
+    int right = point.position.x + 4;
+    int bottom = point.position.y + 4;
+    int textHeight = labelCache.fontHeight();
+    char text[32];
+    
+    if (point.label.kind != DisplayLabelKind::NONE) {
+        formatLabel(point.label, text, sizeof(text));
+        right = std::max(right, point.position.x + 5 + labelCache.textWidth(text));
+        top = std::min(top, point.position.y - 10);
+        bottom = std::max(bottom, point.position.y - 10 + textHeight);
+    }
+    if (point.confidence != INT16_MIN) {
+        formatConfidence(point.confidence, text, sizeof(text));
+        right = std::max(right, point.position.x + 5 + labelCache.textWidth(text));
+        bottom = std::max(bottom, point.position.y + 10 + textHeight);
+    }
+    
+    return {(int16_t)left, (int16_t)top, (int16_t)(right - left), (int16_t)(bottom - top)};
+}
+
+void DisplayManager::pushDirtyRegions() {
+    const int width = canvas.width();
+    const uint16_t* pixels = static_cast<const uint16_t*>(canvas.getBuffer());
+    uint32_t dirtyPixels = 0;
+    int slot = 0;
+    
+    int64_t start = esp_timer_get_time();
+    M5.Lcd.startWrite();
+    
+    // La bande suivante est copiée depuis la PSRAM pendant l'envoi DMA de la précédente
+    for (const Rect& rect : dirtyRects) {
+        int stripRows = std::max<int>(1, DMA_STRIP_PIXELS / rect.w);
+        for (int y = rect.y; y < rect.y + rect.h; y += stripRows) {
+            int rows = std::min(stripRows, rect.y + rect.h - y);
+            uint16_t* strip = dmaStrips[slot];
+            for (int row = 0; row < rows; row++) {
+                memcpy(strip + row * rect.w, pixels + (y + row) * width + rect.x,
+                       rect.w * sizeof(uint16_t));
+            }
+            
+            // Pixels du canevas déjà dans l'ordre d'octets de l'écran
+            M5.Lcd.waitDMA();
+            M5.Lcd.pushImageDMA(rect.x, y, rect.w, rows, reinterpret_cast<const lgfx::swap565_t*>(strip));
+            slot ^= 1;
+        }
+        dirtyPixels += rect.w * rect.h;
+    }
+    
+    M5.Lcd.waitDMA();
+    M5.Lcd.endWrite();
+    
+    stats.lastLcdUs = esp_timer_get_time() - start;
+    stats.maxLcdUs = std::max(stats.maxLcdUs, stats.lastLcdUs);
+    stats.lastDirtyPixels = dirtyPixels;
+    stats.bytesPushed += dirtyPixels * sizeof(uint16_t);
+}
+
+uint32_t DisplayManager::contentHash(const DisplayData& data) {
+    // FNV-1a sur ce qu'affichent les vues analytique et debug
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* bytes, size_t length) {
+        const uint8_t* p = static_cast<const uint8_t*>(bytes);
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ p[i]) * 16777619u;
+        }
+    };
+    
+    size_t counts[3] = {data.points.size(), data.labels.size(), data.confidences.size()};
+    mix(counts, sizeof(counts));
+    if (!data.confidences.empty()) {
+        mix(data.confidences.data(), data.confidences.size() * sizeof(float));
+    }
+    mix(&data.status.objectCount, sizeof(data.status.objectCount));
+    mix(&data.status.trend, sizeof(data.status.trend));
+    return hash;
+}
+
+const char* DisplayManager::arrow(DisplayDirection direction) {
+    switch (direction) {
+        case DisplayDirection::RIGHT: return "→";
+        case DisplayDirection::LEFT: return "←";
+        case DisplayDirection::DOWN: return "↓";
+        case DisplayDirection::UP: return "↑";
+        default: return "";
+    }
+}
+
+void DisplayManager::formatLabel(const DisplayLabel& label, char* out, size_t size) {
+    switch (label.kind) {
+        case DisplayLabelKind::OBJECT_INDEX:
+            snprintf(out, size, "Obj %d", (int)label.value);
+            break;
+        case DisplayLabelKind::DISTANCE_CM:
+            snprintf(out, size, "%.1f cm", label.value);
+            break;
+        case DisplayLabelKind::SPEED:
+            snprintf(out, size, "%.1f px/s %s", label.value, arrow(label.direction));
+            break;
+        case DisplayLabelKind::NEW_OBJECT:
+            snprintf(out, size, "Nouvel objet");
+            break;
+        case DisplayLabelKind::GESTURE: {
+            const char* name = label.direction == DisplayDirection::RIGHT ? "Droite" :
+                               label.direction == DisplayDirection::LEFT ? "Gauche" :
+                               label.direction == DisplayDirection::DOWN ? "Bas" : "Haut";
+            snprintf(out, size, "%s %s", arrow(label.direction), name);
+            break;
+        }
+        default:
+            out[0] = '\0';
+    }
+}
+
+void DisplayManager::formatStatus(const DisplayStatus& status, char* out, size_t size) {
+    snprintf(out, size, "Objets: %u | Tend.: %s", (unsigned)status.objectCount, arrow(status.trend));
+}
+
+void DisplayManager::formatConfidence(int16_t tenths, char* out, size_t size) {
+    snprintf(out, size, "%.1f", tenths / 10.0f);
 }
 
 void DisplayManager::showMenu(const std::vector<String>& items, int selectedIndex) {
+    if (!taskHandle) {
+        drawMenu(items, selectedIndex);
+        return;
+    }
+    
+    xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+    pendingOverlay.isMenu = true;
+    pendingOverlay.items = items;
+    pendingOverlay.selectedIndex = selectedIndex;
+    overlayPending = true;
+    xSemaphoreGive(mailboxMutex);
+    
+    xTaskNotifyGive(taskHandle);
+}
+
+void DisplayManager::showError(const String& message, bool isRecoverable) {
+    if (!taskHandle) {
+        drawError(message, isRecoverable);
+        return;
+    }
+    
+    xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+    pendingOverlay.isMenu = false;
+    pendingOverlay.message = message;
+    pendingOverlay.recoverable = isRecoverable;
+    overlayPending = true;
+    xSemaphoreGive(mailboxMutex);
+    
+    xTaskNotifyGive(taskHandle);
+}
+
+void DisplayManager::drawMenu(const std::vector<String>& items, int selectedIndex) {
     clearScreen();
     M5.Lcd.setTextSize(2);
     
@@ -108,9 +511,12 @@ void DisplayManager::showMenu(const std::vector<String>& items, int selectedInde
         }
         M5.Lcd.drawString(items[i], 10, y);
     }
+    
+    // Dessiné hors tampon arrière : l'écran devra être renvoyé en entier
+    fullRedraw = true;
 }
 
-void DisplayManager::showError(const String& message, bool isRecoverable) {
+void DisplayManager::drawError(const String& message, bool isRecoverable) {
     uint32_t bgColor = isRecoverable ? TFT_YELLOW : TFT_RED;
     M5.Lcd.fillScreen(bgColor);
     M5.Lcd.setTextColor(TFT_BLACK);
@@ -119,6 +525,7 @@ void DisplayManager::showError(const String& message, bool isRecoverable) {
     M5.Lcd.setTextSize(4);
     M5.Lcd.print(message);
     M5.Lcd.setTextSize(2);  // Retour à la taille par défaut
+    fullRedraw = true;
 }
 
 void DisplayManager::clearScreen() {
@@ -127,8 +534,21 @@ void DisplayManager::clearScreen() {
 }
 
 void DisplayManager::setMode(DisplayMode mode) {
+    // Appliqué par la tâche avant la trame suivante
+    xSemaphoreTake(mailboxMutex, portMAX_DELAY);
+    requestedMode = mode;
+    xSemaphoreGive(mailboxMutex);
+    
+    if (!taskHandle) {
+        applyMode(mode);
+    }
+}
+
+void DisplayManager::applyMode(DisplayMode mode) {
     if (currentMode != mode) {
         currentMode = mode;
         clearScreen();
+        drawnPoints.clear();
+        fullRedraw = true;
     }
 }
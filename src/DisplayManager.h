@@ -1,9 +1,37 @@
 #pragma once
 
 #include <M5CoreS3.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include "Config.h"
+#include "LabelCache.h"
 #include <vector>
 
+struct DisplayStats {
+    uint32_t framesSubmitted;
+    uint32_t framesDropped;     // Remplacées dans la boîte aux lettres avant rendu
+    uint32_t framesRendered;
+    uint32_t framesSkipped;     // DisplayData inchangé : aucun transfert
+    uint32_t fullRedraws;
+    uint32_t lastDirtyPixels;
+    uint32_t lastRenderUs;      // Dessin dans le tampon arrière
+    uint32_t maxRenderUs;
+    uint32_t lastLcdUs;         // Transfert vers l'écran de la dernière trame
+    uint32_t maxLcdUs;
+    uint32_t lastLatencyUs;     // De update() à la fin du transfert
+    uint64_t bytesPushed;
+};
+
+// Rendu dans un tampon arrière (M5Canvas 16 bits en PSRAM) ; seules les
+// zones modifiées (barre d'état, points et leurs textes, zone de contenu
+// des vues analytiques) sont redessinées puis envoyées à l'écran par DMA,
+// en bandes alternées dans deux tampons de RAM interne. Sans PSRAM, on
+// revient au dessin direct sur l'écran.
+// Après begin(), une tâche dédiée possède l'écran : update(), showMenu(),
+// showError() et setMode() ne font que déposer une copie dans une boîte
+// aux lettres de profondeur 1 (la plus récente l'emporte) et rendent la
+// main ; la boucle de vision n'attend jamais le SPI.
 class DisplayManager {
 public:
     DisplayManager();
@@ -12,16 +40,93 @@ public:
     void setMode(DisplayMode mode);
     void showError(const String& message, bool isRecoverable = true);
     void showMenu(const std::vector<String>& items, int selectedIndex);
+    // Écrites par la tâche d'affichage (mots de 32 bits)
+    DisplayStats getStats() const { return stats; }
+    LabelCacheStats getLabelCacheStats() const { return labelCache.getStats(); }
     
 private:
+    static const int STATUS_BAR_HEIGHT = 20;
+    static const size_t MAX_DIRTY_RECTS = 8;
+    static const size_t DMA_STRIP_PIXELS = 320 * 16;
+    static const uint32_t TASK_STACK_SIZE = 6144;
+    static const UBaseType_t TASK_PRIORITY = 2;
+    static const BaseType_t TASK_CORE = 0;
+    
+    struct Rect {
+        int16_t x, y, w, h;
+    };
+    
+    // Ce qui a été dessiné pour un point, pour détecter ses changements
+    struct DrawnPoint {
+        Point position;
+        DisplayLabel label;
+        int16_t confidence;     // x10 (affiché avec une décimale), INT16_MIN si absent
+        Rect box;
+    };
+    
+    // Message plein écran (menu ou erreur), jamais écrasé par une trame
+    struct Overlay {
+        bool isMenu;
+        std::vector<String> items;
+        int selectedIndex;
+        String message;
+        bool recoverable;
+    };
+    
     DisplayMode currentMode;
     bool nightMode;
     
-    void drawInterface(const DisplayData& data);
-    void drawAnalytics(const DisplayData& data);
-    void drawDebugInfo(const DisplayData& data);
-    void drawStatusBar(const String& status);
+    // Boîte aux lettres ; le verrou n'est tenu que le temps d'une copie ou d'un échange
+    SemaphoreHandle_t mailboxMutex;
+    TaskHandle_t taskHandle;
+    DisplayData pendingFrame;
+    bool framePending;
+    int64_t pendingSubmittedUs;
+    Overlay pendingOverlay;
+    bool overlayPending;
+    DisplayMode requestedMode;
+    
+    // Propriété de la tâche d'affichage
+    DisplayData workingFrame;
+    Overlay workingOverlay;
+    
+    M5Canvas canvas;
+    LabelCache labelCache;
+    bool canvasReady;
+    bool fullRedraw;
+    uint16_t* dmaStrips[2];
+    
+    std::vector<DrawnPoint> drawnPoints;
+    DisplayStatus drawnStatus;
+    uint32_t drawnContentHash;
+    std::vector<Rect> dirtyRects;
+    DisplayStats stats;
+    
+    void drawFrame(lgfx::LovyanGFX& gfx, const DisplayData& data);
+    void drawInterface(lgfx::LovyanGFX& gfx, const DisplayData& data);
+    void drawAnalytics(lgfx::LovyanGFX& gfx, const DisplayData& data);
+    void drawDebugInfo(lgfx::LovyanGFX& gfx, const DisplayData& data);
+    void drawStatusBar(lgfx::LovyanGFX& gfx, const DisplayStatus& status);
     void drawDetectionZones(const std::vector<DetectionZone>& zones);
-    void drawGraph(const std::vector<float>& data, int x, int y, int width, int height);
+    void drawGraph(lgfx::LovyanGFX& gfx, const std::vector<float>& data, int x, int y, int width, int height);
     void clearScreen();
+    void drawMenu(const std::vector<String>& items, int selectedIndex);
+    void drawError(const String& message, bool isRecoverable);
+    void applyMode(DisplayMode mode);
+    void renderFrame(const DisplayData& data);
+    void runTask();
+    static void displayTask(void* parameter);
+    
+    bool usesPointView() const;
+    void collectDirtyRegions(const DisplayData& data);
+    void addDirty(Rect rect);
+    void pushDirtyRegions();
+    Rect pointBox(const DrawnPoint& point);
+    static uint32_t contentHash(const DisplayData& data);
+    
+    // Formatage au moment du dessin, dans un tampon de l'appelant
+    static void formatLabel(const DisplayLabel& label, char* out, size_t size);
+    static void formatStatus(const DisplayStatus& status, char* out, size_t size);
+    static void formatConfidence(int16_t tenths, char* out, size_t size);
+    static const char* arrow(DisplayDirection direction);
 };
@@ -1,4 +1,5 @@
 #include "GestureAnalyzer.h"
+#include "performance/Trace.h"
 #include <cmath>
 #include <algorithm>
 
@@ -54,6 +55,8 @@ void GestureAnalyzer::clearPoints() {
 }
 
 String GestureAnalyzer::recognizeGesture() {
+    TRACE_SCOPE("GestureAnalyzer::recognizeGesture");
+    
     if (points.size() < 10) return "";
     
     std::vector<Point> current(points.begin(), points.end());
@@ -2,10 +2,13 @@
 #include "SD.h"
 #include "FS.h"
 #include "SPIFFS.h"
+#include "performance/Trace.h"
 
 HuskyLensPlus::HuskyLensPlus() : 
     currentMode(HuskyMode::FACE_RECOGNITION),
-    connected(false) {}
+    connected(false),
+    sdAvailable(false),
+    qrLogPendingWrites(0) {}
 
 bool HuskyLensPlus::begin() {
     Wire.begin(2, 1);  // SDA=2, SCL=1 for M5Stack Core S3
@@ -13,10 +16,15 @@ bool HuskyLensPlus::begin() {
     if (connected) {
         configureMode(currentMode);
     }
+    
+    // Carte SD montée une seule fois, journal des tags gardé ouvert
+    sdAvailable = SD.begin() && openQRLog();
     return connected;
 }
 
 void HuskyLensPlus::update() {
+    TRACE_SCOPE("HuskyLensPlus::update");
+    
     if (!connected || !huskyLens.request()) {
         connected = false;
         return;
@@ -121,6 +129,11 @@ void HuskyLensPlus::saveModel() {
     }
 }
 
+bool HuskyLensPlus::savePicture() {
+    if (!connected) return false;
+    return huskyLens.savePictureToSDCard();
+}
+
 float HuskyLensPlus::calculateDistance(int width, int height) const {
     const float REFERENCE_SIZE = 100.0f;
     const float REFERENCE_DISTANCE = 50.0f;
@@ -241,62 +254,69 @@ void HuskyLensPlus::handleQRCode() {
                 currentData.labels.push_back("Pos: " + pos);
                 
                 // Sauvegarder l'historique si la carte SD est disponible
-                if (SD.begin()) {
-                    manageQRLogFile();
-                    File logFile = SD.open(Constants::QR_LOG_FILE, FILE_APPEND);
-                    if (logFile) {
-                        String logEntry = String(millis()) + ",Tag:" + qrData + ",Pos:" + pos + "\n";
-                        logFile.print(logEntry);
-                        logFile.close();
-                    }
+                if (sdAvailable) {
+                    appendQRLog(result.ID, center);
                 }
             }
         }
     }
 }
 
-void HuskyLensPlus::manageQRLogFile() const {
-    if (!SD.exists(Constants::QR_LOG_FILE)) return;
+bool HuskyLensPlus::openQRLog() {
+    const uint16_t capacity = Constants::MAX_QR_LOG_ENTRIES;
+    
+    // Réutiliser un journal existant s'il a la même géométrie
+    if (SD.exists(Constants::QR_LOG_FILE)) {
+        qrLogFile = SD.open(Constants::QR_LOG_FILE, "r+");
+        if (qrLogFile &&
+            qrLogFile.read(reinterpret_cast<uint8_t*>(&qrLogHeader), sizeof(qrLogHeader)) == sizeof(qrLogHeader) &&
+            memcmp(qrLogHeader.magic, "QRL1", 4) == 0 &&
+            qrLogHeader.capacity == capacity &&
+            qrLogHeader.recordSize == sizeof(QRLogRecord) &&
+            qrLogHeader.nextSlot < capacity) {
+            return true;
+        }
+        if (qrLogFile) qrLogFile.close();
+    }
+    
+    // Sinon repartir d'un journal vide
+    qrLogFile = SD.open(Constants::QR_LOG_FILE, "w+");
+    if (!qrLogFile) return false;
+    
+    memcpy(qrLogHeader.magic, "QRL1", 4);
+    qrLogHeader.capacity = capacity;
+    qrLogHeader.recordSize = sizeof(QRLogRecord);
+    qrLogHeader.nextSlot = 0;
+    qrLogHeader.count = 0;
+    qrLogFile.write(reinterpret_cast<const uint8_t*>(&qrLogHeader), sizeof(qrLogHeader));
+    qrLogFile.flush();
+    return true;
+}
+
+void HuskyLensPlus::appendQRLog(uint32_t tagId, const Point& position) {
+    if (!qrLogFile) return;
     
-    File logFile = SD.open(Constants::QR_LOG_FILE, FILE_READ);
-    if (!logFile) return;
+    QRLogRecord record;
+    record.timestamp = millis();
+    record.tagId = tagId;
+    record.x = position.x;
+    record.y = position.y;
+    record.reserved = 0;
     
-    // Compter les lignes
-    int lineCount = 0;
-    while (logFile.available()) {
-        char c = logFile.read();
-        if (c == '\n') lineCount++;
+    // O(1) : écraser la case la plus ancienne puis mettre à jour l'index
+    qrLogFile.seek(sizeof(QRLogHeader) + qrLogHeader.nextSlot * sizeof(QRLogRecord));
+    qrLogFile.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+    
+    qrLogHeader.nextSlot = (qrLogHeader.nextSlot + 1) % qrLogHeader.capacity;
+    if (qrLogHeader.count < qrLogHeader.capacity) {
+        qrLogHeader.count++;
     }
-    logFile.close();
+    qrLogFile.seek(0);
+    qrLogFile.write(reinterpret_cast<const uint8_t*>(&qrLogHeader), sizeof(qrLogHeader));
     
-    // Si le nombre de lignes dépasse la limite
-    if (lineCount > Constants::MAX_QR_LOG_ENTRIES) {
-        // Créer un fichier temporaire
-        File tempFile = SD.open("/temp_qr.txt", FILE_WRITE);
-        if (!tempFile) return;
-        
-        logFile = SD.open(Constants::QR_LOG_FILE, FILE_READ);
-        if (!logFile) {
-            tempFile.close();
-            return;
-        }
-        
-        // Ignorer les premières lignes
-        int linesToSkip = lineCount - Constants::MAX_QR_LOG_ENTRIES;
-        for (int i = 0; i < linesToSkip; i++) {
-            while (logFile.available() && logFile.read() != '\n');
-        }
-        
-        // Copier les lignes restantes
-        while (logFile.available()) {
-            tempFile.write(logFile.read());
-        }
-        
-        logFile.close();
-        tempFile.close();
-        
-        // Remplacer l'ancien fichier
-        SD.remove(Constants::QR_LOG_FILE);
-        SD.rename("/temp_qr.txt", Constants::QR_LOG_FILE);
+    // Synchronisation FAT groupée plutôt qu'à chaque détection
+    if (++qrLogPendingWrites >= QR_LOG_SYNC_EVERY) {
+        qrLogFile.flush();
+        qrLogPendingWrites = 0;
     }
-}
\ No newline at end of file
+}
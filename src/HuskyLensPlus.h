@@ -3,9 +3,29 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "HUSKYLENS.h"
+#include <FS.h>
 #include "Config.h"
 #include <vector>
 
+// Journal des tags : fichier circulaire à enregistrements de taille fixe.
+// L'en-tête indexe la prochaine case et le nombre d'entrées valides, un
+// ajout écrit donc un enregistrement et l'en-tête sans relire le fichier.
+struct QRLogHeader {
+    char magic[4];          // "QRL1"
+    uint16_t capacity;      // Nombre de cases
+    uint16_t recordSize;
+    uint32_t nextSlot;      // Prochaine case à écrire
+    uint32_t count;         // Entrées valides (<= capacity)
+} __attribute__((packed));
+
+struct QRLogRecord {
+    uint32_t timestamp;
+    uint32_t tagId;
+    int16_t x;
+    int16_t y;
+    uint32_t reserved;
+} __attribute__((packed));
+
 class HuskyLensPlus {
 public:
     HuskyLensPlus();
@@ -17,12 +37,20 @@ public:
     void learn(int id);
     void forget();
     void saveModel();
+    // Photo sur la carte SD de la HuskyLens (nom choisi par le module)
+    bool savePicture();
     
 private:
     HUSKYLENS huskyLens;
     HuskyMode currentMode;
     SensorData currentData;
     bool connected;
+    bool sdAvailable;
+    File qrLogFile;
+    QRLogHeader qrLogHeader;
+    uint32_t qrLogPendingWrites;
+    
+    static const uint32_t QR_LOG_SYNC_EVERY = 16;
     
     void configureMode(HuskyMode mode);
     void processData();
@@ -31,5 +59,6 @@ private:
     void handleMultiObject();
     void handleQRCode();
     float calculateDistance(int width, int height) const;
-    void manageQRLogFile() const;
+    bool openQRLog();
+    void appendQRLog(uint32_t tagId, const Point& position);
 };
@@ -0,0 +1,112 @@
+#include "LabelCache.h"
+#include <esp_heap_caps.h>
+
+LabelCache::LabelCache() :
+    entries{},
+    bitmaps(nullptr),
+    height(0),
+    useCounter(0),
+    stats{} {}
+
+LabelCache::~LabelCache() {
+    if (bitmaps) heap_caps_free(bitmaps);
+    scratch.deleteSprite();
+}
+
+bool LabelCache::begin(uint8_t textSize) {
+    if (bitmaps) return true;
+    
+    scratch.setColorDepth(1);
+    scratch.setTextSize(textSize);
+    height = scratch.fontHeight();
+    if (!scratch.createSprite(MAX_WIDTH, height)) {
+        return false;
+    }
+    scratch.setTextColor(TFT_WHITE);
+    
+    size_t size = CAPACITY * (MAX_WIDTH / 8) * height;
+    bitmaps = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM));
+    if (!bitmaps) {
+        bitmaps = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_8BIT));
+    }
+    return bitmaps != nullptr;
+}
+
+void LabelCache::draw(lgfx::LovyanGFX& gfx, const char* text, int x, int y, uint32_t color) {
+    size_t length = strlen(text);
+    Entry* entry = bitmaps ? lookup(text, length) : nullptr;
+    
+    if (!entry) {
+        stats.bypassed++;
+        gfx.setTextColor(color);
+        gfx.drawString(text, x, y);
+        return;
+    }
+    
+    if (entry->width > 0) {
+        gfx.drawBitmap(x, y, bitmapOf(*entry), entry->width, height, color);
+    }
+}
+
+int LabelCache::textWidth(const char* text) {
+    size_t length = strlen(text);
+    Entry* entry = bitmaps ? lookup(text, length) : nullptr;
+    return entry ? entry->width : scratch.textWidth(text);
+}
+
+LabelCache::Entry* LabelCache::lookup(const char* text, size_t length) {
+    if (length >= MAX_TEXT) {
+        return nullptr;
+    }
+    
+    uint32_t hash = hashText(text, length);
+    Entry* victim = &entries[0];
+    for (Entry& entry : entries) {
+        if (entry.used && entry.hash == hash && strcmp(entry.text, text) == 0) {
+            entry.lastUse = ++useCounter;
+            stats.hits++;
+            return &entry;
+        }
+        // Place libre d'abord, sinon la moins récemment utilisée
+        if (!entry.used) {
+            if (victim->used) victim = &entry;
+        } else if (victim->used && entry.lastUse < victim->lastUse) {
+            victim = &entry;
+        }
+    }
+    
+    int width = scratch.textWidth(text);
+    if (width > MAX_WIDTH) {
+        return nullptr;
+    }
+    
+    // Rastérisation une fois pour toutes, puis copie compacte (ligne de (w+7)/8 octets)
+    scratch.fillSprite(TFT_BLACK);
+    scratch.drawString(text, 0, 0);
+    
+    const uint8_t* source = static_cast<const uint8_t*>(scratch.getBuffer());
+    uint8_t* target = bitmapOf(*victim);
+    size_t rowBytes = (width + 7) / 8;
+    for (int row = 0; row < height; row++) {
+        memcpy(target + row * rowBytes, source + row * (MAX_WIDTH / 8), rowBytes);
+    }
+    
+    if (victim->used) {
+        stats.evictions++;
+    }
+    stats.misses++;
+    victim->used = true;
+    victim->hash = hash;
+    victim->width = width;
+    victim->lastUse = ++useCounter;
+    memcpy(victim->text, text, length + 1);
+    return victim;
+}
+
+uint32_t LabelCache::hashText(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <M5CoreS3.h>
+
+struct LabelCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t bypassed;     // Texte trop long ou trop large : dessin direct
+};
+
+// Cache LRU des textes déjà rastérisés (étiquettes, confiances, barre
+// d'état). Chaque entrée garde le masque 1 bit du texte en PSRAM ; un
+// succès se dessine avec drawBitmap, sans repasser par la police.
+// La couleur est appliquée au dessin : une entrée sert pour toutes.
+// Non protégé : utilisé uniquement par la tâche d'affichage.
+class LabelCache {
+public:
+    LabelCache();
+    ~LabelCache();
+    
+    bool begin(uint8_t textSize);
+    
+    // Dessine text en (x, y) (coin haut gauche), fond transparent
+    void draw(lgfx::LovyanGFX& gfx, const char* text, int x, int y, uint32_t color);
+    int textWidth(const char* text);
+    int fontHeight() const { return height; }
+    LabelCacheStats getStats() const { return stats; }
+    
+private:
+    static const size_t CAPACITY = 64;
+    static const size_t MAX_TEXT = 24;
+    static const int MAX_WIDTH = 160;              // Multiple de 8
+    
+    struct Entry {
+        uint32_t hash;
+        uint32_t lastUse;
+        uint16_t width;
+        bool used;
+        char text[MAX_TEXT];
+    };
+    
+    Entry entries[CAPACITY];
+    uint8_t* bitmaps;           // CAPACITY masques de MAX_WIDTH/8 x height octets
+    M5Canvas scratch;           // Rastérisation 1 bit des textes absents
+    int height;
+    uint32_t useCounter;
+    LabelCacheStats stats;
+    
+    Entry* lookup(const char* text, size_t length);
+    uint8_t* bitmapOf(const Entry& entry) { return bitmaps + (&entry - entries) * (MAX_WIDTH / 8) * height; }
+    static uint32_t hashText(const char* text, size_t length);
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstring>
+#include <esp_heap_caps.h>
+
+// Tampon circulaire d'enregistrements, sans verrou, multi-producteurs /
+// consommateur unique. Chaque enregistrement est précédé d'un mot d'en-tête
+// de 32 bits (longueur + bit de validation) aligné sur 4 octets.
+// Les producteurs réservent leur place par CAS puis publient l'en-tête ;
+// le consommateur s'arrête au premier enregistrement non publié.
+class LogRingBuffer {
+public:
+    LogRingBuffer() : m_buffer(nullptr), m_capacity(0), m_head(0), m_tail(0),
+                      m_dropped(0), m_dropped_bytes(0), m_high_watermark(0) {}
+    
+    ~LogRingBuffer() {
+        if (m_buffer) heap_caps_free(m_buffer);
+    }
+    
+    // capacity doit être une puissance de 2 ; PSRAM si disponible
+    bool allocate(size_t capacity) {
+        if (m_buffer || capacity < 64 || (capacity & (capacity - 1)) != 0) {
+            return m_buffer != nullptr;
+        }
+        m_buffer = static_cast<uint8_t*>(heap_caps_malloc(capacity, MALLOC_CAP_SPIRAM));
+        if (!m_buffer) {
+            m_buffer = static_cast<uint8_t*>(heap_caps_malloc(capacity, MALLOC_CAP_8BIT));
+        }
+        if (!m_buffer) return false;
+        
+        memset(m_buffer, 0, capacity);
+        m_capacity = capacity;
+        return true;
+    }
+    
+    // Producteur : retourne false (et compte la perte) si le tampon est plein
+    bool push(const uint8_t* data, size_t length) {
+        if (!m_buffer) return false;
+        
+        const uint32_t needed = HEADER_SIZE + align(length);
+        if (length == 0 || length > MAX_RECORD || needed > m_capacity / 2) {
+            recordDrop(length);
+            return false;
+        }
+        
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        do {
+            uint32_t used = head + needed - m_tail.load(std::memory_order_acquire);
+            if (used > m_capacity) {
+                recordDrop(length);
+                return false;
+            }
+        } while (!m_head.compare_exchange_weak(head, head + needed,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed));
+        
+        copyIn(head + HEADER_SIZE, data, length);
+        
+        // Publier l'enregistrement en dernier
+        uint32_t* header = reinterpret_cast<uint32_t*>(m_buffer + (head & (m_capacity - 1)));
+        __atomic_store_n(header, (uint32_t)length | COMMIT_FLAG, __ATOMIC_RELEASE);
+        
+        uint32_t used = head + needed - m_tail.load(std::memory_order_relaxed);
+        uint32_t mark = m_high_watermark.load(std::memory_order_relaxed);
+        while (used > mark &&
+               !m_high_watermark.compare_exchange_weak(mark, used, std::memory_order_relaxed)) {}
+        return true;
+    }
+    
+    // Consommateur : copie des enregistrements complets dans out,
+    // sans en-têtes, tant qu'ils tiennent dans max_length octets
+    // (et dans la limite de max_records enregistrements)
+    size_t pop(uint8_t* out, size_t max_length, size_t max_records = SIZE_MAX) {
+        if (!m_buffer) return 0;
+        
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t written = 0;
+        
+        for (size_t records = 0; records < max_records; records++) {
+            uint32_t* header = reinterpret_cast<uint32_t*>(m_buffer + (tail & (m_capacity - 1)));
+            uint32_t value = __atomic_load_n(header, __ATOMIC_ACQUIRE);
+            if (!(value & COMMIT_FLAG)) break;
+            
+            uint32_t length = value & ~COMMIT_FLAG;
+            if (written + length > max_length) break;
+            
+            copyOut(out + written, tail + HEADER_SIZE, length);
+            written += length;
+            
+            // Remettre la zone à zéro : tout mot peut devenir un en-tête
+            uint32_t record = HEADER_SIZE + align(length);
+            clear(tail, record);
+            tail += record;
+        }
+        
+        m_tail.store(tail, std::memory_order_release);
+        return written;
+    }
+    
+    // Consommateur : copie le premier enregistrement sans le retirer ;
+    // 0 si aucun n'est publié ou s'il ne tient pas dans max_length
+    size_t peek(uint8_t* out, size_t max_length) const {
+        if (!m_buffer) return 0;
+        
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint32_t* header = reinterpret_cast<const uint32_t*>(m_buffer + (tail & (m_capacity - 1)));
+        uint32_t value = __atomic_load_n(header, __ATOMIC_ACQUIRE);
+        if (!(value & COMMIT_FLAG)) return 0;
+        
+        uint32_t length = value & ~COMMIT_FLAG;
+        if (length > max_length) return 0;
+        copyOut(out, tail + HEADER_SIZE, length);
+        return length;
+    }
+    
+    // Consommateur : retire le premier enregistrement (après peek)
+    void discard() {
+        if (!m_buffer) return;
+        
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t* header = reinterpret_cast<uint32_t*>(m_buffer + (tail & (m_capacity - 1)));
+        uint32_t value = __atomic_load_n(header, __ATOMIC_ACQUIRE);
+        if (!(value & COMMIT_FLAG)) return;
+        
+        uint32_t record = HEADER_SIZE + align(value & ~COMMIT_FLAG);
+        clear(tail, record);
+        m_tail.store(tail + record, std::memory_order_release);
+    }
+    
+    size_t used() const {
+        return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed);
+    }
+    
+    size_t capacity() const { return m_capacity; }
+    uint32_t droppedRecords() const { return m_dropped.load(std::memory_order_relaxed); }
+    uint32_t droppedBytes() const { return m_dropped_bytes.load(std::memory_order_relaxed); }
+    uint32_t highWatermark() const { return m_high_watermark.load(std::memory_order_relaxed); }
+    
+    static const size_t HEADER_SIZE = 4;
+    static const size_t MAX_RECORD = 4096;
+    
+private:
+    static const uint32_t COMMIT_FLAG = 0x80000000u;
+    
+    uint8_t* m_buffer;
+    uint32_t m_capacity;
+    std::atomic<uint32_t> m_head;
+    std::atomic<uint32_t> m_tail;
+    std::atomic<uint32_t> m_dropped;
+    std::atomic<uint32_t> m_dropped_bytes;
+    std::atomic<uint32_t> m_high_watermark;
+    
+    static uint32_t align(size_t length) {
+        return (length + 3) & ~3u;
+    }
+    
+    void recordDrop(size_t length) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        m_dropped_bytes.fetch_add(length, std::memory_order_relaxed);
+    }
+    
+    void copyIn(uint32_t position, const uint8_t* data, size_t length) {
+        uint32_t offset = position & (m_capacity - 1);
+        size_t first = std::min<size_t>(length, m_capacity - offset);
+        memcpy(m_buffer + offset, data, first);
+        memcpy(m_buffer, data + first, length - first);
+    }
+    
+    void copyOut(uint8_t* out, uint32_t position, size_t length) const {
+        uint32_t offset = position & (m_capacity - 1);
+        size_t first = std::min<size_t>(length, m_capacity - offset);
+        memcpy(out, m_buffer + offset, first);
+        memcpy(out + first, m_buffer, length - first);
+    }
+    
+    void clear(uint32_t position, size_t length) {
+        uint32_t offset = position & (m_capacity - 1);
+        size_t first = std::min<size_t>(length, m_capacity - offset);
+        memset(m_buffer + offset, 0, first);
+        memset(m_buffer, 0, length - first);
+    }
+};
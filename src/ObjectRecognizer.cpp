@@ -1,5 +1,6 @@
 #include "ObjectRecognizer.h"
 #include "GeometryUtils.h"
+#include "performance/Trace.h"
 #include <cmath>
 #include <algorithm>
 #include <SPIFFS.h>
@@ -25,7 +26,8 @@ ObjectTemplate::ObjectTemplate(const String& n, const std::vector<Point>& c)
 }
 
 ObjectRecognizer::ObjectRecognizer()
-    : minConfidence(0.7f),
+    : jobs(nullptr),
+      minConfidence(0.7f),
       rotationInvariant(true),
       scaleInvariant(true) {}
 
@@ -42,47 +44,62 @@ void ObjectRecognizer::removeTemplate(const String& name) {
 }
 
 std::vector<ObjectMatch> ObjectRecognizer::recognizeObjects(const std::vector<Point>& points) {
+    TRACE_SCOPE("ObjectRecognizer::recognizeObjects");
+    
     std::vector<ObjectMatch> matches;
     if (points.size() < 3) return matches;
     
     std::vector<float> inputFeatures = extractFeatures(points);
     std::vector<Point> normalizedInput = normalizeContour(points);
     
+    // Un modèle par tranche : chacun écrit uniquement son propre résultat
+    std::vector<const ObjectTemplate*> candidates;
+    candidates.reserve(templates.size());
     for (const auto& templ : templates) {
-        ObjectMatch match;
-        match.name = templ.first;
-        
-        // Comparer les caractéristiques
-        float featureConfidence = compareFeatures(inputFeatures, templ.second.features);
-        
-        // Comparer les contours
-        float bestIOU = 0.0f;
-        float bestRotation = 0.0f;
-        std::vector<Point> bestPoints = normalizedInput;
-        
-        if (rotationInvariant) {
-            bestRotation = findBestRotation(normalizedInput, templ.second.contour);
-            bestPoints = rotatePoints(normalizedInput, bestRotation);
-        }
-        
-        if (scaleInvariant) {
-            float scaleX = templ.second.width / (maxX(bestPoints) - minX(bestPoints));
-            float scaleY = templ.second.height / (maxY(bestPoints) - minY(bestPoints));
-            float scale = (scaleX + scaleY) / 2.0f;
-            bestPoints = scalePoints(bestPoints, scale);
+        candidates.push_back(&templ.second);
+    }
+    std::vector<ObjectMatch> results(candidates.size());
+    
+    parallelFor(jobs, 0, candidates.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            const ObjectTemplate& templ = *candidates[i];
+            ObjectMatch& match = results[i];
+            match.name = templ.name;
+            
+            // Comparer les caractéristiques
+            float featureConfidence = compareFeatures(inputFeatures, templ.features);
+            
+            // Comparer les contours
+            float bestIOU = 0.0f;
+            float bestRotation = 0.0f;
+            std::vector<Point> bestPoints = normalizedInput;
+            
+            if (rotationInvariant) {
+                bestRotation = findBestRotation(normalizedInput, templ.contour);
+                bestPoints = rotatePoints(normalizedInput, bestRotation);
+            }
+            
+            if (scaleInvariant) {
+                float scaleX = templ.width / (maxX(bestPoints) - minX(bestPoints));
+                float scaleY = templ.height / (maxY(bestPoints) - minY(bestPoints));
+                float scale = (scaleX + scaleY) / 2.0f;
+                bestPoints = scalePoints(bestPoints, scale);
+            }
+            
+            bestIOU = calculateIOU(bestPoints, templ.contour);
+            
+            // Calculer la confiance finale
+            match.confidence = (featureConfidence + bestIOU) / 2.0f;
+            match.rotation = bestRotation;
         }
-        
-        bestIOU = calculateIOU(bestPoints, templ.second.contour);
-        
-        // Calculer la confiance finale
-        match.confidence = (featureConfidence + bestIOU) / 2.0f;
-        
+    });
+    
+    for (ObjectMatch& match : results) {
         if (match.confidence >= minConfidence) {
             // Calculer la position et les dimensions
             match.position = calculateCentroid(points);
             match.width = maxX(points) - minX(points);
             match.height = maxY(points) - minY(points);
-            match.rotation = bestRotation;
             matches.push_back(match);
         }
     }
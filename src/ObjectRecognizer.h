@@ -3,6 +3,7 @@
 #include <vector>
 #include <map>
 #include "Config.h"
+#include "performance/JobSystem.h"
 #include <ArduinoJson.h>
 
 struct ObjectTemplate {
@@ -32,6 +33,8 @@ class ObjectRecognizer {
 public:
     ObjectRecognizer();
     bool begin();
+    // Compare les modèles en parallèle ; nullptr : séquentiel
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
     void addTemplate(const String& name, const std::vector<Point>& contour);
     void removeTemplate(const String& name);
     std::vector<ObjectMatch> recognizeObjects(const std::vector<Point>& points);
@@ -44,6 +47,7 @@ public:
     
 private:
     std::map<String, ObjectTemplate> templates;
+    JobSystem* jobs;
     float minConfidence;
     bool rotationInvariant;
     bool scaleInvariant;
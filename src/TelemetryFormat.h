@@ -0,0 +1,181 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstring>
+#include "Config.h"
+
+// Format binaire des journaux de télémétrie (fichiers /logs/log_N.bin)
+//
+// En-tête de fichier (16 octets) :
+//   "HLT1" | version u8 | réservé u8[3] | epoch u32 | millis de référence u32
+// Enregistrement : en-tête fixe de 8 octets puis charge utile
+//   type u8 | niveau u8 | longueur u16 | horodatage millis u32
+// Charges utiles :
+//   FRAME     : confiance f32 | nb objets varint | nb points varint |
+//               points (dx, dy zigzag varint, delta avec le point précédent) |
+//               nb étiquettes varint | réf. varint (0 = en ligne : long. varint + octets)
+//   LABEL_DEF : id varint | texte
+//   MESSAGE   : texte (niveau dans l'en-tête)
+//   BATCH     : id unité u32 | séquence u32 | drapeaux u8 | trames perdues u32
+//               (en tête des paquets de TelemetryPublisher, qui suivent
+//               le même format qu'un fichier avec des étiquettes en ligne)
+// Tous les entiers sont little-endian. Décodeur hôte : scripts/decode_telemetry.py
+namespace TelemetryFormat {
+
+const uint8_t MAGIC[4] = {'H', 'L', 'T', '1'};
+const uint8_t VERSION = 1;
+const size_t FILE_HEADER_SIZE = 16;
+const size_t RECORD_HEADER_SIZE = 8;
+const size_t MAX_RECORD_SIZE = 1024;
+
+enum RecordType : uint8_t {
+    RECORD_FRAME = 1,
+    RECORD_LABEL_DEF = 2,
+    RECORD_MESSAGE = 3,
+    RECORD_BATCH = 4
+};
+
+const size_t BATCH_PAYLOAD_SIZE = 13;
+const uint8_t BATCH_FLAG_REPLAY = 0x01;
+
+enum MessageLevel : uint8_t {
+    LEVEL_INFO = 1,
+    LEVEL_DEBUG = 2,
+    LEVEL_ERROR = 3
+};
+
+inline void writeU16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+inline void writeU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+inline uint16_t readU16(const uint8_t* in) {
+    return in[0] | (in[1] << 8);
+}
+
+inline uint32_t readU32(const uint8_t* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Retourne le nombre d'octets écrits, 0 si la place manque
+inline size_t writeVarint(uint8_t* out, size_t capacity, uint32_t value) {
+    size_t n = 0;
+    do {
+        if (n >= capacity) return 0;
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[n++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return n;
+}
+
+// Retourne le nombre d'octets lus, 0 si la donnée est tronquée
+inline size_t readVarint(const uint8_t* in, size_t length, uint32_t& value) {
+    value = 0;
+    for (size_t n = 0; n < length && n < 5; n++) {
+        value |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if (!(in[n] & 0x80)) return n + 1;
+    }
+    return 0;
+}
+
+inline void writeFileHeader(uint8_t* out, uint32_t epoch, uint32_t millisBase) {
+    memcpy(out, MAGIC, 4);
+    out[4] = VERSION;
+    out[5] = out[6] = out[7] = 0;
+    writeU32(out + 8, epoch);
+    writeU32(out + 12, millisBase);
+}
+
+inline void writeRecordHeader(uint8_t* out, RecordType type, uint8_t level,
+                              uint16_t length, uint32_t timestamp) {
+    out[0] = type;
+    out[1] = level;
+    writeU16(out + 2, length);
+    writeU32(out + 4, timestamp);
+}
+
+// Encodeur séquentiel borné ; ok() devient faux au premier débordement
+class Writer {
+public:
+    Writer(uint8_t* buffer, size_t capacity) : m_buffer(buffer), m_capacity(capacity), m_size(0), m_ok(true) {}
+    
+    void varint(uint32_t value) {
+        if (!m_ok) return;
+        size_t n = writeVarint(m_buffer + m_size, m_capacity - m_size, value);
+        if (n == 0) m_ok = false;
+        m_size += n;
+    }
+    
+    void bytes(const void* data, size_t length) {
+        if (!m_ok || m_size + length > m_capacity) {
+            m_ok = false;
+            return;
+        }
+        memcpy(m_buffer + m_size, data, length);
+        m_size += length;
+    }
+    
+    void f32(float value) {
+        uint32_t raw;
+        memcpy(&raw, &value, 4);
+        uint8_t out[4];
+        writeU32(out, raw);
+        bytes(out, 4);
+    }
+    
+    size_t size() const { return m_size; }
+    bool ok() const { return m_ok; }
+    
+private:
+    uint8_t* m_buffer;
+    size_t m_capacity;
+    size_t m_size;
+    bool m_ok;
+};
+
+// Charge utile FRAME ; labelRef(label) retourne l'id du dictionnaire
+// ou 0 pour écrire l'étiquette en ligne
+template <typename LabelRef>
+inline bool encodeFrame(Writer& payload, const SensorData& data, LabelRef labelRef) {
+    payload.f32(data.confidence);
+    payload.varint(data.objectCount);
+    
+    // Points codés en delta avec le point précédent
+    payload.varint(data.points.size());
+    int lastX = 0, lastY = 0;
+    for (const auto& point : data.points) {
+        payload.varint(zigzag(point.x - lastX));
+        payload.varint(zigzag(point.y - lastY));
+        lastX = point.x;
+        lastY = point.y;
+    }
+    
+    payload.varint(data.labels.size());
+    for (const auto& label : data.labels) {
+        uint16_t id = labelRef(label);
+        payload.varint(id);
+        if (id == 0) {
+            payload.varint(label.length());
+            payload.bytes(label.c_str(), label.length());
+        }
+    }
+    
+    return payload.ok();
+}
+
+} // namespace TelemetryFormat
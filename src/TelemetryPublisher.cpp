@@ -0,0 +1,331 @@
+#include "TelemetryPublisher.h"
+#include <ArduinoJson.h>
+
+TelemetryPublisher::TelemetryPublisher() :
+    initialized(false),
+    useMqtt(false),
+    unitId(0),
+    batchSequence(0),
+    pendingFrames(0),
+    framesQueued(0),
+    spoolReadOffset(0),
+    spoolSize(0),
+    spoolAvailable(false),
+    packet(nullptr),
+    taskHandle(nullptr),
+    mqtt(tcpClient),
+    lastConnectAttempt(0),
+    lastBatchTime(0),
+    stats{} {}
+
+bool TelemetryPublisher::begin() {
+    if (!loadConfig()) {
+        return false;
+    }
+    return begin(config);
+}
+
+bool TelemetryPublisher::begin(const TelemetryPublisherConfig& newConfig) {
+    if (initialized) return true;
+    
+    config = newConfig;
+    if (!config.enabled || config.host.length() == 0 || config.batchFrames == 0) {
+        return false;
+    }
+    
+    useMqtt = (config.transport == "mqtt");
+    unitId = (uint32_t)ESP.getEfuseMac();
+    
+    if (!frames.allocate(FRAME_RING_SIZE) || !backlog.allocate(BACKLOG_SIZE)) {
+        return false;
+    }
+    
+    packet = static_cast<uint8_t*>(heap_caps_malloc(MAX_PACKET_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    if (!packet) {
+        return false;
+    }
+    
+    if (useMqtt) {
+        // setServer conserve le pointeur : config.host ne change plus ensuite
+        mqtt.setServer(config.host.c_str(), config.port);
+        mqtt.setBufferSize(MAX_PACKET_SIZE + 128);
+        mqtt.setSocketTimeout(2);
+    }
+    
+    // Paquets restés sur SD lors d'une session précédente : rejoués aussi
+    spoolAvailable = SD.cardType() != CARD_NONE;
+    if (spoolAvailable && SD.exists(SPOOL_FILE)) {
+        File spool = SD.open(SPOOL_FILE, FILE_READ);
+        if (spool) {
+            spoolSize = spool.size();
+            spool.close();
+        }
+    }
+    
+    // Tâche d'export basse priorité sur le core 0 (loop() tourne sur le core 1)
+    if (xTaskCreatePinnedToCore(publisherTask, "telemetry_pub", 6144, this, 1,
+                                &taskHandle, 0) != pdPASS) {
+        return false;
+    }
+    
+    initialized = true;
+    return true;
+}
+
+void TelemetryPublisher::publish(const SensorData& data) {
+    if (!initialized) return;
+    
+    // Seul travail côté boucle de vision : encoder et déposer la trame
+    using namespace TelemetryFormat;
+    uint8_t record[MAX_RECORD_SIZE];
+    Writer payload(record + RECORD_HEADER_SIZE, MAX_RECORD_SIZE - RECORD_HEADER_SIZE);
+    
+    // Étiquettes en ligne : chaque paquet se décode seul
+    if (!encodeFrame(payload, data, [](const String&) { return (uint16_t)0; })) {
+        return;
+    }
+    writeRecordHeader(record, RECORD_FRAME, LEVEL_INFO, payload.size(), data.timestamp);
+    
+    if (frames.push(record, RECORD_HEADER_SIZE + payload.size())) {
+        framesQueued++;
+        if (pendingFrames.fetch_add(1) + 1 >= config.batchFrames) {
+            xTaskNotifyGive(taskHandle);
+        }
+    }
+}
+
+TelemetryPublisherStats TelemetryPublisher::getStats() const {
+    TelemetryPublisherStats result = stats;
+    result.framesQueued = framesQueued.load();
+    result.framesDropped = frames.droppedRecords();
+    result.backlogBytes = backlog.used();
+    result.spoolBytes = spoolSize - spoolReadOffset;
+    return result;
+}
+
+bool TelemetryPublisher::loadConfig() {
+    if (!SPIFFS.exists("/telemetry.json")) {
+        return false;
+    }
+    
+    File file = SPIFFS.open("/telemetry.json", "r");
+    if (!file) {
+        return false;
+    }
+    
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error) {
+        return false;
+    }
+    
+    config.enabled = doc["enabled"] | false;
+    config.transport = doc["transport"] | "udp";
+    config.host = doc["host"] | "";
+    config.port = doc["port"] | (config.transport == "mqtt" ? 1883 : 5005);
+    config.topic = doc["topic"] | "huskylens/frames";
+    config.username = doc["username"] | "";
+    config.password = doc["password"] | "";
+    config.batchFrames = doc["batchFrames"] | 16;
+    config.batchIntervalMs = doc["batchIntervalMs"] | 500;
+    return true;
+}
+
+bool TelemetryPublisher::ensureConnected() {
+    if (WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
+    
+    if (!useMqtt || mqtt.connected()) {
+        return true;
+    }
+    
+    // Reconnexion MQTT espacée : connect() bloque jusqu'au délai de socket
+    if (millis() - lastConnectAttempt < RECONNECT_INTERVAL_MS) {
+        return false;
+    }
+    lastConnectAttempt = millis();
+    
+    String clientId = "huskylens-" + String(unitId, HEX);
+    if (config.username.length() > 0) {
+        return mqtt.connect(clientId.c_str(), config.username.c_str(), config.password.c_str());
+    }
+    return mqtt.connect(clientId.c_str());
+}
+
+bool TelemetryPublisher::sendPacket(const uint8_t* data, size_t length) {
+    if (useMqtt) {
+        return mqtt.publish(config.topic.c_str(), data, length);
+    }
+    
+    if (!udp.beginPacket(config.host.c_str(), config.port)) {
+        return false;
+    }
+    if (udp.write(data, length) != length) {
+        return false;
+    }
+    return udp.endPacket();
+}
+
+size_t TelemetryPublisher::buildPacket() {
+    using namespace TelemetryFormat;
+    
+    // Enregistrements FRAME complets, directement à leur place dans le paquet
+    size_t length = frames.pop(packet + PACKET_PREFIX_SIZE, MAX_PACKET_SIZE - PACKET_PREFIX_SIZE,
+                               config.batchFrames);
+    if (length == 0) {
+        return 0;
+    }
+    
+    uint32_t count = 0;
+    for (size_t offset = 0; offset + RECORD_HEADER_SIZE <= length; count++) {
+        offset += RECORD_HEADER_SIZE + readU16(packet + PACKET_PREFIX_SIZE + offset + 2);
+    }
+    pendingFrames.fetch_sub(std::min(count, pendingFrames.load()));
+    
+    uint32_t now = millis();
+    writeFileHeader(packet, (uint32_t)time(nullptr), now);
+    writeRecordHeader(packet + FILE_HEADER_SIZE, RECORD_BATCH, LEVEL_INFO, BATCH_PAYLOAD_SIZE, now);
+    
+    uint8_t* batch = packet + FILE_HEADER_SIZE + RECORD_HEADER_SIZE;
+    writeU32(batch, unitId);
+    writeU32(batch + 4, ++batchSequence);
+    batch[8] = 0;
+    writeU32(batch + 9, frames.droppedRecords());
+    
+    return PACKET_PREFIX_SIZE + length;
+}
+
+void TelemetryPublisher::storeOffline(const uint8_t* data, size_t length) {
+    stats.packetsBuffered++;
+    
+    // RAM d'abord ; dès que la SD est utilisée, elle reçoit la suite
+    // pour que le rejeu (RAM puis SD) reste dans l'ordre
+    if (spoolSize == 0 && backlog.push(data, length)) {
+        return;
+    }
+    
+    if (spoolAvailable && spoolSize + 2 + length <= MAX_SPOOL_SIZE) {
+        File spool = SD.open(SPOOL_FILE, FILE_APPEND);
+        if (spool) {
+            uint8_t prefix[2];
+            TelemetryFormat::writeU16(prefix, length);
+            bool ok = spool.write(prefix, 2) == 2 && spool.write(data, length) == length;
+            spool.close();
+            if (ok) {
+                spoolSize += 2 + length;
+                return;
+            }
+        }
+    }
+    
+    stats.packetsLost++;
+}
+
+void TelemetryPublisher::replayBacklog() {
+    using namespace TelemetryFormat;
+    const size_t flagOffset = FILE_HEADER_SIZE + RECORD_HEADER_SIZE + 8;
+    
+    for (size_t i = 0; i < REPLAY_PER_CYCLE; i++) {
+        // Lecture sans retrait : le paquet ne quitte l'attente qu'une fois envoyé
+        bool fromSpool = false;
+        size_t length = backlog.peek(packet, MAX_PACKET_SIZE);
+        if (length == 0 && spoolSize > 0) {
+            length = readSpooledPacket(packet);
+            fromSpool = true;
+        }
+        if (length <= flagOffset) {
+            return;
+        }
+        
+        packet[flagOffset] |= BATCH_FLAG_REPLAY;
+        
+        if (!sendPacket(packet, length)) {
+            // Le paquet reste en tête d'attente (RAM ou SD) : ordre conservé
+            stats.packetsFailed++;
+            return;
+        }
+        
+        if (fromSpool) {
+            consumeSpooledPacket(length);
+        } else {
+            backlog.discard();
+        }
+        stats.packetsReplayed++;
+        stats.packetsSent++;
+    }
+}
+
+size_t TelemetryPublisher::readSpooledPacket(uint8_t* out) {
+    File spool = SD.open(SPOOL_FILE, FILE_READ);
+    if (!spool) {
+        spoolSize = spoolReadOffset = 0;
+        return 0;
+    }
+    
+    uint8_t prefix[2];
+    size_t length = 0;
+    if (spool.seek(spoolReadOffset) && spool.read(prefix, 2) == 2) {
+        length = TelemetryFormat::readU16(prefix);
+        if (length > MAX_PACKET_SIZE || spool.read(out, length) != (int)length) {
+            length = 0;
+        }
+    }
+    spool.close();
+    
+    // Fichier tronqué ou corrompu : abandon du reste
+    if (length == 0) {
+        SD.remove(SPOOL_FILE);
+        spoolSize = spoolReadOffset = 0;
+    }
+    return length;
+}
+
+void TelemetryPublisher::consumeSpooledPacket(size_t length) {
+    spoolReadOffset += 2 + length;
+    if (spoolReadOffset >= spoolSize) {
+        SD.remove(SPOOL_FILE);
+        spoolSize = spoolReadOffset = 0;
+    }
+}
+
+void TelemetryPublisher::runCycle() {
+    bool online = ensureConnected();
+    if (useMqtt && online) {
+        mqtt.loop();
+    }
+    
+    // Lots complets dès qu'ils sont prêts, lot partiel à l'échéance T
+    bool flushAll = millis() - lastBatchTime >= config.batchIntervalMs;
+    while (pendingFrames.load() >= (flushAll ? 1u : config.batchFrames)) {
+        size_t length = buildPacket();
+        if (length == 0) break;
+        lastBatchTime = millis();
+        
+        if (online && sendPacket(packet, length)) {
+            stats.packetsSent++;
+        } else {
+            if (online) {
+                stats.packetsFailed++;
+                online = false;
+            }
+            storeOffline(packet, length);
+        }
+    }
+    
+    if (online) {
+        replayBacklog();
+    }
+    stats.online = online;
+}
+
+void TelemetryPublisher::publisherTask(void* parameter) {
+    TelemetryPublisher* publisher = static_cast<TelemetryPublisher*>(parameter);
+    
+    while (true) {
+        // Réveil sur lot complet ou à l'échéance de l'intervalle
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(publisher->config.batchIntervalMs));
+        publisher->runCycle();
+    }
+}
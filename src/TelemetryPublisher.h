@@ -0,0 +1,113 @@
+#pragma once
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <PubSubClient.h>
+#include <SD.h>
+#include <SPIFFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include "Config.h"
+#include "LogRingBuffer.h"
+#include "TelemetryFormat.h"
+
+// Configuration de l'export (/telemetry.json sur SPIFFS)
+struct TelemetryPublisherConfig {
+    bool enabled;
+    String transport;          // "mqtt" ou "udp"
+    String host;
+    uint16_t port;
+    String topic;              // MQTT uniquement
+    String username;
+    String password;
+    uint16_t batchFrames;      // Envoi dès N trames...
+    uint32_t batchIntervalMs;  // ... ou au plus tard après T ms
+    
+    TelemetryPublisherConfig() :
+        enabled(false),
+        transport("udp"),
+        port(5005),
+        topic("huskylens/frames"),
+        batchFrames(16),
+        batchIntervalMs(500) {}
+};
+
+struct TelemetryPublisherStats {
+    uint32_t framesQueued;
+    uint32_t framesDropped;     // Tampon de trames plein
+    uint32_t packetsSent;
+    uint32_t packetsFailed;
+    uint32_t packetsBuffered;   // Mis en attente hors ligne (RAM ou SD)
+    uint32_t packetsReplayed;
+    uint32_t packetsLost;       // Attente hors ligne saturée
+    size_t backlogBytes;
+    size_t spoolBytes;
+    bool online;
+};
+
+// Export des trames vers un collecteur (MQTT ou UDP brut).
+// publish() ne fait qu'encoder la trame dans un tampon sans verrou ;
+// une tâche dédiée sur le core 0 regroupe les trames en paquets au format
+// TelemetryFormat (en-tête de fichier + BATCH + FRAME), les envoie, et les
+// conserve hors ligne (RAM puis SD, tailles bornées) pour les rejouer.
+class TelemetryPublisher {
+public:
+    TelemetryPublisher();
+    bool begin();
+    bool begin(const TelemetryPublisherConfig& config);
+    void publish(const SensorData& data);
+    TelemetryPublisherConfig getConfig() const { return config; }
+    TelemetryPublisherStats getStats() const;
+
+private:
+    static const size_t FRAME_RING_SIZE = 16 * 1024;
+    static const size_t BACKLOG_SIZE = 64 * 1024;
+    static const size_t MAX_SPOOL_SIZE = 512 * 1024;
+    static const size_t MAX_PACKET_SIZE = 1400;     // Tient dans une trame Ethernet
+    static const size_t PACKET_PREFIX_SIZE =
+        TelemetryFormat::FILE_HEADER_SIZE + TelemetryFormat::RECORD_HEADER_SIZE +
+        TelemetryFormat::BATCH_PAYLOAD_SIZE;
+    static const size_t REPLAY_PER_CYCLE = 8;       // Rejeu amorti entre deux lots
+    static const uint32_t RECONNECT_INTERVAL_MS = 5000;
+    const char* SPOOL_FILE = "/telemetry_spool.bin";
+    
+    TelemetryPublisherConfig config;
+    bool initialized;
+    bool useMqtt;
+    uint32_t unitId;
+    uint32_t batchSequence;
+    
+    // Trames encodées par la boucle de vision, consommées par la tâche
+    LogRingBuffer frames;
+    std::atomic<uint32_t> pendingFrames;
+    std::atomic<uint32_t> framesQueued;
+    
+    // Paquets en attente d'envoi (hors ligne), puis débordement sur SD
+    LogRingBuffer backlog;
+    size_t spoolReadOffset;
+    size_t spoolSize;
+    bool spoolAvailable;
+    
+    uint8_t* packet;
+    TaskHandle_t taskHandle;
+    WiFiUDP udp;
+    WiFiClient tcpClient;
+    PubSubClient mqtt;
+    unsigned long lastConnectAttempt;
+    unsigned long lastBatchTime;
+    
+    // Écrites par la tâche d'export uniquement (mots de 32 bits)
+    TelemetryPublisherStats stats;
+    
+    bool loadConfig();
+    bool ensureConnected();
+    bool sendPacket(const uint8_t* data, size_t length);
+    size_t buildPacket();
+    void storeOffline(const uint8_t* data, size_t length);
+    void replayBacklog();
+    size_t readSpooledPacket(uint8_t* out);
+    void consumeSpooledPacket(size_t length);
+    void runCycle();
+    static void publisherTask(void* parameter);
+};
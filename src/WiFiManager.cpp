@@ -1,6 +1,24 @@
 #include "WiFiManager.h"
 
-WiFiManager::WiFiManager() : server(80), apMode(false), connected(false) {}
+WiFiManager::WiFiManager() :
+    server(80),
+    ws("/ws"),
+    ws3d("/3d-ws"),
+    events("/api/data"),
+    assetHandler(staticAssets),
+    clientsMutex(xSemaphoreCreateMutex()),
+    streamStats{},
+    lastFrameTime(0),
+    lastCleanup(0),
+    streamFps(0.0f),
+    frameSequence(0),
+    apMode(false),
+    connected(false),
+    linkState(*this),
+    linkEvents(xQueueCreate(8, sizeof(WiFiLinkEvent))),
+    eventHandlerId(0),
+    lastDisconnectReason(0)
+{}
 
 bool WiFiManager::begin(const char* ssid, const char* password) {
     if (!SPIFFS.begin(true)) {
@@ -14,6 +32,16 @@ bool WiFiManager::begin(const char* ssid, const char* password) {
         loadCredentials();
     }
     
+    WiFiTiming timing;
+    timing.jitterSeed = (uint32_t)ESP.getEfuseMac();
+    linkState.setTiming(timing);
+    
+    // Les événements arrivent depuis la tâche système Wi-Fi
+    eventHandlerId = WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+        onWiFiEvent(event, info);
+    });
+    WiFi.setAutoReconnect(false);
+    
     if (currentSSID.length() > 0) {
         startClient();
     } else {
@@ -25,56 +53,127 @@ bool WiFiManager::begin(const char* ssid, const char* password) {
 }
 
 void WiFiManager::startAP() {
-    WiFi.mode(WIFI_AP);
+    linkState.start(false, millis());
+    apMode = true;
+}
+
+void WiFiManager::startClient() {
+    // Ne bloque pas : l'issue de la tentative est traitée dans update()
+    WiFi.mode(WIFI_STA);
+    linkState.start(true, millis());
+}
+
+void WiFiManager::onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    WiFiLinkEvent linkEvent;
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        linkEvent = WiFiLinkEvent::GOT_IP;
+    } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        lastDisconnectReason = info.wifi_sta_disconnected.reason;
+        linkEvent = WiFiLinkEvent::DISCONNECTED;
+    } else {
+        return;
+    }
+    xQueueSend(linkEvents, &linkEvent, 0);
+}
+
+void WiFiManager::beginConnect() {
+    WiFi.enableSTA(true);
+    WiFi.begin(currentSSID.c_str(), currentPassword.c_str());
+    Serial.println("Connexion à " + currentSSID + "...");
+}
+
+void WiFiManager::disconnect() {
+    WiFi.disconnect(false);
+}
+
+void WiFiManager::startAccessPoint() {
+    // softAP() ajoute le mode AP au mode courant (AP+STA si une connexion est en cours)
     String apName = "HuskyLens_" + String((uint32_t)ESP.getEfuseMac(), HEX);
     WiFi.softAP(apName.c_str(), "huskyconfig");
-    apMode = true;
     
     IPAddress IP = WiFi.softAPIP();
     Serial.print("AP IP address: ");
     Serial.println(IP);
 }
 
-void WiFiManager::startClient() {
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(currentSSID.c_str(), currentPassword.c_str());
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-        connected = true;
-        Serial.println("\nConnecté à " + currentSSID);
-        Serial.println("IP: " + WiFi.localIP().toString());
-    } else {
-        startAP();
-    }
+void WiFiManager::stopAccessPoint() {
+    WiFi.softAPdisconnect(true);
+    Serial.println("Point d'accès fermé");
 }
 
 void WiFiManager::setupWebServer() {
-    // Page d'accueil
-    server.on("/", HTTP_GET, [this](AsyncWebServerRequest *request){
-        request->send(SPIFFS, "/index.html", "text/html");
-    });
+    scheduler.begin();
     
     // API pour la configuration
-    server.on("/api/config", HTTP_GET, [this](AsyncWebServerRequest *request){
+    server.on("/api/config", HTTP_GET, scheduler.limit([this](AsyncWebServerRequest *request){
         DynamicJsonDocument doc(1024);
         doc["ssid"] = currentSSID;
         doc["connected"] = connected;
+        doc["state"] = WiFiStateMachine::stateName(linkState.getState());
         
         String response;
         serializeJson(doc, response);
         request->send(200, "application/json", response);
-    });
+    }));
+    
+    // État de la connexion Wi-Fi pour l'interface
+    server.on("/api/wifi/status", HTTP_GET, scheduler.limit([this](AsyncWebServerRequest *request){
+        unsigned long now = millis();
+        DynamicJsonDocument doc(512);
+        doc["state"] = WiFiStateMachine::stateName(linkState.getState());
+        doc["ssid"] = currentSSID;
+        doc["ip"] = getIPAddress();
+        doc["rssi"] = linkState.isConnected() ? WiFi.RSSI() : 0;
+        doc["apActive"] = linkState.isAccessPointActive();
+        doc["failedAttempts"] = linkState.getFailedAttempts();
+        doc["reconnects"] = linkState.getReconnects();
+        doc["retryInMs"] = linkState.getRetryInMs(now);
+        doc["stateAgeMs"] = linkState.getStateAgeMs(now);
+        doc["lastDisconnectReason"] = lastDisconnectReason;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    }));
+    
+    // Flux temps réel (WebSocket + SSE sur /api/data)
+    setupStreaming();
+    
+    server.on("/api/stream", HTTP_GET, scheduler.limit([this](AsyncWebServerRequest *request){
+        StreamStats stats = getStreamStats();
+        DynamicJsonDocument doc(256);
+        doc["clients"] = stats.clients;
+        doc["framesSerialized"] = stats.framesSerialized;
+        doc["framesSkipped"] = stats.framesSkipped;
+        doc["framesCoalesced"] = stats.framesCoalesced;
+        doc["bytesSerialized"] = stats.bytesSerialized;
+        doc["binaryClients"] = stats.binaryClients;
+        doc["keyframesSent"] = stats.keyframesSent;
+        doc["deltasSent"] = stats.deltasSent;
+        doc["fps"] = streamFps;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    }));
     
-    // API pour recevoir les données en temps réel
-    server.on("/api/data", HTTP_GET, [this](AsyncWebServerRequest *request){
-        request->send(200, "text/event-stream", "retry: 10000\n");
+    // Répartition des requêtes API (limites de débit, file de travail)
+    server.on("/api/scheduler", HTTP_GET, [this](AsyncWebServerRequest *request){
+        RequestSchedulerStats stats = scheduler.getStats();
+        DynamicJsonDocument doc(384);
+        doc["admitted"] = stats.admitted;
+        doc["rateLimited"] = stats.rateLimited;
+        doc["rejectedBusy"] = stats.rejectedBusy;
+        doc["deferred"] = stats.deferred;
+        doc["completed"] = stats.completed;
+        doc["cancelled"] = stats.cancelled;
+        doc["queued"] = stats.queued;
+        doc["maxRunMs"] = stats.maxRunMs;
+        doc["clients"] = stats.clients;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
     });
     
     // Configuration WiFi
@@ -94,11 +193,90 @@ void WiFiManager::setupWebServer() {
     });
     
     // Fichiers statiques
-    server.serveStatic("/", SPIFFS, "/");
+    setupStaticAssets();
     
     server.begin();
 }
 
+void WiFiManager::setupStaticAssets() {
+    if (loadAssetIndex()) {
+        server.addHandler(&assetHandler);
+        Serial.printf("%u ressources web pré-compressées\n", (unsigned)staticAssets.size());
+        return;
+    }
+    
+    // Image SPIFFS construite directement depuis data/ (sans manifeste)
+    server.on("/", HTTP_GET, [this](AsyncWebServerRequest *request){
+        request->send(SPIFFS, "/index.html", "text/html");
+    });
+    server.serveStatic("/", SPIFFS, "/");
+}
+
+bool WiFiManager::loadAssetIndex() {
+    File index = SPIFFS.open("/assets.idx", "r");
+    if (!index) {
+        return false;
+    }
+    
+    // url<TAB>fichier<TAB>etag<TAB>type<TAB>immutable
+    while (index.available()) {
+        String line = index.readStringUntil('\n');
+        int tab1 = line.indexOf('\t');
+        int tab2 = line.indexOf('\t', tab1 + 1);
+        int tab3 = line.indexOf('\t', tab2 + 1);
+        int tab4 = line.indexOf('\t', tab3 + 1);
+        if (tab1 <= 0 || tab2 < 0 || tab3 < 0 || tab4 < 0) {
+            continue;
+        }
+        
+        StaticAsset asset;
+        asset.file = line.substring(tab1 + 1, tab2);
+        asset.etag = "\"" + line.substring(tab2 + 1, tab3) + "\"";
+        asset.contentType = line.substring(tab3 + 1, tab4);
+        asset.immutable = line.charAt(tab4 + 1) == '1';
+        staticAssets[line.substring(0, tab1)] = asset;
+    }
+    index.close();
+    
+    return !staticAssets.empty();
+}
+
+const StaticAsset* StaticAssetHandler::find(const String& url) const {
+    auto it = assets.find(url == "/" ? String("/index.html") : url);
+    return it != assets.end() ? &it->second : nullptr;
+}
+
+bool StaticAssetHandler::canHandle(AsyncWebServerRequest* request) {
+    if (request->method() != HTTP_GET || !find(request->url())) {
+        return false;
+    }
+    request->addInterestingHeader("If-None-Match");
+    return true;
+}
+
+void StaticAssetHandler::handleRequest(AsyncWebServerRequest* request) {
+    const StaticAsset* asset = find(request->url());
+    if (!asset) {
+        request->send(404);
+        return;
+    }
+    
+    // Revalidation : ETag comparé en mémoire, aucune lecture en flash
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match").indexOf(asset->etag) >= 0) {
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse(SPIFFS, asset->file, asset->contentType);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", asset->immutable ?
+                        "public, max-age=31536000, immutable" : "no-cache");
+    request->send(response);
+}
+
 void WiFiManager::loadCredentials() {
     if (SPIFFS.exists("/wifi.json")) {
         File file = SPIFFS.open("/wifi.json", "r");
@@ -124,23 +302,226 @@ void WiFiManager::saveCredentials() {
 }
 
 void WiFiManager::update() {
-    if (!apMode && WiFi.status() != WL_CONNECTED) {
-        connected = false;
-        if (currentSSID.length() > 0) {
-            startClient();
+    unsigned long now = millis();
+    
+    WiFiLinkEvent event;
+    while (xQueueReceive(linkEvents, &event, 0) == pdTRUE) {
+        linkState.handleEvent(event, now);
+    }
+    linkState.tick(now);
+    
+    bool wasConnected = connected;
+    connected = linkState.isConnected();
+    apMode = linkState.isAccessPointActive();
+    
+    if (connected && !wasConnected) {
+        Serial.println("Connecté à " + currentSSID);
+        Serial.println("IP: " + WiFi.localIP().toString());
+    } else if (!connected && wasConnected) {
+        Serial.println("Connexion perdue (raison " + String(lastDisconnectReason) + ")");
+    }
+}
+
+WiFiLinkState WiFiManager::getLinkState() const {
+    return linkState.getState();
+}
+
+void WiFiManager::setupStreaming() {
+    auto handler = [this](AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                          void* arg, uint8_t* data, size_t len) {
+        onSocketEvent(socket, client, type, arg, data, len);
+    };
+    ws.onEvent(handler);
+    ws3d.onEvent(handler);
+    
+    events.onConnect([](AsyncEventSourceClient* client) {
+        client->send("connected", nullptr, millis(), 1000);
+    });
+    
+    server.addHandler(&ws);
+    server.addHandler(&ws3d);
+    server.addHandler(&events);
+}
+
+void WiFiManager::onSocketEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                                void* arg, uint8_t* data, size_t len) {
+    // Appelé depuis la tâche async_tcp : seul l'index des clients est modifié ici
+    std::map<uint32_t, ClientState>& clients = (socket == &ws3d) ? ws3dClients : wsClients;
+    
+    if (type == WS_EVT_CONNECT) {
+        xSemaphoreTake(clientsMutex, portMAX_DELAY);
+        clients[client->id()] = ClientState{0, 0, false, false, 0, 0};
+        xSemaphoreGive(clientsMutex);
+    } else if (type == WS_EVT_DISCONNECT) {
+        xSemaphoreTake(clientsMutex, portMAX_DELAY);
+        clients.erase(client->id());
+        xSemaphoreGive(clientsMutex);
+    } else if (type == WS_EVT_DATA) {
+        // Seules les commandes texte tenant dans une seule trame sont traitées
+        AwsFrameInfo* info = static_cast<AwsFrameInfo*>(arg);
+        if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
+            handleSocketCommand(clients, client->id(), data, len);
+        }
+    }
+}
+
+void WiFiManager::handleSocketCommand(std::map<uint32_t, ClientState>& clients, uint32_t clientId,
+                                      const uint8_t* data, size_t len) {
+    StaticJsonDocument<128> doc;
+    if (deserializeJson(doc, data, len)) {
+        return;
+    }
+    
+    String command = doc["command"] | "";
+    
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    auto it = clients.find(clientId);
+    if (it != clients.end()) {
+        if (command == "protocol") {
+            String value = doc["value"] | "json";
+            it->second.binary = (value == "binary");
+            it->second.hasFrame = false;
+            it->second.labelsKnown = 0;
+        } else if (command == "keyframe") {
+            // Le client a détecté un trou de séquence
+            it->second.hasFrame = false;
+        }
+    }
+    xSemaphoreGive(clientsMutex);
+}
+
+bool WiFiManager::hasStreamClients() const {
+    return ws.count() + ws3d.count() + events.count() > 0;
+}
+
+uint32_t WiFiManager::internLabel(const String& label) {
+    String key = label.length() > MAX_LABEL_LENGTH ? label.substring(0, MAX_LABEL_LENGTH) : label;
+    
+    auto it = labelIds.find(key);
+    if (it != labelIds.end()) {
+        return it->second;
+    }
+    
+    uint32_t id = labelTable.size();
+    labelIds[key] = id;
+    labelTable.push_back(key);
+    return id;
+}
+
+bool WiFiManager::sendLabelTable(AsyncWebSocketClient* client, ClientState& state) {
+    while (state.labelsKnown < labelTable.size()) {
+        if (client->queueIsFull()) {
+            return false;
+        }
+        
+        size_t end;
+        size_t length = WireProtocol::encodeLabels(encodeScratch, sizeof(encodeScratch),
+                                                   labelTable, state.labelsKnown, end);
+        if (length == 0 || end == state.labelsKnown) {
+            return false;
+        }
+        
+        client->binary(encodeScratch, length);
+        state.labelsKnown = end;
+    }
+    return true;
+}
+
+size_t WiFiManager::broadcastFrame(AsyncWebSocket& socket, std::map<uint32_t, ClientState>& clients,
+                                   const FrameBuffers& buffers) {
+    size_t sent = 0;
+    
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    for (auto& entry : clients) {
+        ClientState& state = entry.second;
+        AsyncWebSocketClient* client = socket.client(entry.first);
+        if (!client || client->status() != WS_CONNECTED) {
+            continue;
+        }
+        
+        // Client lent : on saute la trame, il recevra la plus récente
+        // dès que sa file se sera vidée (seule la dernière trame compte).
+        // En binaire, sa séquence n'avance pas : il repartira d'une KEYFRAME.
+        if (client->queueIsFull()) {
+            state.framesCoalesced++;
+            streamStats.framesCoalesced++;
+            continue;
+        }
+        
+        if (!state.binary) {
+            if (buffers.json) {
+                client->text(buffers.json);
+                state.framesSent++;
+                sent++;
+            }
+            continue;
+        }
+        
+        if (!buffers.keyframe || !sendLabelTable(client, state) || client->queueIsFull()) {
+            state.framesCoalesced++;
+            streamStats.framesCoalesced++;
+            continue;
+        }
+        
+        bool useDelta = buffers.delta && state.hasFrame && state.lastSequence + 1 == frameSequence;
+        client->binary(useDelta ? buffers.delta : buffers.keyframe);
+        if (useDelta) {
+            streamStats.deltasSent++;
         } else {
-            startAP();
+            streamStats.keyframesSent++;
         }
+        
+        state.hasFrame = true;
+        state.lastSequence = frameSequence;
+        state.framesSent++;
+        sent++;
     }
+    xSemaphoreGive(clientsMutex);
+    
+    return sent;
 }
 
-void WiFiManager::sendData(const SensorData& data) {
-    if (!connected) return;
+AsyncWebSocketMessageBuffer* WiFiManager::makeSharedBuffer(const uint8_t* data, size_t length) {
+    AsyncWebSocketMessageBuffer* buffer = new AsyncWebSocketMessageBuffer(const_cast<uint8_t*>(data), length);
+    if (!buffer->get()) {
+        delete buffer;
+        return nullptr;
+    }
+    buffer->lock();
+    streamStats.bytesSerialized += length;
+    return buffer;
+}
+
+void WiFiManager::retainBuffer(AsyncWebSocketMessageBuffer* buffer) {
+    if (!buffer) return;
     
+    buffer->unlock();
+    if (buffer->canDelete()) {
+        delete buffer;
+    } else {
+        pendingBuffers.push_back(buffer);
+    }
+}
+
+void WiFiManager::releaseBuffers() {
+    // Un tampon partagé est libéré quand plus aucune file ne le référence
+    for (auto it = pendingBuffers.begin(); it != pendingBuffers.end();) {
+        if ((*it)->canDelete()) {
+            delete *it;
+            it = pendingBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+AsyncWebSocketMessageBuffer* WiFiManager::encodeJsonFrame(const SensorData& data, unsigned long now) {
     DynamicJsonDocument doc(2048);
     doc["timestamp"] = data.timestamp;
     doc["objectCount"] = data.objectCount;
     doc["confidence"] = data.confidence;
+    doc["fps"] = streamFps;
+    doc["latency"] = now - data.timestamp;
     
     JsonArray points = doc.createNestedArray("points");
     for (const auto& point : data.points) {
@@ -154,11 +535,143 @@ void WiFiManager::sendData(const SensorData& data) {
         labels.add(label);
     }
     
-    String output;
-    serializeJson(doc, output);
+    // Sérialisation directe dans le tampon partagé
+    size_t length = measureJson(doc);
+    AsyncWebSocketMessageBuffer* buffer = new AsyncWebSocketMessageBuffer(length);
+    if (!buffer->get()) {
+        delete buffer;
+        return nullptr;
+    }
+    serializeJson(doc, reinterpret_cast<char*>(buffer->get()), length + 1);
+    buffer->lock();
+    streamStats.bytesSerialized += length;
+    return buffer;
+}
+
+void WiFiManager::sendData(const SensorData& data) {
+    if (!connected) return;
+    
+    unsigned long now = millis();
+    if (lastFrameTime > 0 && now > lastFrameTime) {
+        float instantFps = 1000.0f / (now - lastFrameTime);
+        streamFps = streamFps * 0.9f + instantFps * 0.1f;
+    }
+    lastFrameTime = now;
+    
+    if (now - lastCleanup >= CLEANUP_INTERVAL_MS) {
+        ws.cleanupClients(MAX_STREAM_CLIENTS);
+        ws3d.cleanupClients(MAX_STREAM_CLIENTS);
+        lastCleanup = now;
+    }
+    releaseBuffers();
+    
+    // Aucun client : pas de sérialisation du tout
+    if (!hasStreamClients()) {
+        streamStats.framesSkipped++;
+        return;
+    }
+    
+    // Encodages nécessaires selon les protocoles négociés
+    bool needJson = events.count() > 0;
+    bool needBinary = false;
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    for (auto* clients : {&wsClients, &ws3dClients}) {
+        for (const auto& entry : *clients) {
+            if (entry.second.binary) {
+                needBinary = true;
+            } else {
+                needJson = true;
+            }
+        }
+    }
+    xSemaphoreGive(clientsMutex);
+    
+    FrameBuffers buffers = {nullptr, nullptr, nullptr};
+    
+    if (needJson) {
+        buffers.json = encodeJsonFrame(data, now);
+    }
+    
+    if (needBinary) {
+        frameSequence++;
+        
+        // Table pleine : on repart de zéro, chaque client la recevra à nouveau
+        if (labelTable.size() + data.labels.size() > WireProtocol::MAX_LABELS) {
+            labelIds.clear();
+            labelTable.clear();
+            xSemaphoreTake(clientsMutex, portMAX_DELAY);
+            for (auto* clients : {&wsClients, &ws3dClients}) {
+                for (auto& entry : *clients) {
+                    entry.second.labelsKnown = 0;
+                }
+            }
+            xSemaphoreGive(clientsMutex);
+        }
+        
+        std::vector<uint32_t> ids;
+        ids.reserve(data.labels.size());
+        for (const auto& label : data.labels) {
+            ids.push_back(internLabel(label));
+        }
+        
+        WireProtocol::FrameHeader header;
+        header.sequence = frameSequence;
+        header.timestamp = data.timestamp;
+        header.confidence = (uint32_t)(constrain(data.confidence, 0.0f, 1.0f) * 1000.0f);
+        header.objectCount = data.objectCount > 0 ? data.objectCount : 0;
+        header.fps = (uint32_t)(streamFps * 10.0f);
+        header.latency = now > data.timestamp ? now - data.timestamp : 0;
+        
+        size_t length = WireProtocol::encodeFrame(encodeScratch, sizeof(encodeScratch),
+                                                  WireProtocol::MSG_KEYFRAME, header,
+                                                  data.points, previousPoints, ids);
+        if (length > 0) {
+            buffers.keyframe = makeSharedBuffer(encodeScratch, length);
+        }
+        
+        length = WireProtocol::encodeFrame(encodeScratch, sizeof(encodeScratch),
+                                           WireProtocol::MSG_DELTA, header,
+                                           data.points, previousPoints, ids);
+        if (length > 0) {
+            buffers.delta = makeSharedBuffer(encodeScratch, length);
+        }
+        
+        previousPoints = data.points;
+    }
+    
+    streamStats.framesSerialized++;
+    
+    broadcastFrame(ws, wsClients, buffers);
+    broadcastFrame(ws3d, ws3dClients, buffers);
+    
+    // SSE : toujours en JSON, coalescé si les files des clients débordent
+    if (buffers.json && events.count() > 0) {
+        if (events.avgPacketsWaiting() < CLIENT_QUEUE_LIMIT) {
+            events.send(reinterpret_cast<const char*>(buffers.json->get()), "frame", streamStats.framesSerialized);
+        } else {
+            streamStats.framesCoalesced++;
+        }
+    }
+    
+    retainBuffer(buffers.json);
+    retainBuffer(buffers.keyframe);
+    retainBuffer(buffers.delta);
+}
+
+StreamStats WiFiManager::getStreamStats() const {
+    StreamStats stats = streamStats;
+    stats.clients = ws.count() + ws3d.count() + events.count();
+    stats.binaryClients = 0;
+    
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    for (auto* clients : {&wsClients, &ws3dClients}) {
+        for (const auto& entry : *clients) {
+            if (entry.second.binary) stats.binaryClients++;
+        }
+    }
+    xSemaphoreGive(clientsMutex);
     
-    // Envoyer à tous les clients connectés via WebSocket
-    // TODO: Implémenter WebSocket
+    return stats;
 }
 
 bool WiFiManager::isConnected() const {
@@ -6,9 +6,47 @@
 #include <AsyncTCP.h>
 #include <ESPAsyncWebSrv.h>
 #include <ArduinoJson.h>
+#include <map>
+#include <vector>
 #include "Config.h"
+#include "WireProtocol.h"
+#include "WiFiStateMachine.h"
+#include "middleware/RequestScheduler.h"
 
-class WiFiManager {
+// Statistiques du flux temps réel (WebSocket + SSE)
+struct StreamStats {
+    uint32_t clients;            // Clients WebSocket + SSE connectés
+    uint32_t framesSerialized;   // Trames sérialisées (une fois par trame)
+    uint32_t framesSkipped;      // Trames ignorées faute de client
+    uint32_t framesCoalesced;    // Envois sautés pour des clients saturés
+    uint32_t bytesSerialized;
+    uint32_t binaryClients;      // Clients ayant négocié le protocole binaire
+    uint32_t keyframesSent;
+    uint32_t deltasSent;
+};
+
+// Ressource web préparée par scripts/compress_assets.py (/assets.idx)
+struct StaticAsset {
+    String file;         // Fichier .gz sur SPIFFS
+    String etag;         // Déjà entre guillemets
+    String contentType;
+    bool immutable;      // Nom haché : mise en cache sans revalidation
+};
+
+// Sert les ressources pré-compressées avec ETag et revalidation (304) ;
+// les en-têtes non déclarés ici sont écartés par le serveur avant traitement
+class StaticAssetHandler : public AsyncWebHandler {
+public:
+    explicit StaticAssetHandler(const std::map<String, StaticAsset>& assets) : assets(assets) {}
+    bool canHandle(AsyncWebServerRequest* request) override;
+    void handleRequest(AsyncWebServerRequest* request) override;
+
+private:
+    const std::map<String, StaticAsset>& assets;
+    const StaticAsset* find(const String& url) const;
+};
+
+class WiFiManager : private WiFiDriver {
 public:
     WiFiManager();
     bool begin(const char* ssid = nullptr, const char* password = nullptr);
@@ -19,16 +57,88 @@ public:
     void handleClient();
     bool isConnected() const;
     String getIPAddress() const;
+    WiFiLinkState getLinkState() const;
     void sendData(const SensorData& data);
+    StreamStats getStreamStats() const;
+    
+    // Limite de débit et tâche ouvrière partagées par les routes de l'API
+    RequestScheduler& getScheduler() { return scheduler; }
     
 private:
+    // Taille max d'une file d'envoi par client (doit rester alignée avec
+    // WS_MAX_QUEUED_MESSAGES dans platformio.ini)
+    static constexpr size_t CLIENT_QUEUE_LIMIT = 4;
+    static constexpr size_t MAX_STREAM_CLIENTS = 4;
+    static constexpr unsigned long CLEANUP_INTERVAL_MS = 1000;
+    static constexpr size_t MAX_LABEL_LENGTH = 64;
+    
+    struct ClientState {
+        uint32_t framesSent;
+        uint32_t framesCoalesced;
+        bool binary;             // Protocole négocié (JSON par défaut)
+        bool hasFrame;           // Base valide pour un DELTA
+        uint32_t lastSequence;   // Dernière trame reçue par ce client
+        size_t labelsKnown;      // Entrées de la table d'étiquettes déjà envoyées
+    };
+    
+    // Encodages de la trame courante, produits une seule fois et partagés
+    struct FrameBuffers {
+        AsyncWebSocketMessageBuffer* json;
+        AsyncWebSocketMessageBuffer* keyframe;
+        AsyncWebSocketMessageBuffer* delta;
+    };
+    
     AsyncWebServer server;
+    AsyncWebSocket ws;          // Tableau de bord principal (/ws)
+    AsyncWebSocket ws3d;        // Visualisation 3D (/3d-ws)
+    AsyncEventSource events;    // Flux SSE (/api/data)
+    
+    // Ressources statiques, indexées par URL
+    std::map<String, StaticAsset> staticAssets;
+    StaticAssetHandler assetHandler;
+    RequestScheduler scheduler;
+    
+    // Clients suivis par socket ; modifiés depuis la tâche async_tcp
+    std::map<uint32_t, ClientState> wsClients;
+    std::map<uint32_t, ClientState> ws3dClients;
+    SemaphoreHandle_t clientsMutex;
+    
+    // Tampons de trame partagés encore référencés par des files d'envoi
+    std::vector<AsyncWebSocketMessageBuffer*> pendingBuffers;
+    StreamStats streamStats;
+    unsigned long lastFrameTime;
+    unsigned long lastCleanup;
+    float streamFps;
+    
+    // État du protocole binaire
+    uint32_t frameSequence;
+    std::vector<Point> previousPoints;
+    std::map<String, uint32_t> labelIds;
+    std::vector<String> labelTable;
+    uint8_t encodeScratch[WireProtocol::MAX_MESSAGE_SIZE];
+    
     bool apMode;
     bool connected;
     String currentSSID;
     String currentPassword;
     
+    // Connexion non bloquante : les événements Wi-Fi (tâche système) sont
+    // transmis par file à la machine d'états, avancée depuis update()
+    WiFiStateMachine linkState;
+    QueueHandle_t linkEvents;
+    wifi_event_id_t eventHandlerId;
+    volatile uint8_t lastDisconnectReason;
+    
+    // WiFiDriver
+    void beginConnect() override;
+    void disconnect() override;
+    void startAccessPoint() override;
+    void stopAccessPoint() override;
+    void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+    
     void setupWebServer();
+    void setupStaticAssets();
+    bool loadAssetIndex();
     void handleRoot();
     void handleConfig();
     void handleData();
@@ -36,6 +146,21 @@ private:
     void loadCredentials();
     void saveCredentials();
     
+    void setupStreaming();
+    void onSocketEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                       void* arg, uint8_t* data, size_t len);
+    void handleSocketCommand(std::map<uint32_t, ClientState>& clients, uint32_t clientId,
+                             const uint8_t* data, size_t len);
+    size_t broadcastFrame(AsyncWebSocket& socket, std::map<uint32_t, ClientState>& clients,
+                          const FrameBuffers& buffers);
+    bool sendLabelTable(AsyncWebSocketClient* client, ClientState& state);
+    bool hasStreamClients() const;
+    uint32_t internLabel(const String& label);
+    AsyncWebSocketMessageBuffer* encodeJsonFrame(const SensorData& data, unsigned long now);
+    AsyncWebSocketMessageBuffer* makeSharedBuffer(const uint8_t* data, size_t length);
+    void retainBuffer(AsyncWebSocketMessageBuffer* buffer);
+    void releaseBuffers();
+    
     static String getContentType(const String& filename);
     static void sendCORS();
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "WiFiStateMachine.h"
+
+WiFiStateMachine::WiFiStateMachine(WiFiDriver& driver, const WiFiTiming& timing) :
+    m_driver(driver),
+    m_timing(timing),
+    m_state(WiFiLinkState::IDLE),
+    m_stateSince(0),
+    m_retryAt(0),
+    m_failedAttempts(0),
+    m_reconnects(0),
+    m_apActive(false),
+    m_everConnected(false)
+{}
+
+void WiFiStateMachine::start(bool hasCredentials, uint32_t now) {
+    m_failedAttempts = 0;
+
+    if (!hasCredentials) {
+        if (!m_apActive) {
+            m_driver.startAccessPoint();
+            m_apActive = true;
+        }
+        enter(WiFiLinkState::AP_ONLY, now);
+        return;
+    }
+
+    connect(now);
+}
+
+void WiFiStateMachine::stop() {
+    m_driver.disconnect();
+    if (m_apActive) {
+        m_driver.stopAccessPoint();
+        m_apActive = false;
+    }
+    m_state = WiFiLinkState::IDLE;
+}
+
+void WiFiStateMachine::handleEvent(WiFiLinkEvent event, uint32_t now) {
+    switch (event) {
+        case WiFiLinkEvent::GOT_IP:
+            if (m_state == WiFiLinkState::CONNECTING || m_state == WiFiLinkState::BACKOFF) {
+                if (m_everConnected) {
+                    m_reconnects++;
+                }
+                m_everConnected = true;
+                m_failedAttempts = 0;
+                if (m_apActive) {
+                    m_driver.stopAccessPoint();
+                    m_apActive = false;
+                }
+                enter(WiFiLinkState::CONNECTED, now);
+            }
+            break;
+
+        case WiFiLinkEvent::DISCONNECTED:
+            // Le pilote signale aussi l'échec d'une tentative par DISCONNECTED
+            if (m_state == WiFiLinkState::CONNECTED) {
+                scheduleRetry(now);
+            } else if (m_state == WiFiLinkState::CONNECTING) {
+                m_failedAttempts++;
+                scheduleRetry(now);
+            }
+            break;
+    }
+}
+
+void WiFiStateMachine::tick(uint32_t now) {
+    switch (m_state) {
+        case WiFiLinkState::CONNECTING:
+            if (now - m_stateSince >= m_timing.connectTimeoutMs) {
+                m_failedAttempts++;
+                m_driver.disconnect();
+                scheduleRetry(now);
+            }
+            break;
+
+        case WiFiLinkState::BACKOFF:
+            if ((int32_t)(now - m_retryAt) >= 0) {
+                connect(now);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+uint32_t WiFiStateMachine::getRetryInMs(uint32_t now) const {
+    if (m_state != WiFiLinkState::BACKOFF || (int32_t)(m_retryAt - now) <= 0) {
+        return 0;
+    }
+    return m_retryAt - now;
+}
+
+const char* WiFiStateMachine::stateName(WiFiLinkState state) {
+    switch (state) {
+        case WiFiLinkState::IDLE: return "idle";
+        case WiFiLinkState::CONNECTING: return "connecting";
+        case WiFiLinkState::CONNECTED: return "connected";
+        case WiFiLinkState::BACKOFF: return "backoff";
+        case WiFiLinkState::AP_ONLY: return "ap";
+    }
+    return "unknown";
+}
+
+void WiFiStateMachine::enter(WiFiLinkState state, uint32_t now) {
+    m_state = state;
+    m_stateSince = now;
+}
+
+void WiFiStateMachine::connect(uint32_t now) {
+    m_driver.beginConnect();
+    enter(WiFiLinkState::CONNECTING, now);
+}
+
+void WiFiStateMachine::scheduleRetry(uint32_t now) {
+    if (m_failedAttempts >= m_timing.apFallbackAttempts && !m_apActive) {
+        m_driver.startAccessPoint();
+        m_apActive = true;
+    }
+
+    m_retryAt = now + backoffDelay();
+    enter(WiFiLinkState::BACKOFF, now);
+}
+
+uint32_t WiFiStateMachine::backoffDelay() const {
+    // Perte de lien après connexion : première relance rapide
+    uint32_t delay = m_timing.initialBackoffMs;
+    for (uint32_t i = 1; i < m_failedAttempts && delay < m_timing.maxBackoffMs; i++) {
+        delay *= 2;
+    }
+    if (delay > m_timing.maxBackoffMs) {
+        delay = m_timing.maxBackoffMs;
+    }
+
+    // Gigue déterministe jusqu'à +25 % pour étaler les unités d'un même AP
+    uint32_t hash = (m_timing.jitterSeed + m_failedAttempts + 1) * 2654435761u;
+    uint32_t jitterRange = delay / 4;
+    if (jitterRange > 0) {
+        delay += (hash >> 8) % jitterRange;
+    }
+    return delay;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+// Machine d'états de connexion Wi-Fi, sans dépendance Arduino :
+// l'accès radio passe par WiFiDriver et le temps est fourni par l'appelant,
+// ce qui permet de la piloter sur l'hôte avec un pilote simulé.
+//
+//   IDLE ──start()──> CONNECTING ──GOT_IP──> CONNECTED
+//                        │  ▲                    │
+//          échec/timeout │  │ délai écoulé       │ DISCONNECTED
+//                        ▼  │                    ▼
+//                       BACKOFF <────────────────┘
+//
+// Après apFallbackAttempts échecs consécutifs le point d'accès de
+// configuration est ouvert (AP+STA) et les tentatives continuent au délai
+// maximal ; il est refermé dès que la connexion est rétablie.
+
+enum class WiFiLinkState : uint8_t {
+    IDLE,
+    CONNECTING,
+    CONNECTED,
+    BACKOFF,
+    AP_ONLY      // Aucun identifiant : point d'accès de configuration seul
+};
+
+enum class WiFiLinkEvent : uint8_t {
+    GOT_IP,
+    DISCONNECTED
+};
+
+class WiFiDriver {
+public:
+    virtual ~WiFiDriver() = default;
+    virtual void beginConnect() = 0;
+    virtual void disconnect() = 0;
+    virtual void startAccessPoint() = 0;
+    virtual void stopAccessPoint() = 0;
+};
+
+struct WiFiTiming {
+    uint32_t connectTimeoutMs = 10000;
+    uint32_t initialBackoffMs = 1000;
+    uint32_t maxBackoffMs = 60000;
+    uint32_t apFallbackAttempts = 5;
+    uint32_t jitterSeed = 0;    // Décorrèle les reconnexions de plusieurs unités
+};
+
+class WiFiStateMachine {
+public:
+    explicit WiFiStateMachine(WiFiDriver& driver, const WiFiTiming& timing = WiFiTiming());
+
+    void setTiming(const WiFiTiming& timing) { m_timing = timing; }
+    void start(bool hasCredentials, uint32_t now);
+    void stop();
+    void handleEvent(WiFiLinkEvent event, uint32_t now);
+    void tick(uint32_t now);
+
+    WiFiLinkState getState() const { return m_state; }
+    bool isConnected() const { return m_state == WiFiLinkState::CONNECTED; }
+    bool isAccessPointActive() const { return m_apActive; }
+    uint32_t getFailedAttempts() const { return m_failedAttempts; }
+    uint32_t getReconnects() const { return m_reconnects; }
+    uint32_t getRetryInMs(uint32_t now) const;
+    uint32_t getStateAgeMs(uint32_t now) const { return now - m_stateSince; }
+
+    static const char* stateName(WiFiLinkState state);
+
+private:
+    WiFiDriver& m_driver;
+    WiFiTiming m_timing;
+    WiFiLinkState m_state;
+    uint32_t m_stateSince;
+    uint32_t m_retryAt;
+    uint32_t m_failedAttempts;
+    uint32_t m_reconnects;
+    bool m_apActive;
+    bool m_everConnected;
+
+    void enter(WiFiLinkState state, uint32_t now);
+    void connect(uint32_t now);
+    void scheduleRetry(uint32_t now);
+    uint32_t backoffDelay() const;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include "Config.h"
+#include "TelemetryFormat.h"
+
+// Protocole binaire du flux temps réel (WebSocket /ws et /3d-ws)
+//
+// Négociation : le client envoie {"command":"protocol","value":"binary"}
+// après connexion ; sans cela il reste en JSON. {"command":"keyframe"}
+// demande une trame complète (perte détectée côté client).
+// Message : type u8 puis champs en varint LEB128
+//   LABELS   : index de départ | nombre | (longueur | octets UTF-8)*
+//              (départ 0 = la table du client est réinitialisée)
+//   KEYFRAME : séquence | horodatage ms | confiance ‰ | nb objets |
+//              fps x10 | latence ms | nb points |
+//              points (x, y zigzag absolus) | nb étiquettes | id*
+//   DELTA    : comme KEYFRAME, points en zigzag relatifs au point de
+//              même rang de la trame séquence - 1 (0 si absent)
+// Un DELTA n'est envoyé qu'à un client ayant reçu la trame précédente.
+// Décodeur navigateur : data/wire.js
+namespace WireProtocol {
+
+const size_t MAX_LABELS = 256;
+const size_t MAX_MESSAGE_SIZE = 1024;
+
+enum MessageType : uint8_t {
+    MSG_LABELS = 1,
+    MSG_KEYFRAME = 2,
+    MSG_DELTA = 3
+};
+
+struct FrameHeader {
+    uint32_t sequence;
+    uint32_t timestamp;
+    uint32_t confidence;    // pour mille
+    uint32_t objectCount;
+    uint32_t fps;           // x10
+    uint32_t latency;       // ms
+};
+
+// Retourne la taille encodée, 0 si le message ne tient pas
+inline size_t encodeFrame(uint8_t* out, size_t capacity, MessageType type,
+                          const FrameHeader& header,
+                          const std::vector<Point>& points,
+                          const std::vector<Point>& previous,
+                          const std::vector<uint32_t>& labelIds) {
+    TelemetryFormat::Writer writer(out, capacity);
+    uint8_t typeByte = type;
+    writer.bytes(&typeByte, 1);
+    writer.varint(header.sequence);
+    writer.varint(header.timestamp);
+    writer.varint(header.confidence);
+    writer.varint(header.objectCount);
+    writer.varint(header.fps);
+    writer.varint(header.latency);
+
+    writer.varint(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        Point reference;
+        if (type == MSG_DELTA && i < previous.size()) {
+            reference = previous[i];
+        }
+        writer.varint(TelemetryFormat::zigzag(points[i].x - reference.x));
+        writer.varint(TelemetryFormat::zigzag(points[i].y - reference.y));
+    }
+
+    writer.varint(labelIds.size());
+    for (uint32_t id : labelIds) {
+        writer.varint(id);
+    }
+
+    return writer.ok() ? writer.size() : 0;
+}
+
+// Encode autant d'entrées que possible à partir de start ;
+// end reçoit l'index de la première entrée non encodée
+inline size_t encodeLabels(uint8_t* out, size_t capacity,
+                           const std::vector<String>& labels,
+                           size_t start, size_t& end) {
+    // Réserve type + départ + nombre (varints de 2 octets max pour 256 entrées)
+    const size_t prefix = 5;
+    size_t payload = 0;
+    end = start;
+    while (end < labels.size()) {
+        size_t length = labels[end].length();
+        size_t entry = length + (length < 128 ? 1 : 2);
+        if (prefix + payload + entry > capacity) break;
+        payload += entry;
+        end++;
+    }
+
+    TelemetryFormat::Writer writer(out, capacity);
+    uint8_t typeByte = MSG_LABELS;
+    writer.bytes(&typeByte, 1);
+    writer.varint(start);
+    writer.varint(end - start);
+    for (size_t i = start; i < end; i++) {
+        writer.varint(labels[i].length());
+        writer.bytes(labels[i].c_str(), labels[i].length());
+    }
+
+    return writer.ok() ? writer.size() : 0;
+}
+
+} // namespace WireProtocol
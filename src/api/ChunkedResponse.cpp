@@ -0,0 +1,104 @@
+#include "ChunkedResponse.h"
+
+AsyncWebServerResponse* ChunkedResponse::beginJsonArray(AsyncWebServerRequest* request,
+                                                        const String& prefix,
+                                                        const String& suffix,
+                                                        RecordSource source) {
+    // Phases : préfixe, éléments séparés par des virgules, suffixe
+    auto phase = std::make_shared<int>(0);
+    auto first = std::make_shared<bool>(true);
+    
+    return begin(request, "application/json",
+        [=](String& record) {
+            if (*phase == 0) {
+                *phase = 1;
+                record = prefix;
+                return true;
+            }
+            
+            if (*phase == 1) {
+                String element;
+                if (source(element)) {
+                    if (!*first) record = ",";
+                    record += element;
+                    *first = false;
+                    return true;
+                }
+                *phase = 2;
+                record = suffix;
+                return true;
+            }
+            
+            return false;
+        });
+}
+
+AsyncWebServerResponse* ChunkedResponse::beginCsv(AsyncWebServerRequest* request,
+                                                  const String& header,
+                                                  RecordSource source,
+                                                  const String& filename) {
+    auto headerSent = std::make_shared<bool>(false);
+    
+    AsyncWebServerResponse* response = begin(request, "text/csv",
+        [=](String& record) {
+            if (!*headerSent) {
+                *headerSent = true;
+                record = header + "\n";
+                return true;
+            }
+            
+            if (!source(record)) {
+                return false;
+            }
+            record += "\n";
+            return true;
+        });
+    
+    if (filename.length() > 0) {
+        response->addHeader("Content-Disposition", "attachment; filename=\"" + filename + "\"");
+    }
+    return response;
+}
+
+AsyncWebServerResponse* ChunkedResponse::begin(AsyncWebServerRequest* request,
+                                               const String& contentType,
+                                               RecordSource source) {
+    auto state = std::make_shared<StreamState>();
+    state->source = source;
+    state->offset = 0;
+    state->finished = false;
+    
+    // L'état vit aussi longtemps que la réponse (capture du shared_ptr)
+    return request->beginChunkedResponse(contentType,
+        [state](uint8_t* buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            return fill(*state, buffer, maxLen);
+        });
+}
+
+size_t ChunkedResponse::fill(StreamState& state, uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    
+    while (written < maxLen) {
+        if (state.offset >= state.pending.length()) {
+            if (state.finished) {
+                break;
+            }
+            
+            // Le String garde sa capacité : pas de réallocation en régime établi
+            state.pending = "";
+            state.offset = 0;
+            if (!state.source(state.pending)) {
+                state.finished = true;
+            }
+            continue;
+        }
+        
+        size_t count = std::min(maxLen - written, (size_t)(state.pending.length() - state.offset));
+        memcpy(buffer + written, state.pending.c_str() + state.offset, count);
+        written += count;
+        state.offset += count;
+    }
+    
+    // 0 octet termine la réponse
+    return written;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ESPAsyncWebSrv.h>
+#include <functional>
+#include <memory>
+
+// Réponses HTTP produites à la demande (Transfer-Encoding: chunked).
+// Le serveur appelle le remplisseur chaque fois que la fenêtre TCP le
+// permet ; on y formate quelques enregistrements directement depuis la
+// source (tampon d'historique, fichier), sans jamais construire le corps
+// complet en RAM. Mémoire par requête : un enregistrement en attente plus
+// l'état du curseur de la source.
+class ChunkedResponse {
+public:
+    // Formate le prochain enregistrement dans record (remis à vide avant
+    // chaque appel) ; retourne false quand la source est épuisée
+    using RecordSource = std::function<bool(String& record)>;
+    
+    // {prefix}[rec1,rec2,...]{suffix} ; prefix se termine par l'ouverture du tableau
+    static AsyncWebServerResponse* beginJsonArray(AsyncWebServerRequest* request,
+                                                  const String& prefix,
+                                                  const String& suffix,
+                                                  RecordSource source);
+    
+    // En-tête CSV puis une ligne par enregistrement
+    static AsyncWebServerResponse* beginCsv(AsyncWebServerRequest* request,
+                                            const String& header,
+                                            RecordSource source,
+                                            const String& filename = "");
+    
+private:
+    struct StreamState {
+        RecordSource source;
+        String pending;
+        size_t offset;
+        bool finished;
+    };
+    
+    static AsyncWebServerResponse* begin(AsyncWebServerRequest* request,
+                                         const String& contentType,
+                                         RecordSource source);
+    static size_t fill(StreamState& state, uint8_t* buffer, size_t maxLen);
+};
@@ -1,69 +1,124 @@
 #include "PerformanceRoutes.h"
+#include "../performance/Trace.h"
 #include <ArduinoJson.h>
+#include <algorithm>
 
-void PerformanceRoutes::registerRoutes(AsyncWebServer& server, PerformanceManager& performanceManager) {
+void PerformanceRoutes::registerRoutes(AsyncWebServer& server, PerformanceManager& performanceManager,
+                                       RequestScheduler& scheduler) {
     // Métriques en temps réel
     server.on("/api/performance/metrics", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleGetMetrics(request, performanceManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     // Optimisation système
     server.on("/api/performance/optimize", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
-            handleOptimize(request, performanceManager);
-        }
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleOptimize(request, performanceManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
     );
     
     // Équilibrage de charge
     server.on("/api/performance/balance", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
-            handleBalanceLoad(request, performanceManager);
-        }
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleBalanceLoad(request, performanceManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
     );
     
     // Gestion du cache
     server.on("/api/performance/clear-cache", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleClearCache(request, performanceManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
+    );
+    
+    server.on("/api/performance/cache/benchmark", HTTP_POST,
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleCacheBenchmark(request, performanceManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
+    );
+    
+    // Profil du tas : fragmentation, allocations par trame, fuites suspectes
+    server.on("/api/performance/heap", HTTP_GET,
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleGetHeap(request, performanceManager);
+        }, RequestScheduler::COST_LIGHT)
+    );
+    
+    server.on("/api/performance/heap/tracking", HTTP_POST,
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            bool enable = !request->hasParam("enable", true) ||
+                          request->getParam("enable", true)->value() != "false";
+            bool success = performanceManager.setAllocationTracking(enable);
+            sendJsonResponse(request, success, !success ? "Suivi des allocations indisponible" :
+                             enable ? "Suivi des allocations actif" : "Suivi des allocations arrêté");
+        }, RequestScheduler::COST_LIGHT)
+    );
+    
+    server.on("/api/performance/heap/snapshot", HTTP_POST,
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleHeapSnapshot(request, performanceManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
+    );
+    
+    server.on("/api/performance/heap/diff", HTTP_GET,
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleHeapDiff(request, performanceManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
     );
     
     // Contrôle des tâches
     server.on("/api/performance/task", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleTaskControl(request, performanceManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     // Données historiques
     server.on("/api/performance/history", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleGetHistoricalData(request, performanceManager);
-        }
+        }, RequestScheduler::COST_STREAM)
     );
     
     // Export des données
     server.on("/api/performance/export", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleExportData(request, performanceManager);
-        }
+        }, RequestScheduler::COST_STREAM)
     );
     
     // Réinitialisation
     server.on("/api/performance/reset", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
-            handleReset(request, performanceManager);
-        }
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleReset(request, performanceManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
+    );
+
+#ifdef TRACE_ENABLED
+    // Trace Chrome des portées instrumentées (chrome://tracing, ui.perfetto.dev)
+    server.on("/api/performance/trace", HTTP_GET,
+        scheduler.limit([](AsyncWebServerRequest* request) {
+            handleGetTrace(request);
+        }, RequestScheduler::COST_STREAM)
+    );
+    
+    server.on("/api/performance/trace/clear", HTTP_POST,
+        scheduler.limit([](AsyncWebServerRequest* request) {
+            Trace::clear();
+            sendJsonResponse(request, true, "Trace vidée");
+        }, RequestScheduler::COST_LIGHT)
     );
+#endif
 }
 
 void PerformanceRoutes::handleGetMetrics(AsyncWebServerRequest* request, 
                                        PerformanceManager& performanceManager) {
     PerformanceMetrics metrics = performanceManager.getMetrics();
+    CpuReport cpu = performanceManager.getCpuReport();
     
-    DynamicJsonDocument doc(1024);
+    DynamicJsonDocument doc(5120 + cpu.tasks.size() * 128);
     doc["cpu_usage"] = metrics.cpu_usage;
     doc["memory_usage"] = metrics.memory_usage;
     doc["fps"] = metrics.fps;
@@ -71,6 +126,44 @@ void PerformanceRoutes::handleGetMetrics(AsyncWebServerRequest* request,
     doc["free_heap"] = metrics.free_heap;
     doc["min_free_heap"] = metrics.min_free_heap;
     
+    // Charge par cœur et par tâche sur le dernier intervalle
+    JsonArray cores = doc.createNestedArray("cores");
+    cores.add(cpu.core[0]);
+    cores.add(cpu.core[1]);
+    doc["cpu_interval_us"] = cpu.intervalUs;
+    
+    JsonArray tasks = doc.createNestedArray("tasks");
+    for (const auto& task : cpu.tasks) {
+        JsonObject entry = tasks.createNestedObject();
+        entry["name"] = (const char*)task.name;
+        entry["core"] = task.core;
+        entry["priority"] = task.priority;
+        entry["usage"] = task.usage;
+        entry["stack_free"] = task.stackHighWater;
+    }
+    
+    // Historique compact : [horodatage, cœur 0, cœur 1]
+    CpuLoadSample samples[60];
+    size_t sampleCount = performanceManager.readCpuHistory(samples, 60);
+    JsonArray cpuHistory = doc.createNestedArray("cpu_history");
+    for (size_t i = 0; i < sampleCount; i++) {
+        JsonArray sample = cpuHistory.createNestedArray();
+        sample.add(samples[i].timestamp);
+        sample.add(samples[i].core[0]);
+        sample.add(samples[i].core[1]);
+    }
+    
+    CacheStats cacheStats = performanceManager.getCacheStats();
+    JsonObject cache = doc.createNestedObject("cache");
+    cache["entries"] = cacheStats.entries;
+    cache["bytes"] = cacheStats.bytes;
+    cache["capacity"] = cacheStats.capacityBytes;
+    cache["hits"] = cacheStats.hits;
+    cache["misses"] = cacheStats.misses;
+    cache["evictions"] = cacheStats.evictions;
+    cache["expirations"] = cacheStats.expirations;
+    cache["rejected"] = cacheStats.rejected;
+    
     // Ajouter les avertissements
     JsonArray warnings = doc.createNestedArray("warnings");
     for (const auto& warning : performanceManager.getWarnings()) {
@@ -83,18 +176,59 @@ void PerformanceRoutes::handleGetMetrics(AsyncWebServerRequest* request,
 }
 
 void PerformanceRoutes::handleOptimize(AsyncWebServerRequest* request,
-                                     PerformanceManager& performanceManager) {
-    performanceManager.optimizeCPU();
-    performanceManager.optimizeMemory();
-    
-    sendJsonResponse(request, true, "Système optimisé");
+                                     PerformanceManager& performanceManager,
+                                     RequestScheduler& scheduler) {
+    scheduler.defer(request, RequestScheduler::PRIORITY_LOW, [&performanceManager](String& body) {
+        performanceManager.optimizeCPU();
+        performanceManager.optimizeMemory();
+        body = jsonMessage(true, "Système optimisé");
+    });
 }
 
 void PerformanceRoutes::handleBalanceLoad(AsyncWebServerRequest* request,
-                                        PerformanceManager& performanceManager) {
-    performanceManager.balanceLoad();
-    sendJsonResponse(request, true, "Charge équilibrée");
+                                        PerformanceManager& performanceManager,
+                                        RequestScheduler& scheduler) {
+    scheduler.defer(request, RequestScheduler::PRIORITY_LOW, [&performanceManager](String& body) {
+        LoadBalanceReport report = performanceManager.balanceLoad();
+        
+        // success : quelque chose a réellement été déplacé
+        DynamicJsonDocument doc(256);
+        doc["success"] = report.changed;
+        doc["message"] = !report.available ? "Aucun rééquilibrage possible : JobSystem non rattaché" :
+                         report.changed ? "Répartition ajustée" : "Aucun rééquilibrage nécessaire";
+        doc["core0"] = report.core[0];
+        doc["core1"] = report.core[1];
+        doc["participants"] = report.participants;
+        doc["pinned"] = report.pinned;
+        serializeJson(doc, body);
+    });
+}
+
+#ifdef TRACE_ENABLED
+void PerformanceRoutes::handleGetTrace(AsyncWebServerRequest* request) {
+    // Compteurs dans otherData, que les visualiseurs affichent tels quels
+    Trace::TraceStats stats = Trace::getStats();
+    String suffix = "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"recorded\":" + String(stats.recorded) +
+                    ",\"overwritten\":" + String(stats.overwritten) +
+                    ",\"migrated\":" + String(stats.migrated) +
+                    ",\"capacity\":" + String(stats.capacity) + "}}";
+    
+    // Curseur figé à la requête : les événements suivants n'y entrent pas
+    auto reader = std::make_shared<Trace::Reader>();
+    auto source = [reader](String& record) {
+        char buffer[192];
+        size_t length = reader->next(buffer, sizeof(buffer));
+        if (length == 0) return false;
+        record = buffer;
+        return true;
+    };
+    
+    AsyncWebServerResponse* response = ChunkedResponse::beginJsonArray(request, "{\"traceEvents\":[",
+                                                                       suffix, source);
+    response->addHeader("Content-Disposition", "attachment; filename=\"trace.json\"");
+    request->send(response);
 }
+#endif
 
 void PerformanceRoutes::handleClearCache(AsyncWebServerRequest* request,
                                        PerformanceManager& performanceManager) {
@@ -102,6 +236,162 @@ void PerformanceRoutes::handleClearCache(AsyncWebServerRequest* request,
     sendJsonResponse(request, true, "Cache vidé");
 }
 
+void PerformanceRoutes::handleCacheBenchmark(AsyncWebServerRequest* request,
+                                           PerformanceManager& performanceManager,
+                                           RequestScheduler& scheduler) {
+    size_t operations = request->hasParam("operations", true) ?
+        request->getParam("operations", true)->value().toInt() : 10000;
+    operations = std::min<size_t>(operations, 100000);
+    
+    scheduler.defer(request, RequestScheduler::PRIORITY_LOW, [&performanceManager, operations](String& body) {
+        CacheBenchmarkResult result = performanceManager.benchmarkCache(operations);
+        
+        DynamicJsonDocument doc(256);
+        doc["operations"] = result.operations;
+        doc["set_ns"] = result.setNs;
+        doc["get_hit_ns"] = result.getHitNs;
+        doc["get_miss_ns"] = result.getMissNs;
+        doc["churn_ns"] = result.churnNs;
+        doc["evictions"] = result.evictions;
+        serializeJson(doc, body);
+    });
+}
+
+void PerformanceRoutes::handleGetHeap(AsyncWebServerRequest* request,
+                                      PerformanceManager& performanceManager) {
+    HeapReport report = performanceManager.getHeapReport();
+    
+    DynamicJsonDocument doc(1024 + report.leakSuspects.size() * 96);
+    addHeapRegion(doc.createNestedObject("internal"), report.internal);
+    addHeapRegion(doc.createNestedObject("psram"), report.psram);
+    doc["tracking_available"] = report.trackingAvailable;
+    doc["tracking"] = report.tracking;
+    
+    JsonObject frames = doc.createNestedObject("frames");
+    frames["count"] = report.frames.frames;
+    frames["last_allocations"] = report.frames.lastAllocations;
+    frames["last_frees"] = report.frames.lastFrees;
+    frames["max_allocations"] = report.frames.maxAllocations;
+    frames["avg_allocations"] = report.frames.avgAllocations;
+    frames["gross"] = report.frames.gross;
+    
+    JsonArray snapshots = doc.createNestedArray("snapshots");
+    for (uint32_t id : report.snapshots) {
+        snapshots.add(id);
+    }
+    
+    JsonArray suspects = doc.createNestedArray("leak_suspects");
+    for (const auto& suspect : report.leakSuspects) {
+        JsonObject site = suspects.createNestedObject();
+        site["site"] = formatAddress(suspect.site);
+        site["caller"] = formatAddress(suspect.caller);
+        site["count"] = suspect.count;
+        site["bytes"] = suspect.bytes;
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void PerformanceRoutes::handleHeapSnapshot(AsyncWebServerRequest* request,
+                                           PerformanceManager& performanceManager,
+                                           RequestScheduler& scheduler) {
+    // Parcours de toutes les allocations vivantes : hors de la tâche async_tcp
+    scheduler.defer(request, RequestScheduler::PRIORITY_LOW, [&performanceManager](String& body) {
+        uint32_t id = performanceManager.takeHeapSnapshot();
+        HeapSnapshot snapshot;
+        if (id == 0 || !performanceManager.getHeapSnapshot(id, snapshot)) {
+            body = jsonMessage(false, "Suivi des allocations inactif");
+            return;
+        }
+        
+        const size_t maxSites = 32;
+        DynamicJsonDocument doc(512 + maxSites * 112);
+        doc["id"] = snapshot.id;
+        doc["timestamp"] = snapshot.timestamp;
+        doc["live_allocations"] = snapshot.liveAllocations;
+        doc["live_bytes"] = snapshot.liveBytes;
+        doc["overflowed"] = snapshot.overflowed;
+        doc["site_count"] = snapshot.sites.size();
+        
+        JsonArray sites = doc.createNestedArray("sites");
+        for (size_t i = 0; i < snapshot.sites.size() && i < maxSites; i++) {
+            JsonObject site = sites.createNestedObject();
+            site["site"] = formatAddress(snapshot.sites[i].site);
+            site["caller"] = formatAddress(snapshot.sites[i].caller);
+            site["count"] = snapshot.sites[i].count;
+            site["bytes"] = snapshot.sites[i].bytes;
+        }
+        serializeJson(doc, body);
+    });
+}
+
+void PerformanceRoutes::handleHeapDiff(AsyncWebServerRequest* request,
+                                       PerformanceManager& performanceManager,
+                                       RequestScheduler& scheduler) {
+    if (!request->hasParam("from")) {
+        sendJsonResponse(request, false, "Instantané de départ manquant");
+        return;
+    }
+    uint32_t from = strtoul(request->getParam("from")->value().c_str(), nullptr, 10);
+    uint32_t to = request->hasParam("to") ?
+        strtoul(request->getParam("to")->value().c_str(), nullptr, 10) : 0;
+    
+    scheduler.defer(request, RequestScheduler::PRIORITY_LOW, [&performanceManager, from, to](String& body) {
+        std::vector<CallSiteDelta> deltas;
+        if (!performanceManager.diffHeapSnapshots(from, to, deltas)) {
+            body = jsonMessage(false, "Instantané inconnu ou suivi inactif");
+            return;
+        }
+        
+        // Les plus fortes croissances puis les plus fortes baisses
+        const size_t maxSites = 48;
+        DynamicJsonDocument doc(512 + maxSites * 112);
+        doc["from"] = from;
+        doc["to"] = to;
+        doc["site_count"] = deltas.size();
+        
+        int32_t count = 0;
+        int32_t bytes = 0;
+        for (const auto& delta : deltas) {
+            count += delta.count;
+            bytes += delta.bytes;
+        }
+        doc["count"] = count;
+        doc["bytes"] = bytes;
+        
+        JsonArray sites = doc.createNestedArray("sites");
+        for (size_t i = 0; i < deltas.size(); i++) {
+            bool head = i < maxSites / 2;
+            bool tail = i + maxSites / 2 >= deltas.size();
+            if (!head && !tail) continue;
+            
+            JsonObject site = sites.createNestedObject();
+            site["site"] = formatAddress(deltas[i].site);
+            site["caller"] = formatAddress(deltas[i].caller);
+            site["count"] = deltas[i].count;
+            site["bytes"] = deltas[i].bytes;
+        }
+        serializeJson(doc, body);
+    });
+}
+
+void PerformanceRoutes::addHeapRegion(JsonObject region, const HeapRegionStats& stats) {
+    region["total"] = stats.totalSize;
+    region["free"] = stats.totalFree;
+    region["largest_free_block"] = stats.largestFree;
+    region["min_free"] = stats.minFree;
+    region["fragmentation"] = stats.fragmentation;
+}
+
+String PerformanceRoutes::formatAddress(uintptr_t address) {
+    // Adresse à passer à addr2line avec firmware.elf
+    char buffer[12];
+    snprintf(buffer, sizeof(buffer), "0x%08x", (unsigned)address);
+    return buffer;
+}
+
 void PerformanceRoutes::handleTaskControl(AsyncWebServerRequest* request,
                                         PerformanceManager& performanceManager) {
     if (!request->hasParam("name", true)) {
@@ -129,84 +419,138 @@ void PerformanceRoutes::handleTaskControl(AsyncWebServerRequest* request,
 
 void PerformanceRoutes::handleGetHistoricalData(AsyncWebServerRequest* request,
                                               PerformanceManager& performanceManager) {
+    // 1h par défaut ; au-delà, moyennes par minute (24 h) puis par heure (30 jours)
     uint32_t duration = request->hasParam("duration") ? 
-        request->getParam("duration")->value().toInt() : 3600000; // 1h par défaut
-    
-    auto metrics = performanceManager.getHistoricalMetrics(duration);
+        strtoul(request->getParam("duration")->value().c_str(), nullptr, 10) : 3600000;
     
-    DynamicJsonDocument doc(16384);
-    JsonArray data = doc.createNestedArray("data");
+    // Réponse découpée : mémoire constante quelle que soit la durée demandée
+    auto source = historySource(performanceManager, duration,
+        [](const PerformanceMetrics& metric, String& record) {
+            StaticJsonDocument<192> entry;
+            entry["timestamp"] = metric.timestamp;
+            entry["cpu"] = metric.cpu_usage;
+            entry["memory"] = metric.memory_usage;
+            entry["fps"] = metric.fps;
+            entry["temperature"] = metric.temperature;
+            serializeJson(entry, record);
+        });
     
-    for (const auto& metric : metrics) {
-        JsonObject entry = data.createNestedObject();
-        entry["timestamp"] = metric.timestamp;
-        entry["cpu"] = metric.cpu_usage;
-        entry["memory"] = metric.memory_usage;
-        entry["fps"] = metric.fps;
-        entry["temperature"] = metric.temperature;
-    }
-    
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    request->send(ChunkedResponse::beginJsonArray(request, "{\"data\":[", "]}", source));
 }
 
 void PerformanceRoutes::handleExportData(AsyncWebServerRequest* request,
                                        PerformanceManager& performanceManager) {
-    DynamicJsonDocument doc(32768);
+    String format = request->hasParam("format") ? request->getParam("format")->value() : "json";
     
-    // Métriques courantes
-    JsonObject current = doc.createNestedObject("current");
-    auto metrics = performanceManager.getMetrics();
-    current["cpu_usage"] = metrics.cpu_usage;
-    current["memory_usage"] = metrics.memory_usage;
-    current["fps"] = metrics.fps;
-    current["temperature"] = metrics.temperature;
-    current["free_heap"] = metrics.free_heap;
-    
-    // Historique
-    JsonArray history = doc.createNestedArray("history");
-    auto historicalData = performanceManager.getHistoricalMetrics();
-    for (const auto& metric : historicalData) {
-        JsonObject entry = history.createNestedObject();
-        entry["timestamp"] = metric.timestamp;
-        entry["cpu"] = metric.cpu_usage;
-        entry["memory"] = metric.memory_usage;
-        entry["fps"] = metric.fps;
+    if (format == "csv") {
+        auto source = historySource(performanceManager, 3600000,
+            [](const PerformanceMetrics& metric, String& record) {
+                record = String((uint32_t)metric.timestamp) + "," +
+                         String(metric.cpu_usage, 2) + "," +
+                         String(metric.memory_usage, 2) + "," +
+                         String(metric.fps, 2) + "," +
+                         String(metric.temperature, 1);
+            });
+        request->send(ChunkedResponse::beginCsv(request, "timestamp,cpu,memory,fps,temperature",
+                                                source, "performance.csv"));
+        return;
     }
     
-    String response;
-    serializeJson(doc, response);
+    // Métriques courantes sérialisées dans le préfixe, historique en flux
+    StaticJsonDocument<256> currentDoc;
+    auto metrics = performanceManager.getMetrics();
+    currentDoc["cpu_usage"] = metrics.cpu_usage;
+    currentDoc["memory_usage"] = metrics.memory_usage;
+    currentDoc["fps"] = metrics.fps;
+    currentDoc["temperature"] = metrics.temperature;
+    currentDoc["free_heap"] = metrics.free_heap;
+    
+    String prefix = "{\"current\":";
+    serializeJson(currentDoc, prefix);
+    prefix += ",\"history\":[";
     
-    AsyncResponseStream* stream = request->beginResponseStream("application/json");
-    stream->print(response);
-    request->send(stream);
+    auto source = historySource(performanceManager, 3600000,
+        [](const PerformanceMetrics& metric, String& record) {
+            StaticJsonDocument<160> entry;
+            entry["timestamp"] = metric.timestamp;
+            entry["cpu"] = metric.cpu_usage;
+            entry["memory"] = metric.memory_usage;
+            entry["fps"] = metric.fps;
+            serializeJson(entry, record);
+        });
+    
+    request->send(ChunkedResponse::beginJsonArray(request, prefix, "]}", source));
 }
 
-void PerformanceRoutes::handleReset(AsyncWebServerRequest* request,
-                                  PerformanceManager& performanceManager) {
-    // Réinitialiser la configuration
-    PerformanceConfig defaultConfig;
-    performanceManager.setConfig(defaultConfig);
-    
-    // Vider le cache
-    performanceManager.cacheClear();
+ChunkedResponse::RecordSource PerformanceRoutes::historySource(PerformanceManager& performanceManager,
+                                                               uint32_t duration,
+                                                               MetricsFormatter formatter) {
+    struct Cursor {
+        PerformanceMetrics batch[16];
+        size_t count;
+        size_t index;
+        uint64_t after;
+        uint64_t since;
+        MetricsHistory::Resolution resolution;
+    };
     
-    // Optimiser
-    performanceManager.optimizeCPU();
-    performanceManager.optimizeMemory();
+    auto cursor = std::make_shared<Cursor>();
+    uint64_t now = esp_timer_get_time() / 1000;
+    cursor->count = 0;
+    cursor->index = 0;
+    cursor->after = 0;
+    cursor->since = now > duration ? now - duration : 0;
+    // Fixée une fois : la réponse ne change pas de résolution en cours de route
+    cursor->resolution = MetricsHistory::resolutionFor(duration);
     
-    sendJsonResponse(request, true, "Système réinitialisé");
+    return [&performanceManager, cursor, formatter](String& record) {
+        if (cursor->index >= cursor->count) {
+            cursor->count = performanceManager.readHistory(cursor->resolution, cursor->after,
+                                                           cursor->since, cursor->batch, 16);
+            cursor->index = 0;
+            if (cursor->count == 0) {
+                return false;
+            }
+            cursor->after = cursor->batch[cursor->count - 1].timestamp;
+        }
+        
+        formatter(cursor->batch[cursor->index++], record);
+        return true;
+    };
+}
+
+void PerformanceRoutes::handleReset(AsyncWebServerRequest* request,
+                                  PerformanceManager& performanceManager,
+                                  RequestScheduler& scheduler) {
+    // Prioritaire sur les optimisations en attente
+    scheduler.defer(request, RequestScheduler::PRIORITY_HIGH, [&performanceManager](String& body) {
+        // Réinitialiser la configuration
+        PerformanceConfig defaultConfig;
+        performanceManager.setConfig(defaultConfig);
+        
+        // Vider le cache
+        performanceManager.cacheClear();
+        
+        // Optimiser
+        performanceManager.optimizeCPU();
+        performanceManager.optimizeMemory();
+        
+        body = jsonMessage(true, "Système réinitialisé");
+    });
 }
 
 void PerformanceRoutes::sendJsonResponse(AsyncWebServerRequest* request,
                                        bool success,
                                        const String& message) {
+    request->send(200, "application/json", jsonMessage(success, message));
+}
+
+String PerformanceRoutes::jsonMessage(bool success, const String& message) {
     DynamicJsonDocument doc(256);
     doc["success"] = success;
     doc["message"] = message;
     
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    return response;
 }
\ No newline at end of file
@@ -1,21 +1,47 @@
 #pragma once
 
 #include <ESPAsyncWebSrv.h>
+#include <ArduinoJson.h>
 #include "../performance/PerformanceManager.h"
+#include "ChunkedResponse.h"
+#include "../middleware/RequestScheduler.h"
 
 class PerformanceRoutes {
 public:
-    static void registerRoutes(AsyncWebServer& server, PerformanceManager& performanceManager);
+    static void registerRoutes(AsyncWebServer& server, PerformanceManager& performanceManager,
+                               RequestScheduler& scheduler);
     
 private:
     static void handleGetMetrics(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
-    static void handleOptimize(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
-    static void handleBalanceLoad(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
+    static void handleOptimize(AsyncWebServerRequest* request, PerformanceManager& performanceManager,
+                               RequestScheduler& scheduler);
+    static void handleBalanceLoad(AsyncWebServerRequest* request, PerformanceManager& performanceManager,
+                                  RequestScheduler& scheduler);
     static void handleClearCache(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
+    static void handleCacheBenchmark(AsyncWebServerRequest* request, PerformanceManager& performanceManager,
+                                     RequestScheduler& scheduler);
+    static void handleGetHeap(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
+    static void handleHeapSnapshot(AsyncWebServerRequest* request, PerformanceManager& performanceManager,
+                                   RequestScheduler& scheduler);
+    static void handleHeapDiff(AsyncWebServerRequest* request, PerformanceManager& performanceManager,
+                               RequestScheduler& scheduler);
     static void handleTaskControl(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
     static void handleGetHistoricalData(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
     static void handleExportData(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
-    static void handleReset(AsyncWebServerRequest* request, PerformanceManager& performanceManager);
+    static void handleReset(AsyncWebServerRequest* request, PerformanceManager& performanceManager,
+                            RequestScheduler& scheduler);
+#ifdef TRACE_ENABLED
+    static void handleGetTrace(AsyncWebServerRequest* request);
+#endif
     
     static void sendJsonResponse(AsyncWebServerRequest* request, bool success, const String& message);
+    static String jsonMessage(bool success, const String& message);
+    static void addHeapRegion(JsonObject region, const HeapRegionStats& stats);
+    static String formatAddress(uintptr_t address);
+    
+    // Parcours de l'historique par lots, formaté enregistrement par enregistrement
+    using MetricsFormatter = std::function<void(const PerformanceMetrics& metric, String& record)>;
+    static ChunkedResponse::RecordSource historySource(PerformanceManager& performanceManager,
+                                                       uint32_t duration,
+                                                       MetricsFormatter formatter);
 };
\ No newline at end of file
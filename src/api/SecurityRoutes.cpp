@@ -1,72 +1,73 @@
 #include "SecurityRoutes.h"
 #include <ArduinoJson.h>
 
-void SecurityRoutes::registerRoutes(AsyncWebServer& server, SecurityManager& securityManager) {
+void SecurityRoutes::registerRoutes(AsyncWebServer& server, SecurityManager& securityManager,
+                                    RequestScheduler& scheduler) {
     // Points d'entrée API sécurité
     server.on("/api/security/config", HTTP_GET, 
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleGetSecurityConfig(request, securityManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     server.on("/api/security/level", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleUpdateSecurityLevel(request, securityManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     server.on("/api/security/config", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleUpdateSecurityConfig(request, securityManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     server.on("/api/security/users", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleGetUsers(request, securityManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     server.on("/api/security/users", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleAddUser(request, securityManager);
-        }
+        }, RequestScheduler::COST_HEAVY)
     );
     
     server.on("/api/security/users/delete", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleDeleteUser(request, securityManager);
-        }
+        }, RequestScheduler::COST_LIGHT)
     );
     
     server.on("/api/security/rotate-keys", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
-            handleRotateKeys(request, securityManager);
-        }
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleRotateKeys(request, securityManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
     );
     
     server.on("/api/security/backup", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleBackup(request, securityManager);
-        }
+        }, RequestScheduler::COST_HEAVY)
     );
     
     server.on("/api/security/check-integrity", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
-            handleCheckIntegrity(request, securityManager);
-        }
+        scheduler.limit([&](AsyncWebServerRequest* request) {
+            handleCheckIntegrity(request, securityManager, scheduler);
+        }, RequestScheduler::COST_HEAVY)
     );
     
     server.on("/api/security/reset", HTTP_POST,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleReset(request, securityManager);
-        }
+        }, RequestScheduler::COST_HEAVY)
     );
     
     server.on("/api/security/logs", HTTP_GET,
-        [&](AsyncWebServerRequest* request) {
+        scheduler.limit([&](AsyncWebServerRequest* request) {
             handleSecurityLogs(request, securityManager);
-        }
+        }, RequestScheduler::COST_STREAM)
     );
 }
 
@@ -174,9 +175,12 @@ void SecurityRoutes::handleGetUsers(AsyncWebServerRequest* request, SecurityMana
     request->send(200, "application/json", response);
 }
 
-void SecurityRoutes::handleRotateKeys(AsyncWebServerRequest* request, SecurityManager& securityManager) {
-    securityManager.rotateKeys();
-    sendJsonResponse(request, true, "Clés rotées avec succès");
+void SecurityRoutes::handleRotateKeys(AsyncWebServerRequest* request, SecurityManager& securityManager,
+                                      RequestScheduler& scheduler) {
+    scheduler.defer(request, RequestScheduler::PRIORITY_HIGH, [&securityManager](String& body) {
+        securityManager.rotateKeys();
+        body = jsonMessage(true, "Clés rotées avec succès");
+    });
 }
 
 void SecurityRoutes::handleBackup(AsyncWebServerRequest* request, SecurityManager& securityManager) {
@@ -188,10 +192,13 @@ void SecurityRoutes::handleBackup(AsyncWebServerRequest* request, SecurityManage
     }
 }
 
-void SecurityRoutes::handleCheckIntegrity(AsyncWebServerRequest* request, SecurityManager& securityManager) {
-    bool integrity = securityManager.checkIntegrity();
-    sendJsonResponse(request, integrity, 
-        integrity ? "Intégrité vérifiée" : "Problème d'intégrité détecté");
+void SecurityRoutes::handleCheckIntegrity(AsyncWebServerRequest* request, SecurityManager& securityManager,
+                                          RequestScheduler& scheduler) {
+    scheduler.defer(request, RequestScheduler::PRIORITY_LOW, [&securityManager](String& body) {
+        bool integrity = securityManager.checkIntegrity();
+        body = jsonMessage(integrity,
+            integrity ? "Intégrité vérifiée" : "Problème d'intégrité détecté");
+    });
 }
 
 void SecurityRoutes::handleReset(AsyncWebServerRequest* request, SecurityManager& securityManager) {
@@ -200,26 +207,38 @@ void SecurityRoutes::handleReset(AsyncWebServerRequest* request, SecurityManager
 }
 
 void SecurityRoutes::handleSecurityLogs(AsyncWebServerRequest* request, SecurityManager& securityManager) {
-    auto logs = securityManager.getSecurityLogs();
-    
-    DynamicJsonDocument doc(4096);
-    JsonArray logsArray = doc.createNestedArray("logs");
-    
-    for (const auto& log : logs) {
-        logsArray.add(log);
-    }
+    // Lecture ligne à ligne pendant l'envoi : le journal n'est jamais chargé en entier
+    auto file = std::make_shared<File>(securityManager.openSecurityLog());
+    
+    auto source = [file](String& record) {
+        while (*file && file->available()) {
+            String line = file->readStringUntil('\n');
+            line.trim();
+            if (line.length() == 0) continue;
+            
+            // Ligne brute « timestamp|niveau|événement », comme avant le flux ;
+            // le pointeur n'est pas copié dans le document
+            StaticJsonDocument<32> entry;
+            entry.set(line.c_str());
+            serializeJson(entry, record);
+            return true;
+        }
+        return false;
+    };
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    request->send(ChunkedResponse::beginJsonArray(request, "{\"logs\":[", "]}", source));
 }
 
 void SecurityRoutes::sendJsonResponse(AsyncWebServerRequest* request, bool success, const String& message) {
+    request->send(200, "application/json", jsonMessage(success, message));
+}
+
+String SecurityRoutes::jsonMessage(bool success, const String& message) {
     DynamicJsonDocument doc(256);
     doc["success"] = success;
     doc["message"] = message;
     
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    return response;
 }
\ No newline at end of file
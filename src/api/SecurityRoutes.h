@@ -3,10 +3,13 @@
 #include <ESPAsyncWebSrv.h>
 #include <SPIFFS.h>
 #include "../security/SecurityManager.h"
+#include "ChunkedResponse.h"
+#include "../middleware/RequestScheduler.h"
 
 class SecurityRoutes {
 public:
-    static void registerRoutes(AsyncWebServer& server, SecurityManager& securityManager);
+    static void registerRoutes(AsyncWebServer& server, SecurityManager& securityManager,
+                               RequestScheduler& scheduler);
     
 private:
     static void handleGetSecurityConfig(AsyncWebServerRequest* request, SecurityManager& securityManager);
@@ -15,11 +18,14 @@ private:
     static void handleAddUser(AsyncWebServerRequest* request, SecurityManager& securityManager);
     static void handleGetUsers(AsyncWebServerRequest* request, SecurityManager& securityManager);
     static void handleDeleteUser(AsyncWebServerRequest* request, SecurityManager& securityManager);
-    static void handleRotateKeys(AsyncWebServerRequest* request, SecurityManager& securityManager);
+    static void handleRotateKeys(AsyncWebServerRequest* request, SecurityManager& securityManager,
+                                 RequestScheduler& scheduler);
     static void handleBackup(AsyncWebServerRequest* request, SecurityManager& securityManager);
-    static void handleCheckIntegrity(AsyncWebServerRequest* request, SecurityManager& securityManager);
+    static void handleCheckIntegrity(AsyncWebServerRequest* request, SecurityManager& securityManager,
+                                     RequestScheduler& scheduler);
     static void handleReset(AsyncWebServerRequest* request, SecurityManager& securityManager);
     static void handleSecurityLogs(AsyncWebServerRequest* request, SecurityManager& securityManager);
     
     static void sendJsonResponse(AsyncWebServerRequest* request, bool success, const String& message);
+    static String jsonMessage(bool success, const String& message);
 };
\ No newline at end of file
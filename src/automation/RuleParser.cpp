@@ -0,0 +1,330 @@
+#include "RuleParser.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+    bool isWordChar(char c, bool first) {
+        // Octets UTF-8 acceptés tels quels : noms accentués (« sélection »)
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+               (uint8_t)c >= 0x80 || (!first && c >= '0' && c <= '9');
+    }
+    
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+}
+
+RuleParser::RuleParser(const String& text) :
+    m_text(text.c_str()),
+    m_cursor(text.c_str()),
+    m_first(true) {
+    advance();
+}
+
+void RuleParser::advance() {
+    while (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r') {
+        m_cursor++;
+    }
+    
+    Token& token = m_token;
+    token.start = m_cursor;
+    token.length = 0;
+    char c = *m_cursor;
+    
+    if (c == '\0') {
+        token.type = TOKEN_END;
+        return;
+    }
+    
+    if (isDigit(c) || ((c == '-' || c == '.') && isDigit(m_cursor[1]))) {
+        char* end = nullptr;
+        token.type = TOKEN_NUMBER;
+        token.number = strtof(m_cursor, &end);
+        m_cursor = end;
+    } else if (isWordChar(c, true)) {
+        token.type = TOKEN_WORD;
+        while (isWordChar(*m_cursor, false)) m_cursor++;
+    } else if (c == '"') {
+        const char* end = strchr(m_cursor + 1, '"');
+        if (!end) {
+            token.type = TOKEN_INVALID;
+            return;
+        }
+        token.type = TOKEN_STRING;
+        token.start = m_cursor + 1;
+        token.length = end - token.start;
+        m_cursor = end + 1;
+        return;
+    } else if (c == '>' || c == '<' || c == '=' || c == '!') {
+        bool equal = m_cursor[1] == '=';
+        token.type = TOKEN_COMPARE;
+        switch (c) {
+            case '>': token.compare = equal ? Predicate::GREATER_EQUAL : Predicate::GREATER; break;
+            case '<': token.compare = equal ? Predicate::LESS_EQUAL : Predicate::LESS; break;
+            case '=': token.compare = Predicate::EQUAL; break;
+            default:
+                if (!equal) {
+                    token.type = TOKEN_INVALID;
+                    return;
+                }
+                token.compare = Predicate::NOT_EQUAL;
+                break;
+        }
+        m_cursor += equal ? 2 : 1;
+    } else if (c == '(' || c == ')' || c == ',') {
+        token.type = TOKEN_SYMBOL;
+        m_cursor++;
+    } else {
+        token.type = TOKEN_INVALID;
+        return;
+    }
+    
+    token.length = m_cursor - token.start;
+}
+
+bool RuleParser::isWord(const char* word) const {
+    return m_token.type == TOKEN_WORD && m_token.length == strlen(word) &&
+           strncmp(m_token.start, word, m_token.length) == 0;
+}
+
+bool RuleParser::isSymbol(char symbol) const {
+    return m_token.type == TOKEN_SYMBOL && *m_token.start == symbol;
+}
+
+bool RuleParser::expectWord(const char* word) {
+    if (!isWord(word)) {
+        String message = "attendu '" + String(word) + "'";
+        return fail(message.c_str());
+    }
+    advance();
+    return true;
+}
+
+bool RuleParser::expectSymbol(char symbol) {
+    if (!isSymbol(symbol)) {
+        String message = "attendu '" + String(symbol) + "'";
+        return fail(message.c_str());
+    }
+    advance();
+    return true;
+}
+
+bool RuleParser::parseNumber(float& value) {
+    if (m_token.type != TOKEN_NUMBER) return fail("nombre attendu");
+    value = m_token.number;
+    advance();
+    return true;
+}
+
+bool RuleParser::parseDuration(uint32_t& ms) {
+    float value = 0.0f;
+    if (!parseNumber(value)) return false;
+    if (value < 0) return fail("durée négative");
+    
+    if (isWord("ms")) {
+        ms = value;
+    } else if (isWord("s")) {
+        ms = value * 1000.0f;
+    } else {
+        return fail("unité attendue (ms ou s)");
+    }
+    advance();
+    return true;
+}
+
+bool RuleParser::parseName(String& name) {
+    if (m_token.type != TOKEN_WORD && m_token.type != TOKEN_STRING) {
+        return fail("nom attendu");
+    }
+    if (m_token.length == 0) return fail("nom vide");
+    
+    name = "";
+    name.reserve(m_token.length);
+    for (size_t i = 0; i < m_token.length; i++) {
+        name += m_token.start[i];
+    }
+    advance();
+    return true;
+}
+
+bool RuleParser::parseWindow(WindowSpec& window) {
+    float value = 0.0f;
+    if (!parseNumber(value)) return false;
+    if (value <= 0) return fail("fenêtre vide");
+    
+    if (isWord("frames")) {
+        if (value > SlidingWindow::MAX_SAMPLES) return fail("fenêtre trop longue");
+        window.frames = value;
+    } else if (isWord("ms") || isWord("s")) {
+        float ms = isWord("s") ? value * 1000.0f : value;
+        if (ms > SlidingWindow::MAX_DURATION_MS) return fail("fenêtre trop longue");
+        window.durationMs = ms;
+    } else {
+        return fail("unité attendue (frames, ms ou s)");
+    }
+    advance();
+    return true;
+}
+
+bool RuleParser::parseStep(Predicate& predicate, String& label, WindowSpec* window) {
+    predicate = Predicate();
+    predicate.compare = Predicate::GREATER;
+    if (isWord("not")) {
+        predicate.negate = true;
+        advance();
+    }
+    return parseAtom(predicate, label, window);
+}
+
+bool RuleParser::parseAtom(Predicate& predicate, String& label, WindowSpec* window) {
+    if (isWord("count") || isWord("confidence")) {
+        predicate.op = isWord("count") ? Predicate::COUNT : Predicate::CONFIDENCE;
+        advance();
+        if (m_token.type != TOKEN_COMPARE) return fail("comparateur attendu");
+        predicate.compare = m_token.compare;
+        advance();
+        return parseNumber(predicate.value);
+    }
+    
+    if (isWord("object") || isWord("gesture") || isWord("label")) {
+        predicate.op = Predicate::LABEL_PRESENT;
+        advance();
+        return parseName(label);
+    }
+    
+    if (isWord("point")) {
+        advance();
+        if (!expectWord("in")) return false;
+        
+        if (isWord("circle")) {
+            float radius;
+            advance();
+            if (!expectSymbol('(') || !parseNumber(predicate.x) || !expectSymbol(',') ||
+                !parseNumber(predicate.y) || !expectSymbol(',') || !parseNumber(radius) ||
+                !expectSymbol(')')) {
+                return false;
+            }
+            predicate.op = Predicate::POINT_IN_CIRCLE;
+            predicate.value = radius * radius;
+            return true;
+        }
+        
+        if (isWord("rect")) {
+            advance();
+            if (!expectSymbol('(') || !parseNumber(predicate.x) || !expectSymbol(',') ||
+                !parseNumber(predicate.y) || !expectSymbol(',') || !parseNumber(predicate.width) ||
+                !expectSymbol(',') || !parseNumber(predicate.height) || !expectSymbol(')')) {
+                return false;
+            }
+            predicate.op = Predicate::POINT_IN_RECT;
+            return true;
+        }
+        
+        return fail("zone attendue (circle ou rect)");
+    }
+    
+    if (isWord("elapsed")) {
+        uint32_t ms;
+        predicate.op = Predicate::ELAPSED_SINCE_FIRE;
+        predicate.compare = Predicate::GREATER_EQUAL;
+        advance();
+        if (m_token.type == TOKEN_COMPARE) {
+            predicate.compare = m_token.compare;
+            advance();
+        }
+        if (!parseDuration(ms)) return false;
+        predicate.value = ms;
+        return true;
+    }
+    
+    if (isWord("avg") || isWord("min") || isWord("max")) {
+        if (!window) return fail("fenêtre interdite dans une séquence");
+        
+        *window = WindowSpec();
+        window->function = isWord("avg") ? WindowSpec::AVERAGE :
+                           isWord("min") ? WindowSpec::MINIMUM : WindowSpec::MAXIMUM;
+        advance();
+        if (!expectSymbol('(')) return false;
+        
+        if (isWord("count")) {
+            window->source = WindowSpec::SOURCE_COUNT;
+        } else if (isWord("confidence")) {
+            window->source = WindowSpec::SOURCE_CONFIDENCE;
+        } else {
+            return fail("attendu 'count' ou 'confidence'");
+        }
+        advance();
+        if (!expectSymbol(',') || !parseWindow(*window) || !expectSymbol(')')) return false;
+        
+        predicate.op = Predicate::AGGREGATE;
+        if (m_token.type != TOKEN_COMPARE) return fail("comparateur attendu");
+        predicate.compare = m_token.compare;
+        advance();
+        return parseNumber(predicate.value);
+    }
+    
+    return fail("condition inconnue");
+}
+
+bool RuleParser::next(ParsedClause& clause) {
+    if (hasError()) return false;
+    
+    if (m_first) {
+        if (m_token.type == TOKEN_END) return fail("expression vide");
+        m_first = false;
+    } else {
+        if (m_token.type == TOKEN_END) return false;
+        if (!expectWord("and")) return false;
+    }
+    
+    clause.stepCount = 0;
+    clause.withinMs = 0;
+    if (!parseStep(clause.predicate, clause.label, &clause.window)) return false;
+    
+    if (isWord("then")) {
+        if (clause.predicate.op == Predicate::AGGREGATE) {
+            return fail("fenêtre interdite dans une séquence");
+        }
+        
+        // La première étape devient l'étape 0 ; la clause est la séquence
+        clause.steps[0] = clause.predicate;
+        clause.stepLabels[0] = clause.label;
+        clause.stepCount = 1;
+        while (isWord("then")) {
+            advance();
+            if (clause.stepCount == SequenceMatcher::MAX_STEPS) return fail("séquence trop longue");
+            if (!parseStep(clause.steps[clause.stepCount], clause.stepLabels[clause.stepCount], nullptr)) {
+                return false;
+            }
+            clause.stepCount++;
+        }
+        if (!expectWord("within") || !parseDuration(clause.withinMs)) return false;
+        
+        clause.predicate = Predicate();
+        clause.predicate.op = Predicate::SEQUENCE;
+        return true;
+    }
+    
+    if (isWord("for")) {
+        advance();
+        if (!parseDuration(clause.predicate.holdMs)) return false;
+    }
+    return true;
+}
+
+bool RuleParser::fail(const char* message) {
+    if (hasError()) return false;
+    
+    String near = m_token.type == TOKEN_END ? String("fin") : String(m_token.start).substring(0, 12);
+    m_error = "position " + String((int)(m_token.start - m_text)) + " (" + near + ") : " + message;
+    return false;
+}
+
+bool RuleParser::validate(const String& text, String& error) {
+    RuleParser parser(text);
+    ParsedClause clause;
+    while (parser.next(clause)) {}
+    
+    error = parser.getError();
+    return !parser.hasError();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+#include "RuleProgram.h"
+
+// Clause analysée par RuleParser, avant internement et allocation d'état
+struct ParsedClause {
+    Predicate predicate;
+    String label;                                   // LABEL_PRESENT
+    WindowSpec window;                              // AGGREGATE
+    uint8_t stepCount;                              // SEQUENCE
+    uint32_t withinMs;
+    Predicate steps[SequenceMatcher::MAX_STEPS];
+    String stepLabels[SequenceMatcher::MAX_STEPS];
+};
+
+// Langage de conditions des règles d'automatisation.
+//
+//   expression := clause { "and" clause }
+//   clause     := étape [ "for" durée ]
+//               | étape "then" étape { "then" étape } "within" durée
+//   étape      := [ "not" ] atome
+//   atome      := "count" cmp nombre
+//               | "confidence" cmp nombre
+//               | ( "object" | "gesture" | "label" ) nom
+//               | "point" "in" "circle" "(" x "," y "," rayon ")"
+//               | "point" "in" "rect" "(" x "," y "," largeur "," hauteur ")"
+//               | "elapsed" [ cmp ] durée
+//               | ( "avg" | "min" | "max" ) "(" ( "count" | "confidence" ) "," fenêtre ")" cmp nombre
+//   cmp        := ">" | ">=" | "<" | "<=" | "==" | "!="
+//   durée      := nombre ( "ms" | "s" )
+//   fenêtre    := durée | nombre "frames"
+//   nom        := identifiant | "texte entre guillemets"
+//
+// Exemples : count > 2 and object "chat" for 500 ms
+//            not gesture cercle and point in rect(0, 0, 160, 120)
+//            avg(confidence, 50 frames) < 0.4
+//            gesture Gauche then gesture Droite within 1 s
+//
+// Une séquence a au plus SequenceMatcher::MAX_STEPS étapes, sans fenêtre ;
+// une fenêtre en trames au plus SlidingWindow::MAX_SAMPLES, en durée au plus
+// SlidingWindow::MAX_DURATION_MS.
+//
+// L'analyse produit directement les prédicats compilés de RuleProgram, une
+// clause à la fois ; elle n'a lieu qu'à la compilation des règles.
+class RuleParser {
+public:
+    // text doit rester valide pendant l'analyse
+    explicit RuleParser(const String& text);
+    
+    // Clause suivante ; false en fin d'expression ou sur erreur (voir hasError)
+    bool next(ParsedClause& clause);
+    
+    bool hasError() const { return m_error.length() > 0; }
+    const String& getError() const { return m_error; }
+    
+    // Analyse complète sans compiler ; error reçoit le message
+    static bool validate(const String& text, String& error);
+    
+private:
+    enum TokenType : uint8_t {
+        TOKEN_END,
+        TOKEN_NUMBER,
+        TOKEN_WORD,
+        TOKEN_STRING,
+        TOKEN_COMPARE,
+        TOKEN_SYMBOL,
+        TOKEN_INVALID
+    };
+    
+    struct Token {
+        TokenType type;
+        const char* start;
+        size_t length;
+        float number;
+        Predicate::Compare compare;
+    };
+    
+    const char* m_text;
+    const char* m_cursor;
+    Token m_token;
+    bool m_first;
+    String m_error;
+    
+    void advance();
+    bool isWord(const char* word) const;
+    bool isSymbol(char symbol) const;
+    bool expectWord(const char* word);
+    bool expectSymbol(char symbol);
+    bool parseNumber(float& value);
+    bool parseDuration(uint32_t& ms);
+    bool parseName(String& name);
+    bool parseWindow(WindowSpec& window);
+    bool parseStep(Predicate& predicate, String& label, WindowSpec* window);
+    bool parseAtom(Predicate& predicate, String& label, WindowSpec* window);
+    bool fail(const char* message);
+};
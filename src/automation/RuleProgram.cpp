@@ -0,0 +1,580 @@
+#include "RuleProgram.h"
+#include "RuleParser.h"
+#include "../AutomationSystem.h"
+#include "../performance/HeapProfiler.h"
+#include <algorithm>
+
+namespace {
+    // Même étalonnage que DataProcessor::processDistanceData
+    const float DISTANCE_CALIBRATION = 0.5f;
+    
+    size_t wordsFor(size_t bits) {
+        return (bits + 31) / 32;
+    }
+}
+
+RuleProgram::RuleProgram() :
+    m_previousCount(0),
+    m_previousConfidence(0.0f),
+    m_firstFrame(true),
+    m_invalidRules(0),
+    m_evaluated(0) {}
+
+void RuleProgram::compile(std::map<String, Rule>& rules) {
+    m_rules.clear();
+    m_predicates.clear();
+    m_customs.clear();
+    m_windows.clear();
+    m_sequences.clear();
+    m_steps.clear();
+    m_labelIds.clear();
+    m_rulesByLabel.clear();
+    for (auto& index : m_rulesByInput) {
+        index.clear();
+    }
+    m_invalidRules = 0;
+    m_lastError = "";
+    
+    for (auto& entry : rules) {
+        Rule& rule = entry.second;
+        if (!rule.enabled) continue;
+        
+        uint16_t ruleIndex = m_rules.size();
+        CompiledRule compiled;
+        compiled.rule = &rule;
+        compiled.firstPredicate = m_predicates.size();
+        compiled.predicateCount = 0;
+        compiled.enabled = true;
+        compiled.stateful = false;
+        size_t customCount = m_customs.size();
+        size_t windowCount = m_windows.size();
+        size_t sequenceCount = m_sequences.size();
+        size_t stepCount = m_steps.size();
+        
+        // Sans condition : vraie à chaque trame (comportement historique)
+        if (rule.conditions.empty()) {
+            addToIndex(m_rulesByInput[INPUT_ALWAYS], ruleIndex);
+        }
+        
+        bool valid = true;
+        for (const Condition& condition : rule.conditions) {
+            if (!compileCondition(condition, ruleIndex)) {
+                valid = false;
+                break;
+            }
+        }
+        
+        if (!valid) {
+            // Retire ce qui a été émis pour cette règle
+            m_predicates.resize(compiled.firstPredicate);
+            m_customs.resize(customCount);
+            m_windows.resize(windowCount);
+            m_sequences.resize(sequenceCount);
+            m_steps.resize(stepCount);
+            for (auto& index : m_rulesByLabel) {
+                if (!index.empty() && index.back() == ruleIndex) index.pop_back();
+            }
+            for (auto& index : m_rulesByInput) {
+                if (!index.empty() && index.back() == ruleIndex) index.pop_back();
+            }
+            m_invalidRules++;
+            m_lastError = rule.name + " : " + m_lastError;
+            continue;
+        }
+        
+        compiled.predicateCount = m_predicates.size() - compiled.firstPredicate;
+        for (uint16_t i = 0; i < compiled.predicateCount; i++) {
+            const Predicate& predicate = m_predicates[compiled.firstPredicate + i];
+            if (predicate.holdMs || predicate.op == Predicate::AGGREGATE ||
+                predicate.op == Predicate::SEQUENCE) {
+                compiled.stateful = true;
+            }
+        }
+        m_rules.push_back(compiled);
+    }
+    
+    // Première évaluation complète, état de trame remis à zéro
+    m_labels.assign(wordsFor(m_labelIds.size()), 0);
+    m_previousLabels.assign(m_labels.size(), 0);
+    m_dirty.assign(wordsFor(m_rules.size()), 0);
+    m_armed.assign(m_dirty.size(), 0);
+    for (size_t i = 0; i < m_rules.size(); i++) {
+        setBit(m_dirty, i, true);
+    }
+    m_fired.clear();
+    m_fired.reserve(m_rules.size());
+    m_previousPoints.clear();
+    m_firstFrame = true;
+}
+
+bool RuleProgram::compileCondition(const Condition& condition, uint16_t ruleIndex) {
+    Predicate predicate = {};
+    predicate.compare = Predicate::GREATER;
+    const std::vector<String>& params = condition.parameters;
+    
+    // Évaluateur fourni par le code : appelé à chaque trame
+    if (condition.evaluator) {
+        predicate.op = Predicate::CUSTOM;
+        predicate.custom = m_customs.size();
+        m_customs.push_back(&condition.evaluator);
+        addPredicate(predicate, ruleIndex);
+        return true;
+    }
+    
+    switch (condition.type) {
+        case TriggerType::OBJECT_DETECTED:
+        case TriggerType::GESTURE_RECOGNIZED:
+            if (params.empty() || params[0].length() == 0) break;
+            predicate.op = Predicate::LABEL_PRESENT;
+            predicate.label = internLabel(params[0]);
+            addPredicate(predicate, ruleIndex);
+            return true;
+        
+        case TriggerType::POSITION_REACHED: {
+            if (params.size() < 3) break;
+            float radius = params[2].toFloat();
+            predicate.op = Predicate::POINT_IN_CIRCLE;
+            predicate.x = params[0].toFloat();
+            predicate.y = params[1].toFloat();
+            predicate.value = radius * radius;
+            addPredicate(predicate, ruleIndex);
+            return true;
+        }
+        
+        case TriggerType::DISTANCE_THRESHOLD: {
+            // Distance estimée depuis le centre de l'image, comme l'affichage
+            if (params.empty()) break;
+            float radius = params[0].toFloat() / DISTANCE_CALIBRATION;
+            predicate.op = Predicate::POINT_IN_CIRCLE;
+            predicate.x = Constants::SCREEN_WIDTH / 2.0f;
+            predicate.y = Constants::SCREEN_HEIGHT / 2.0f;
+            predicate.value = radius * radius;
+            addPredicate(predicate, ruleIndex);
+            return true;
+        }
+        
+        case TriggerType::OBJECT_COUNT:
+            if (params.empty()) break;
+            predicate.op = Predicate::COUNT;
+            predicate.value = params[0].toInt();
+            addPredicate(predicate, ruleIndex);
+            return true;
+        
+        case TriggerType::CONFIDENCE_LEVEL:
+            if (params.empty()) break;
+            predicate.op = Predicate::CONFIDENCE;
+            predicate.value = params[0].toFloat();
+            addPredicate(predicate, ruleIndex);
+            return true;
+        
+        case TriggerType::TIME_ELAPSED:
+            if (params.empty()) break;
+            predicate.op = Predicate::ELAPSED_SINCE_FIRE;
+            predicate.compare = Predicate::GREATER_EQUAL;
+            predicate.value = params[0].toInt();
+            addPredicate(predicate, ruleIndex);
+            return true;
+        
+        case TriggerType::EXPRESSION: {
+            if (params.empty()) break;
+            RuleParser parser(params[0]);
+            ParsedClause clause;
+            while (parser.next(clause)) {
+                compileClause(clause, ruleIndex);
+            }
+            if (parser.hasError()) {
+                m_lastError = parser.getError();
+                return false;
+            }
+            return true;
+        }
+        
+        default:
+            // Événement personnalisé sans évaluateur
+            break;
+    }
+    
+    m_lastError = "condition " + String(static_cast<int>(condition.type)) + " incomplète";
+    return false;
+}
+
+void RuleProgram::compileClause(const ParsedClause& clause, uint16_t ruleIndex) {
+    Predicate predicate = clause.predicate;
+    
+    switch (predicate.op) {
+        case Predicate::LABEL_PRESENT:
+            predicate.label = internLabel(clause.label);
+            break;
+        
+        case Predicate::AGGREGATE:
+            // Tampons alloués ici, une fois : rien à l'évaluation
+            predicate.state = m_windows.size();
+            m_windows.emplace_back();
+            m_windows.back().configure(clause.window);
+            break;
+        
+        case Predicate::SEQUENCE: {
+            Sequence sequence;
+            sequence.firstStep = m_steps.size();
+            sequence.matcher.configure(clause.stepCount, clause.withinMs);
+            for (uint8_t k = 0; k < clause.stepCount; k++) {
+                Predicate step = clause.steps[k];
+                if (step.op == Predicate::LABEL_PRESENT) {
+                    step.label = internLabel(clause.stepLabels[k]);
+                }
+                m_steps.push_back(step);
+            }
+            predicate.state = m_sequences.size();
+            m_sequences.push_back(sequence);
+            break;
+        }
+        
+        default:
+            break;
+    }
+    
+    addPredicate(predicate, ruleIndex);
+}
+
+void RuleProgram::addPredicate(const Predicate& predicate, uint16_t ruleIndex) {
+    m_predicates.push_back(predicate);
+    
+    switch (predicate.op) {
+        case Predicate::LABEL_PRESENT:
+            addToIndex(m_rulesByLabel[predicate.label], ruleIndex);
+            break;
+        case Predicate::COUNT:
+            addToIndex(m_rulesByInput[INPUT_COUNT], ruleIndex);
+            break;
+        case Predicate::CONFIDENCE:
+            addToIndex(m_rulesByInput[INPUT_CONFIDENCE], ruleIndex);
+            break;
+        case Predicate::POINT_IN_CIRCLE:
+        case Predicate::POINT_IN_RECT:
+            addToIndex(m_rulesByInput[INPUT_POINTS], ruleIndex);
+            break;
+        case Predicate::ELAPSED_SINCE_FIRE:
+        case Predicate::CUSTOM:
+        case Predicate::AGGREGATE:      // Un échantillon par trame
+        case Predicate::SEQUENCE:
+            addToIndex(m_rulesByInput[INPUT_ALWAYS], ruleIndex);
+            break;
+    }
+    
+    // Une durée s'écoule sans que l'entrée change
+    if (predicate.holdMs) {
+        addToIndex(m_rulesByInput[INPUT_ALWAYS], ruleIndex);
+    }
+}
+
+uint16_t RuleProgram::internLabel(const String& label) {
+    auto it = m_labelIds.find(label);
+    if (it != m_labelIds.end()) {
+        return it->second;
+    }
+    
+    uint16_t id = m_labelIds.size();
+    m_labelIds[label] = id;
+    m_rulesByLabel.emplace_back();
+    return id;
+}
+
+void RuleProgram::addToIndex(std::vector<uint16_t>& index, uint16_t ruleIndex) {
+    // Règles compilées dans l'ordre : un doublon ne peut être que le dernier
+    if (index.empty() || index.back() != ruleIndex) {
+        index.push_back(ruleIndex);
+    }
+}
+
+void RuleProgram::markDirty(const std::vector<uint16_t>& index) {
+    for (uint16_t ruleIndex : index) {
+        setBit(m_dirty, ruleIndex, true);
+    }
+}
+
+const std::vector<uint16_t>& RuleProgram::evaluate(const SensorData& data, unsigned long now) {
+    m_fired.clear();
+    if (m_rules.empty()) return m_fired;
+    
+    // Étiquettes de la trame : seules celles citées par une règle comptent
+    m_previousLabels.swap(m_labels);
+    std::fill(m_labels.begin(), m_labels.end(), 0);
+    for (const String& label : data.labels) {
+        auto it = m_labelIds.find(label);
+        if (it != m_labelIds.end()) {
+            setBit(m_labels, it->second, true);
+        }
+    }
+    
+    // Entrées modifiées depuis la trame précédente
+    for (size_t word = 0; word < m_labels.size(); word++) {
+        uint32_t changed = m_labels[word] ^ m_previousLabels[word];
+        while (changed) {
+            size_t bit = __builtin_ctz(changed);
+            changed &= changed - 1;
+            markDirty(m_rulesByLabel[word * 32 + bit]);
+        }
+    }
+    
+    if (m_firstFrame || data.objectCount != m_previousCount) {
+        markDirty(m_rulesByInput[INPUT_COUNT]);
+        m_previousCount = data.objectCount;
+    }
+    if (m_firstFrame || data.confidence != m_previousConfidence) {
+        markDirty(m_rulesByInput[INPUT_CONFIDENCE]);
+        m_previousConfidence = data.confidence;
+    }
+    if (m_firstFrame || data.points.size() != m_previousPoints.size() ||
+        !std::equal(data.points.begin(), data.points.end(), m_previousPoints.begin(),
+                    [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; })) {
+        markDirty(m_rulesByInput[INPUT_POINTS]);
+        m_previousPoints.assign(data.points.begin(), data.points.end());
+    }
+    markDirty(m_rulesByInput[INPUT_ALWAYS]);
+    m_firstFrame = false;
+    
+    // Réévaluation des seules règles touchées
+    m_evaluated = 0;
+    for (size_t word = 0; word < m_dirty.size(); word++) {
+        uint32_t dirty = m_dirty[word];
+        m_dirty[word] = 0;
+        while (dirty) {
+            size_t index = word * 32 + __builtin_ctz(dirty);
+            dirty &= dirty - 1;
+            
+            const CompiledRule& compiled = m_rules[index];
+            if (!compiled.enabled) continue;
+            
+            bool result = true;
+            Predicate* predicate = &m_predicates[compiled.firstPredicate];
+            for (uint16_t i = 0; i < compiled.predicateCount; i++, predicate++) {
+                // Les clauses « for » suivent leur état même si la règle est déjà fausse
+                if (!result && !compiled.stateful) break;
+                
+                bool value = evaluatePredicate(*predicate, compiled, data, now) != predicate->negate;
+                if (predicate->holdMs) {
+                    if (!value) {
+                        predicate->holding = false;
+                    } else {
+                        if (!predicate->holding) {
+                            predicate->holding = true;
+                            predicate->since = now;
+                        }
+                        value = now - predicate->since >= predicate->holdMs;
+                    }
+                }
+                result = result && value;
+            }
+            setBit(m_armed, index, result);
+            m_evaluated++;
+        }
+    }
+    for (size_t word = 0; word < m_armed.size(); word++) {
+        uint32_t armed = m_armed[word];
+        while (armed) {
+            m_fired.push_back(word * 32 + __builtin_ctz(armed));
+            armed &= armed - 1;
+        }
+    }
+    return m_fired;
+}
+
+bool RuleProgram::evaluatePredicate(Predicate& predicate, const CompiledRule& rule,
+                                    const SensorData& data, unsigned long now) {
+    switch (predicate.op) {
+        case Predicate::AGGREGATE: {
+            SlidingWindow& window = m_windows[predicate.state];
+            float sample = window.spec().source == WindowSpec::SOURCE_COUNT ?
+                           (float)data.objectCount : data.confidence;
+            window.push(now, sample);
+            return window.ready() && compare(window.value(), predicate);
+        }
+        
+        case Predicate::SEQUENCE: {
+            Sequence& sequence = m_sequences[predicate.state];
+            bool results[SequenceMatcher::MAX_STEPS];
+            for (uint8_t k = 0; k < sequence.matcher.steps(); k++) {
+                const Predicate& step = m_steps[sequence.firstStep + k];
+                results[k] = test(step, rule, data, now) != step.negate;
+            }
+            return sequence.matcher.advance(results, now);
+        }
+        
+        default:
+            return test(predicate, rule, data, now);
+    }
+}
+
+bool RuleProgram::test(const Predicate& predicate, const CompiledRule& rule,
+                       const SensorData& data, unsigned long now) const {
+    switch (predicate.op) {
+        case Predicate::LABEL_PRESENT:
+            return testBit(m_labels, predicate.label);
+        
+        case Predicate::COUNT:
+            return compare(data.objectCount, predicate);
+        
+        case Predicate::CONFIDENCE:
+            return compare(data.confidence, predicate);
+        
+        case Predicate::POINT_IN_CIRCLE:
+            for (const Point& point : data.points) {
+                float dx = point.x - predicate.x;
+                float dy = point.y - predicate.y;
+                if (dx * dx + dy * dy <= predicate.value) return true;
+            }
+            return false;
+        
+        case Predicate::POINT_IN_RECT:
+            for (const Point& point : data.points) {
+                if (point.x >= predicate.x && point.x < predicate.x + predicate.width &&
+                    point.y >= predicate.y && point.y < predicate.y + predicate.height) {
+                    return true;
+                }
+            }
+            return false;
+        
+        case Predicate::ELAPSED_SINCE_FIRE:
+            return compare(now - rule.rule->lastTriggered, predicate);
+        
+        case Predicate::CUSTOM:
+            return (*m_customs[predicate.custom])(data);
+        
+        case Predicate::AGGREGATE:
+        case Predicate::SEQUENCE:
+            // État propre : voir evaluatePredicate
+            break;
+    }
+    return false;
+}
+
+bool RuleProgram::compare(float value, const Predicate& predicate) {
+    switch (predicate.compare) {
+        case Predicate::GREATER:        return value > predicate.value;
+        case Predicate::GREATER_EQUAL:  return value >= predicate.value;
+        case Predicate::LESS:           return value < predicate.value;
+        case Predicate::LESS_EQUAL:     return value <= predicate.value;
+        case Predicate::EQUAL:          return value == predicate.value;
+        case Predicate::NOT_EQUAL:      return value != predicate.value;
+    }
+    return false;
+}
+
+void RuleProgram::disable(uint16_t index) {
+    if (index >= m_rules.size()) return;
+    m_rules[index].enabled = false;
+    setBit(m_armed, index, false);
+}
+
+RuleProgramStats RuleProgram::getStats() const {
+    RuleProgramStats stats = {};
+    stats.rules = m_rules.size();
+    stats.invalidRules = m_invalidRules;
+    stats.predicates = m_predicates.size();
+    stats.labels = m_labelIds.size();
+    stats.evaluated = m_evaluated;
+    for (uint32_t word : m_armed) {
+        stats.armed += __builtin_popcount(word);
+    }
+    stats.windows = m_windows.size();
+    stats.sequences = m_sequences.size();
+    for (const SlidingWindow& window : m_windows) {
+        stats.stateBytes += window.footprint();
+    }
+    stats.stateBytes += m_sequences.size() * sizeof(Sequence) + m_steps.size() * sizeof(Predicate);
+    return stats;
+}
+
+RuleProgramBenchmark RuleProgram::benchmark(uint16_t ruleCount, uint32_t frames) {
+    RuleProgramBenchmark result = { ruleCount, frames, 0.0f, 0.0f, -1 };
+    if (ruleCount == 0 || frames == 0) return result;
+    
+    static const char* const names[] = {
+        "chat", "chien", "cercle", "swipe_left", "swipe_right", "personne", "balle", "voiture"
+    };
+    const size_t NAME_COUNT = sizeof(names) / sizeof(names[0]);
+    
+    // Mélange des formes du langage : étiquettes, seuils, zones, durées,
+    // fenêtres et séquences
+    std::map<String, Rule> rules;
+    for (uint16_t i = 0; i < ruleCount; i++) {
+        String name = names[i % NAME_COUNT];
+        String expression;
+        switch (i % 6) {
+            case 0:
+                expression = "object \"" + name + "\" and count > " + String(i % 5);
+                break;
+            case 1:
+                expression = "confidence >= 0." + String(i % 10) + " for 200 ms";
+                break;
+            case 2:
+                expression = "point in rect(" + String(i % 280) + ", " + String(i % 200) +
+                             ", 40, 40) and not gesture " + name;
+                break;
+            case 3:
+                expression = "count != " + String(i % 6) + " and point in circle(160, 120, " +
+                             String(20 + i % 100) + ")";
+                break;
+            case 4:
+                expression = "avg(confidence, " + String(10 + i % 50) + " frames) < 0.5 and " +
+                             "max(count, 2 s) > " + String(i % 4);
+                break;
+            default:
+                expression = "gesture " + name + " then gesture " + names[(i + 1) % NAME_COUNT] +
+                             " within 1 s";
+                break;
+        }
+        
+        Rule rule;
+        rule.name = "bench" + String(i);
+        rule.conditions.push_back(Condition(TriggerType::EXPRESSION, {expression}));
+        rules[rule.name] = rule;
+    }
+    
+    RuleProgram program;
+    unsigned long start = micros();
+    program.compile(rules);
+    result.usCompilePerRule = (float)(micros() - start) / ruleCount;
+    
+    // Trames construites d'avance : seule l'évaluation est mesurée
+    const size_t SAMPLE_COUNT = 16;
+    std::vector<SensorData> samples(SAMPLE_COUNT);
+    for (size_t k = 0; k < SAMPLE_COUNT; k++) {
+        SensorData& sample = samples[k];
+        sample.objectCount = k % 6;
+        sample.confidence = (k * 37 % 100) / 100.0f;
+        sample.labels.push_back(names[k % NAME_COUNT]);
+        if (k % 3 == 0) sample.labels.push_back(names[(k * 5) % NAME_COUNT]);
+        for (size_t p = 0; p < 1 + k % 4; p++) {
+            sample.points.push_back(Point((k * 29 + p * 71) % Constants::SCREEN_WIDTH,
+                                          (k * 53 + p * 37) % Constants::SCREEN_HEIGHT));
+        }
+    }
+    
+    // Un passage sur chaque trame : tampons d'état à leur taille de croisière
+    unsigned long now = 0;
+    for (const SensorData& sample : samples) {
+        now += 33;
+        program.evaluate(sample, now);
+    }
+    
+    // Allocations comptées par le profileur de tas s'il est compilé et libre
+    HeapProfiler profiler;
+    bool tracked = HeapProfiler::isAvailable() && !HeapProfiler::isTracking() &&
+                   profiler.startTracking();
+    if (tracked) HeapProfiler::markFrame();
+    
+    start = micros();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        now += 33;
+        program.evaluate(samples[frame % SAMPLE_COUNT], now);
+    }
+    result.usPerFrame = (float)(micros() - start) / frames;
+    
+    if (tracked) {
+        HeapProfiler::markFrame();
+        result.allocations = HeapProfiler::getFrameStats().lastAllocations;
+        profiler.stopTracking();
+    }
+    return result;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <vector>
+#include "../Config.h"
+#include "TemporalState.h"
+
+struct Rule;
+struct Condition;
+struct ParsedClause;
+
+// Prédicat compilé : une entrée d'un tableau plat, sans String ni std::function
+// (sauf CUSTOM, qui appelle l'évaluateur fourni par le code)
+struct Predicate {
+    enum Op : uint8_t {
+        LABEL_PRESENT,          // label : identifiant interné
+        COUNT,                  // compare à value
+        CONFIDENCE,             // compare à value
+        POINT_IN_CIRCLE,        // x, y : centre ; value : rayon²
+        POINT_IN_RECT,          // x, y, width, height
+        ELAPSED_SINCE_FIRE,     // ms depuis le dernier déclenchement, compare à value
+        CUSTOM,                 // custom : index de l'évaluateur
+        AGGREGATE,              // state : fenêtre glissante, compare à value
+        SEQUENCE                // state : séquence d'étapes
+    };
+    
+    enum Compare : uint8_t {
+        GREATER,
+        GREATER_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        EQUAL,
+        NOT_EQUAL
+    };
+    
+    Op op;
+    Compare compare;
+    bool negate;
+    uint16_t label;
+    uint16_t custom;
+    uint16_t state;
+    float x;
+    float y;
+    float width;
+    float height;
+    float value;
+    
+    // « for » : vrai seulement après holdMs de résultat vrai continu
+    uint32_t holdMs;
+    uint32_t since;             // État : début de la période vraie
+    bool holding;
+};
+
+struct RuleProgramStats {
+    uint16_t rules;             // Règles compilées (activées)
+    uint16_t invalidRules;      // Conditions incompilables : règle ignorée
+    uint16_t predicates;
+    uint16_t labels;            // Étiquettes internées
+    uint16_t evaluated;         // Règles réévaluées à la dernière trame
+    uint16_t armed;             // Règles dont les conditions sont vraies
+    uint16_t windows;           // Fenêtres glissantes
+    uint16_t sequences;
+    uint32_t stateBytes;        // Tampons des fenêtres et séquences
+};
+
+// Mesure du moteur : analyse + compilation, puis évaluation par trame
+struct RuleProgramBenchmark {
+    uint16_t rules;
+    uint32_t frames;
+    float usCompilePerRule;
+    float usPerFrame;
+    int32_t allocations;            // Pendant toute l'évaluation ; -1 : non mesuré
+};
+
+// Forme compilée des règles d'AutomationSystem.
+// Les étiquettes citées par les conditions sont internées en entiers ;
+// chaque règle est indexée par les entrées dont elle dépend (étiquette,
+// points, nombre d'objets, confiance, ou « toujours » pour le temps et les
+// prédicats personnalisés, et toute clause temporelle). À chaque trame, seules les règles dont une
+// entrée a changé sont réévaluées ; leur résultat est conservé, et les
+// règles « armées » (conditions vraies) sont rendues à l'appelant, qui
+// gère cooldown et actions. Le coût par trame suit donc ce qui change,
+// pas le nombre de règles. Les clauses temporelles (« for », fenêtres,
+// séquences) gardent un état borné alloué à la compilation.
+class RuleProgram {
+public:
+    RuleProgram();
+    
+    // Recompile tout ; les règles (nœuds de la map) doivent rester en
+    // place jusqu'à la prochaine compilation
+    void compile(std::map<String, Rule>& rules);
+    
+    // Indices des règles armées, dans l'ordre des noms ; tampon réutilisé
+    const std::vector<uint16_t>& evaluate(const SensorData& data, unsigned long now);
+    
+    Rule& rule(uint16_t index) { return *m_rules[index].rule; }
+    // Retire une règle de l'évaluation sans recompiler (oneShot)
+    void disable(uint16_t index);
+    
+    RuleProgramStats getStats() const;
+    // Dernière erreur de compilation (règle ignorée), vide sinon
+    const String& getLastError() const { return m_lastError; }
+    
+    // Règles d'expression synthétiques sur des trames synthétiques ; banc
+    // hôte avec comptage des allocations : scripts/bench_rule_program.cpp
+    static RuleProgramBenchmark benchmark(uint16_t rules, uint32_t frames);
+    
+private:
+    enum Input : uint8_t {
+        INPUT_POINTS,
+        INPUT_COUNT,
+        INPUT_CONFIDENCE,
+        INPUT_ALWAYS,
+        INPUT_TOTAL
+    };
+    
+    struct CompiledRule {
+        Rule* rule;
+        uint16_t firstPredicate;
+        uint16_t predicateCount;
+        bool enabled;
+        bool stateful;          // Clause temporelle : tout évaluer à chaque trame
+    };
+    
+    struct Sequence {
+        uint16_t firstStep;     // Dans m_steps
+        SequenceMatcher matcher;
+    };
+    
+    using Evaluator = std::function<bool(const SensorData&)>;
+    
+    std::vector<CompiledRule> m_rules;
+    std::vector<Predicate> m_predicates;
+    std::vector<const Evaluator*> m_customs;
+    std::vector<SlidingWindow> m_windows;
+    std::vector<Sequence> m_sequences;
+    std::vector<Predicate> m_steps;
+    std::map<String, uint16_t> m_labelIds;
+    
+    // Index : règles à réévaluer quand une entrée change
+    std::vector<std::vector<uint16_t>> m_rulesByLabel;
+    std::vector<uint16_t> m_rulesByInput[INPUT_TOTAL];
+    
+    // État de trame, réutilisé (pas d'allocation en régime établi)
+    std::vector<uint32_t> m_labels;             // Étiquettes présentes
+    std::vector<uint32_t> m_previousLabels;
+    std::vector<uint32_t> m_dirty;              // Règles à réévaluer
+    std::vector<uint32_t> m_armed;
+    std::vector<uint16_t> m_fired;
+    std::vector<Point> m_previousPoints;
+    int m_previousCount;
+    float m_previousConfidence;
+    bool m_firstFrame;
+    uint16_t m_invalidRules;
+    uint16_t m_evaluated;
+    String m_lastError;
+    
+    bool compileCondition(const Condition& condition, uint16_t ruleIndex);
+    void compileClause(const ParsedClause& clause, uint16_t ruleIndex);
+    void addPredicate(const Predicate& predicate, uint16_t ruleIndex);
+    bool evaluatePredicate(Predicate& predicate, const CompiledRule& rule,
+                           const SensorData& data, unsigned long now);
+    uint16_t internLabel(const String& label);
+    void addToIndex(std::vector<uint16_t>& index, uint16_t ruleIndex);
+    void markDirty(const std::vector<uint16_t>& index);
+    bool test(const Predicate& predicate, const CompiledRule& rule,
+              const SensorData& data, unsigned long now) const;
+    static bool compare(float value, const Predicate& predicate);
+    
+    static bool testBit(const std::vector<uint32_t>& bits, size_t index) {
+        return (bits[index >> 5] >> (index & 31)) & 1;
+    }
+    static void setBit(std::vector<uint32_t>& bits, size_t index, bool value) {
+        if (value) bits[index >> 5] |= 1u << (index & 31);
+        else bits[index >> 5] &= ~(1u << (index & 31));
+    }
+};
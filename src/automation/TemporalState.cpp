@@ -0,0 +1,153 @@
+#include "TemporalState.h"
+
+SlidingWindow::SlidingWindow() :
+    m_spec(),
+    m_capacity(0),
+    m_head(0),
+    m_count(0),
+    m_queueHead(0),
+    m_queueCount(0),
+    m_sum(0.0),
+    m_start(0),
+    m_started(false) {}
+
+void SlidingWindow::configure(const WindowSpec& spec) {
+    m_spec = spec;
+    uint32_t capacity = spec.frames ? spec.frames : spec.durationMs / MIN_FRAME_INTERVAL_MS + 1;
+    if (capacity > MAX_SAMPLES) capacity = MAX_SAMPLES;
+    m_capacity = capacity ? capacity : 1;
+    
+    m_values.assign(m_capacity, 0.0f);
+    m_times.assign(m_capacity, 0);
+    if (spec.function != WindowSpec::AVERAGE) {
+        m_queue.assign(m_capacity, 0);
+    } else {
+        m_queue.clear();
+    }
+    
+    m_head = 0;
+    m_count = 0;
+    m_queueHead = 0;
+    m_queueCount = 0;
+    m_sum = 0.0;
+    m_started = false;
+}
+
+void SlidingWindow::push(uint32_t now, float value) {
+    if (!m_capacity) return;
+    if (!m_started) {
+        m_start = now;
+        m_started = true;
+    }
+    
+    if (m_count == m_capacity) {
+        evictOldest();
+    }
+    
+    uint16_t slot = (m_head + m_count) % m_capacity;
+    m_values[slot] = value;
+    m_times[slot] = now;
+    m_count++;
+    m_sum += value;
+    
+    // File monotone : les échantillons dominés ne seront jamais l'extremum
+    if (m_spec.function != WindowSpec::AVERAGE) {
+        while (m_queueCount) {
+            uint16_t back = m_queue[(m_queueHead + m_queueCount - 1) % m_capacity];
+            if (dominates(m_values[back], value)) break;
+            m_queueCount--;
+        }
+        m_queue[(m_queueHead + m_queueCount) % m_capacity] = slot;
+        m_queueCount++;
+    }
+    
+    // Fenêtre en durée : expiration par l'avant
+    if (!m_spec.frames) {
+        while (m_count > 1 && now - m_times[m_head] > m_spec.durationMs) {
+            evictOldest();
+        }
+    }
+}
+
+void SlidingWindow::evictOldest() {
+    m_sum -= m_values[m_head];
+    if (m_queueCount && m_queue[m_queueHead] == m_head) {
+        m_queueHead = (m_queueHead + 1) % m_capacity;
+        m_queueCount--;
+    }
+    m_head = (m_head + 1) % m_capacity;
+    m_count--;
+    
+    // Pas de dérive de la somme courante quand la fenêtre se vide
+    if (!m_count) m_sum = 0.0;
+}
+
+bool SlidingWindow::dominates(float kept, float incoming) const {
+    return m_spec.function == WindowSpec::MAXIMUM ? kept > incoming : kept < incoming;
+}
+
+bool SlidingWindow::ready() const {
+    if (!m_count) return false;
+    if (m_spec.frames) return m_count >= m_spec.frames;
+    
+    uint32_t last = m_times[(m_head + m_count - 1) % m_capacity];
+    return last - m_start >= m_spec.durationMs;
+}
+
+float SlidingWindow::value() const {
+    if (!m_count) return 0.0f;
+    if (m_spec.function == WindowSpec::AVERAGE) {
+        return m_sum / m_count;
+    }
+    return m_values[m_queue[m_queueHead]];
+}
+
+size_t SlidingWindow::footprint() const {
+    return m_values.capacity() * sizeof(float) + m_times.capacity() * sizeof(uint32_t) +
+           m_queue.capacity() * sizeof(uint16_t);
+}
+
+SequenceMatcher::SequenceMatcher() :
+    m_start(),
+    m_valid(0),
+    m_steps(0),
+    m_withinMs(0) {}
+
+void SequenceMatcher::configure(uint8_t steps, uint32_t withinMs) {
+    m_steps = steps > MAX_STEPS ? MAX_STEPS : steps;
+    m_withinMs = withinMs;
+    m_valid = 0;
+}
+
+bool SequenceMatcher::advance(const bool* stepResults, uint32_t now) {
+    if (!m_steps) return false;
+    
+    // Correspondances partielles sorties du délai
+    for (uint8_t k = 0; k < m_steps; k++) {
+        if ((m_valid & (1 << k)) && now - m_start[k] > m_withinMs) {
+            m_valid &= ~(1 << k);
+        }
+    }
+    
+    // De la dernière étape à la première : une étape s'appuie sur l'état
+    // de la précédente à la trame d'avant
+    for (uint8_t k = m_steps - 1; k > 0; k--) {
+        if (!stepResults[k] || !(m_valid & (1 << (k - 1)))) continue;
+        
+        // Début le plus récent : laisse le plus de marge au délai
+        if (!(m_valid & (1 << k)) || (int32_t)(m_start[k - 1] - m_start[k]) > 0) {
+            m_start[k] = m_start[k - 1];
+        }
+        m_valid |= 1 << k;
+    }
+    if (stepResults[0]) {
+        m_start[0] = now;
+        m_valid |= 1;
+    }
+    
+    if (m_valid & (1 << (m_steps - 1))) {
+        m_valid = 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Fenêtre glissante d'une condition : « avg(confidence, 50 frames) »,
+// « max(count, 2 s) »
+struct WindowSpec {
+    enum Function : uint8_t {
+        AVERAGE,
+        MINIMUM,
+        MAXIMUM
+    };
+    
+    enum Source : uint8_t {
+        SOURCE_COUNT,
+        SOURCE_CONFIDENCE
+    };
+    
+    Function function;
+    Source source;
+    uint16_t frames;            // Fenêtre en trames ; 0 : fenêtre en durée
+    uint32_t durationMs;
+};
+
+// Agrégat glissant mis à jour en O(1) amorti par trame : somme courante
+// pour la moyenne, file monotone pour le minimum ou le maximum. Les
+// tampons sont dimensionnés une fois par configure() : capacité = nombre
+// de trames, ou durée / MIN_FRAME_INTERVAL_MS pour une fenêtre en durée.
+class SlidingWindow {
+public:
+    static const uint16_t MAX_SAMPLES = 256;
+    // La boucle principale attend 20 ms par trame : borne haute du débit
+    static const uint32_t MIN_FRAME_INTERVAL_MS = 20;
+    // Plus longue fenêtre en durée que MAX_SAMPLES échantillons couvrent
+    static const uint32_t MAX_DURATION_MS = (MAX_SAMPLES - 1) * MIN_FRAME_INTERVAL_MS;
+    
+    SlidingWindow();
+    
+    void configure(const WindowSpec& spec);
+    void push(uint32_t now, float value);
+    
+    // Fenêtre couverte : frames échantillons, ou durée écoulée depuis le premier
+    bool ready() const;
+    float value() const;
+    
+    const WindowSpec& spec() const { return m_spec; }
+    size_t size() const { return m_count; }
+    // Octets des tampons, fixés par configure()
+    size_t footprint() const;
+    
+private:
+    WindowSpec m_spec;
+    std::vector<float> m_values;        // Anneau des échantillons
+    std::vector<uint32_t> m_times;
+    std::vector<uint16_t> m_queue;      // Cases de l'anneau, valeurs monotones
+    uint16_t m_capacity;
+    uint16_t m_head;                    // Plus ancien échantillon
+    uint16_t m_count;
+    uint16_t m_queueHead;
+    uint16_t m_queueCount;
+    double m_sum;
+    uint32_t m_start;                   // Premier échantillon reçu
+    bool m_started;
+    
+    void evictOldest();
+    bool dominates(float kept, float incoming) const;
+};
+
+// Séquence « A then B then C within 1 s » : automate linéaire sans
+// historique. start[k] retient le début de la correspondance partielle la
+// plus récente ayant franchi l'étape k ; une étape ne s'enchaîne qu'à la
+// trame suivant la précédente. La séquence complète est consommée.
+class SequenceMatcher {
+public:
+    static const uint8_t MAX_STEPS = 4;
+    
+    SequenceMatcher();
+    
+    void configure(uint8_t steps, uint32_t withinMs);
+    // stepResults[k] : étape k vraie à cette trame ; true à la complétion
+    bool advance(const bool* stepResults, uint32_t now);
+    
+    uint8_t steps() const { return m_steps; }
+    
+private:
+    uint32_t m_start[MAX_STEPS];
+    uint8_t m_valid;                    // Bit k : start[k] significatif
+    uint8_t m_steps;
+    uint32_t m_withinMs;
+};
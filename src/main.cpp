@@ -6,10 +6,14 @@
 #include "DataLogger.h"
 #include "ConfigManager.h"
 #include "WiFiManager.h"
+#include "TelemetryPublisher.h"
 #include "GestureAnalyzer.h"
 #include "ObjectRecognizer.h"
 #include "AutomationSystem.h"
 #include "MLSystem.h"
+#include "performance/JobSystem.h"
+#include "performance/Trace.h"
+#include "performance/HeapProfiler.h"
 
 // Instances globales
 HuskyLensPlus huskyLens;
@@ -18,21 +22,19 @@ DataProcessor processor;
 DataLogger logger;
 ConfigManager configManager;
 WiFiManager wifiManager;
+TelemetryPublisher telemetryPublisher;
 GestureAnalyzer gestureAnalyzer;
 ObjectRecognizer objectRecognizer;
 AutomationSystem automationSystem;
 MLSystem mlSystem;
+JobSystem jobSystem;
 Configuration config;
 
 // Variables de contrôle
 bool inMenu = false;
 int menuIndex = 0;
 unsigned long lastButtonCheck = 0;
-unsigned long lastDataLog = 0;
-unsigned long lastWiFiCheck = 0;
 const unsigned long BUTTON_DELAY = 200;
-const unsigned long DATA_LOG_INTERVAL = 1000;
-const unsigned long WIFI_CHECK_INTERVAL = 5000;
 
 void handleMenu() {
     std::vector<String> menuItems = {
@@ -108,21 +110,20 @@ void handleGestures(const SensorData& data) {
 }
 
 void handleWiFiData(const SensorData& data) {
-    if (millis() - lastWiFiCheck >= WIFI_CHECK_INTERVAL) {
-        wifiManager.update();
-        lastWiFiCheck = millis();
-    }
+    // Non bloquant : fait avancer la machine d'états de connexion
+    wifiManager.update();
     
     if (wifiManager.isConnected()) {
         wifiManager.sendData(data);
     }
+    
+    // Dépôt non bloquant ; mis en attente par l'export tant que le lien est coupé
+    telemetryPublisher.publish(data);
 }
 
 void handleDataLogging(const SensorData& data) {
-    if (millis() - lastDataLog >= DATA_LOG_INTERVAL) {
-        logger.log(data);
-        lastDataLog = millis();
-    }
+    // Enregistrement binaire de chaque trame (écriture SD asynchrone)
+    logger.log(data);
 }
 
 void handleNormalOperation() {
@@ -174,15 +175,42 @@ void handleNormalOperation() {
     }
 }
 
+void setupAutomationActions() {
+    // Liaison des actions par type : valable aussi pour les règles rechargées
+    automationSystem.registerAction(ActionType::CHANGE_MODE,
+        [](const std::vector<String>& params, const SensorData&) {
+            if (params.empty()) return;
+            HuskyMode mode = static_cast<HuskyMode>(params[0].toInt());
+            huskyLens.setMode(mode);
+            processor.setMode(mode);
+            logger.logDebug("Automation : mode " + params[0]);
+        });
+    
+    automationSystem.registerAction(ActionType::CAPTURE_IMAGE,
+        [](const std::vector<String>& params, const SensorData&) {
+            String name = params.empty() ? String("capture") : params[0];
+            if (huskyLens.savePicture()) {
+                logger.logDebug("Automation : photo " + name);
+            } else {
+                logger.logError("Automation : échec de la photo " + name);
+            }
+        });
+    
+    automationSystem.registerAction(ActionType::SEND_NOTIFICATION,
+        [](const std::vector<String>& params, const SensorData&) {
+            String message = params.empty() ? String("Règle déclenchée") : params[0];
+            display.showError(message, true);
+            logger.logDebug("Automation : " + message);
+        });
+}
+
 void setupAutomationRules() {
     // Règle pour la détection d'objets multiples
     Rule multiObjectRule;
     multiObjectRule.name = "MultiObject";
     multiObjectRule.description = "Détection de plusieurs objets";
-    multiObjectRule.conditions.push_back(Condition(TriggerType::OBJECT_COUNT));
-    multiObjectRule.conditions.back().evaluator = AutomationSystem::objectCountAbove(2);
-    multiObjectRule.actions.push_back(Action(ActionType::SEND_NOTIFICATION));
-    multiObjectRule.actions.back().executor = AutomationSystem::sendNotification("Objets multiples détectés!");
+    multiObjectRule.conditions.push_back(AutomationSystem::objectCountAbove(2));
+    multiObjectRule.actions.push_back(AutomationSystem::sendNotification("Objets multiples détectés!"));
     
     automationSystem.addRule(multiObjectRule);
     
@@ -190,12 +218,20 @@ void setupAutomationRules() {
     Rule gestureRule;
     gestureRule.name = "GestureDetection";
     gestureRule.description = "Détection de gestes";
-    gestureRule.conditions.push_back(Condition(TriggerType::GESTURE_RECOGNIZED));
-    gestureRule.conditions.back().evaluator = AutomationSystem::gestureDetected("cercle");
-    gestureRule.actions.push_back(Action(ActionType::CHANGE_MODE));
-    gestureRule.actions.back().executor = AutomationSystem::changeMode(HuskyMode::FACE_RECOGNITION);
+    gestureRule.conditions.push_back(AutomationSystem::gestureDetected("cercle"));
+    gestureRule.actions.push_back(AutomationSystem::changeMode(HuskyMode::FACE_RECOGNITION));
     
     automationSystem.addRule(gestureRule);
+    
+    // Règle temporelle : balayage aller-retour
+    Rule swipeRule;
+    swipeRule.name = "SwipeBackAndForth";
+    swipeRule.description = "Balayage gauche puis droite en moins d'une seconde";
+    swipeRule.conditions.push_back(
+        AutomationSystem::when("gesture Gauche then gesture Droite within 1 s"));
+    swipeRule.actions.push_back(AutomationSystem::sendNotification("Aller-retour détecté"));
+    
+    automationSystem.addRule(swipeRule);
 }
 
 void setupMLModels() {
@@ -232,6 +268,9 @@ void setupObjectTemplates() {
 void setup() {
     M5.begin();
     
+    // Anneaux de trace (build avec -DTRACE_ENABLED uniquement)
+    TRACE_BEGIN();
+    
     // Initialisation des composants
     logger.begin();
     configManager.begin();
@@ -240,6 +279,28 @@ void setup() {
     // Charger la configuration
     config = configManager.loadConfig();
     
+    // Noyaux de vision répartis sur les deux cœurs (participant 0 : cette boucle)
+    jobSystem.begin();
+    objectRecognizer.setJobSystem(&jobSystem);
+    
+#ifdef JOB_SYSTEM_BENCHMARK
+    for (size_t workers = 1; workers <= jobSystem.getWorkerCount(); workers++) {
+        JobSystemBenchmark result = JobSystem::benchmark(jobSystem, workers, 200);
+        logger.logDebug("JobSystem " + String(result.workers) + " participant(s) : " +
+                        String(result.usPerRun, 1) + " us/convolution");
+    }
+#endif
+    
+#ifdef AUTOMATION_BENCHMARK
+    for (uint16_t rules : {16, 64, 256}) {
+        RuleProgramBenchmark result = RuleProgram::benchmark(rules, 1000);
+        logger.logDebug("RuleProgram " + String(result.rules) + " règles : " +
+                        String(result.usCompilePerRule, 1) + " us/règle compilée, " +
+                        String(result.usPerFrame, 1) + " us/trame, " +
+                        String(result.allocations) + " allocation(s)");
+    }
+#endif
+    
     // Initialiser les systèmes
     if (!objectRecognizer.begin()) {
         logger.logError("Échec de l'initialisation ObjectRecognizer");
@@ -256,6 +317,11 @@ void setup() {
     // Initialiser le WiFi si configuré
     if (config.autoLearn) {
         wifiManager.begin();
+        
+        // Export vers le collecteur si /telemetry.json l'active
+        if (telemetryPublisher.begin()) {
+            logger.logDebug("Export de télémétrie actif");
+        }
     }
     
     if (!huskyLens.begin()) {
@@ -267,8 +333,11 @@ void setup() {
     display.begin();
     processor.begin();
     
-    // Configuration des systèmes
-    setupAutomationRules();
+    // Configuration des systèmes : règles sauvegardées, sinon règles par défaut
+    setupAutomationActions();
+    if (!automationSystem.loadRules("/automation_rules.json")) {
+        setupAutomationRules();
+    }
     setupMLModels();
     setupObjectTemplates();
     
@@ -320,8 +389,18 @@ void handleMLPrediction(SensorData& data) {
 }
 
 void loop() {
+    TRACE_SCOPE("loop");
+    // Clôt la trame précédente (allocations par trame, suivi actif seulement)
+    HeapProfiler::markFrame();
     M5.update();
     
+#ifdef TRACE_ENABLED
+    // 't' sur le port série : trace Chrome (chrome://tracing, ui.perfetto.dev)
+    if (Serial.available() && Serial.read() == 't') {
+        TRACE_DUMP(Serial);
+    }
+#endif
+    
     if (inMenu) {
         handleMenu();
     } else {
@@ -0,0 +1,191 @@
+#include "RequestScheduler.h"
+#include "../performance/Trace.h"
+#include <ArduinoJson.h>
+
+RequestScheduler::RequestScheduler() :
+    highQueue(nullptr),
+    lowQueue(nullptr),
+    pending(nullptr),
+    workerHandle(nullptr),
+    stats{},
+    completed(0),
+    cancelled(0),
+    maxRunMs(0) {}
+
+RequestScheduler::~RequestScheduler() {
+    if (workerHandle) {
+        vTaskDelete(workerHandle);
+    }
+    
+    Ticket* ticket = nullptr;
+    for (QueueHandle_t queue : {highQueue, lowQueue}) {
+        while (queue && xQueueReceive(queue, &ticket, 0) == pdTRUE) {
+            delete ticket;
+        }
+        if (queue) vQueueDelete(queue);
+    }
+    if (pending) vSemaphoreDelete(pending);
+}
+
+bool RequestScheduler::begin(const RequestSchedulerConfig& newConfig) {
+    if (workerHandle) return true;
+    
+    config = newConfig;
+    highQueue = xQueueCreate(config.queueDepth, sizeof(Ticket*));
+    lowQueue = xQueueCreate(config.queueDepth, sizeof(Ticket*));
+    pending = xSemaphoreCreateCounting(config.queueDepth * 2, 0);
+    if (!highQueue || !lowQueue || !pending) {
+        return false;
+    }
+    
+    return xTaskCreatePinnedToCore(workerTask, "api_worker", config.workerStackSize, this,
+                                   config.workerPriority, &workerHandle,
+                                   config.workerCore) == pdPASS;
+}
+
+ArRequestHandlerFunction RequestScheduler::limit(ArRequestHandlerFunction handler, uint8_t cost) {
+    return [this, handler, cost](AsyncWebServerRequest* request) {
+        TRACE_SCOPE("http.handler");
+        if (admit(request, cost)) {
+            handler(request);
+        }
+    };
+}
+
+bool RequestScheduler::admit(AsyncWebServerRequest* request, uint8_t cost) {
+    uint32_t now = millis();
+    TokenBucket& bucket = bucketFor((uint32_t)request->client()->remoteIP(), now);
+    
+    bucket.tokens = std::min(config.burst,
+        bucket.tokens + (now - bucket.lastRefill) * config.tokensPerSecond / 1000.0f);
+    bucket.lastRefill = now;
+    
+    if (bucket.tokens < cost) {
+        stats.rateLimited++;
+        uint32_t retryAfter = (uint32_t)ceilf((cost - bucket.tokens) / config.tokensPerSecond);
+        sendRejection(request, 429, std::max<uint32_t>(retryAfter, 1), "Trop de requêtes");
+        return false;
+    }
+    
+    bucket.tokens -= cost;
+    stats.admitted++;
+    return true;
+}
+
+RequestScheduler::TokenBucket& RequestScheduler::bucketFor(uint32_t client, uint32_t now) {
+    auto it = buckets.find(client);
+    if (it != buckets.end()) {
+        return it->second;
+    }
+    
+    // Table pleine : on oublie le client inactif depuis le plus longtemps
+    if (buckets.size() >= MAX_CLIENTS) {
+        auto oldest = buckets.begin();
+        for (auto candidate = buckets.begin(); candidate != buckets.end(); ++candidate) {
+            if (now - candidate->second.lastRefill > now - oldest->second.lastRefill) {
+                oldest = candidate;
+            }
+        }
+        buckets.erase(oldest);
+    }
+    
+    TokenBucket& bucket = buckets[client];
+    bucket.tokens = config.burst;
+    bucket.lastRefill = now;
+    return bucket;
+}
+
+void RequestScheduler::defer(AsyncWebServerRequest* request, Priority priority, Work work) {
+    Ticket job = std::make_shared<DeferredJob>();
+    job->work = work;
+    job->done = false;
+    
+    // La file reçoit sa propre référence ; la réponse garde l'autre
+    Ticket* ticket = new Ticket(job);
+    QueueHandle_t queue = priority == PRIORITY_HIGH ? highQueue : lowQueue;
+    if (!workerHandle || xQueueSend(queue, &ticket, 0) != pdTRUE) {
+        delete ticket;
+        stats.rejectedBusy++;
+        sendRejection(request, 503, BUSY_RETRY_AFTER_S, "Serveur occupé");
+        return;
+    }
+    xSemaphoreGive(pending);
+    stats.deferred++;
+    
+    request->send(request->beginChunkedResponse("application/json",
+        [job](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            if (!job->done.load(std::memory_order_acquire)) {
+                return RESPONSE_TRY_AGAIN;
+            }
+            
+            size_t remaining = job->body.length() > index ? job->body.length() - index : 0;
+            size_t length = std::min(remaining, maxLen);
+            memcpy(buffer, job->body.c_str() + index, length);
+            return length;
+        }));
+}
+
+void RequestScheduler::runNext() {
+    Ticket* ticket = nullptr;
+    if (xQueueReceive(highQueue, &ticket, 0) != pdTRUE &&
+        xQueueReceive(lowQueue, &ticket, 0) != pdTRUE) {
+        return;
+    }
+    
+    // Seule référence restante : la réponse a été détruite (client parti)
+    DeferredJob& job = **ticket;
+    if (ticket->use_count() == 1) {
+        cancelled++;
+    } else {
+        uint32_t start = millis();
+        {
+            TRACE_SCOPE("http.deferred");
+            job.work(job.body);
+        }
+        if (job.body.length() == 0) {
+            job.body = "{}";
+        }
+        job.done.store(true, std::memory_order_release);
+        
+        uint32_t elapsed = millis() - start;
+        uint32_t previous = maxRunMs.load();
+        while (elapsed > previous && !maxRunMs.compare_exchange_weak(previous, elapsed)) {}
+        completed++;
+    }
+    delete ticket;
+}
+
+RequestSchedulerStats RequestScheduler::getStats() const {
+    RequestSchedulerStats result = stats;
+    result.completed = completed.load();
+    result.cancelled = cancelled.load();
+    result.maxRunMs = maxRunMs.load();
+    result.queued = (highQueue ? uxQueueMessagesWaiting(highQueue) : 0) +
+                    (lowQueue ? uxQueueMessagesWaiting(lowQueue) : 0);
+    result.clients = buckets.size();
+    return result;
+}
+
+void RequestScheduler::sendRejection(AsyncWebServerRequest* request, int code,
+                                     uint32_t retryAfter, const String& message) {
+    StaticJsonDocument<128> doc;
+    doc["success"] = false;
+    doc["message"] = message;
+    doc["retryAfter"] = retryAfter;
+    
+    String body;
+    serializeJson(doc, body);
+    AsyncWebServerResponse* response = request->beginResponse(code, "application/json", body);
+    response->addHeader("Retry-After", String(retryAfter));
+    request->send(response);
+}
+
+void RequestScheduler::workerTask(void* parameter) {
+    RequestScheduler* scheduler = static_cast<RequestScheduler*>(parameter);
+    
+    while (true) {
+        if (xSemaphoreTake(scheduler->pending, portMAX_DELAY) == pdTRUE) {
+            scheduler->runNext();
+        }
+    }
+}
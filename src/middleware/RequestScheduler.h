@@ -0,0 +1,117 @@
+#pragma once
+
+#include <ESPAsyncWebSrv.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+
+struct RequestSchedulerConfig {
+    float tokensPerSecond;     // Recharge du seau de chaque client
+    float burst;               // Capacité du seau
+    size_t queueDepth;         // Par niveau de priorité
+    uint32_t workerStackSize;
+    UBaseType_t workerPriority;
+    BaseType_t workerCore;
+    
+    RequestSchedulerConfig() :
+        tokensPerSecond(5.0f),
+        burst(10.0f),
+        queueDepth(4),
+        workerStackSize(6144),
+        workerPriority(1),
+        workerCore(0) {}
+};
+
+struct RequestSchedulerStats {
+    uint32_t admitted;
+    uint32_t rateLimited;      // Réponses 429
+    uint32_t rejectedBusy;     // Réponses 503 (file pleine)
+    uint32_t deferred;
+    uint32_t completed;
+    uint32_t cancelled;        // Client parti avant l'exécution
+    uint32_t queued;
+    uint32_t maxRunMs;
+    uint32_t clients;
+};
+
+// Répartition des requêtes API.
+// Les gestionnaires s'exécutent sur la tâche async_tcp (core 1, comme la
+// boucle de vision) : tout client passe par un seau à jetons (429 +
+// Retry-After quand il est vide), et les traitements lourds sont confiés
+// à une tâche ouvrière sur le core 0 via deux files bornées (haute
+// priorité servie d'abord ; 503 quand la file est pleine).
+// Une requête différée reçoit tout de suite une réponse chunked dont le
+// remplisseur attend le résultat (RESPONSE_TRY_AGAIN, repris au poll
+// TCP, soit ~500 ms au plus) ; si le client se déconnecte avant, le
+// travail est abandonné sans être exécuté.
+class RequestScheduler {
+public:
+    enum Priority : uint8_t {
+        PRIORITY_HIGH,
+        PRIORITY_LOW
+    };
+    
+    // Coût en jetons d'une requête
+    static const uint8_t COST_LIGHT = 1;
+    static const uint8_t COST_STREAM = 2;
+    static const uint8_t COST_HEAVY = 4;
+    
+    // Exécuté sur la tâche ouvrière ; body reçoit la réponse JSON
+    using Work = std::function<void(String& body)>;
+    
+    RequestScheduler();
+    ~RequestScheduler();
+    
+    bool begin(const RequestSchedulerConfig& config = RequestSchedulerConfig());
+    
+    // Gestionnaire soumis à la limite de débit (à passer à server.on)
+    ArRequestHandlerFunction limit(ArRequestHandlerFunction handler, uint8_t cost = COST_LIGHT);
+    
+    // Débite cost jetons ; sinon répond 429 et retourne false
+    bool admit(AsyncWebServerRequest* request, uint8_t cost);
+    
+    // À appeler depuis un gestionnaire : répond 503 si la file est pleine
+    void defer(AsyncWebServerRequest* request, Priority priority, Work work);
+    
+    RequestSchedulerStats getStats() const;
+    
+private:
+    static const size_t MAX_CLIENTS = 16;
+    static const uint32_t BUSY_RETRY_AFTER_S = 2;
+    
+    struct TokenBucket {
+        float tokens;
+        uint32_t lastRefill;
+    };
+    
+    struct DeferredJob {
+        Work work;
+        String body;
+        std::atomic<bool> done;
+    };
+    using Ticket = std::shared_ptr<DeferredJob>;
+    
+    RequestSchedulerConfig config;
+    QueueHandle_t highQueue;
+    QueueHandle_t lowQueue;
+    SemaphoreHandle_t pending;     // Nombre de tickets dans les deux files
+    TaskHandle_t workerHandle;
+    
+    // Seaux par adresse IP ; utilisés uniquement depuis la tâche async_tcp
+    std::map<uint32_t, TokenBucket> buckets;
+    
+    RequestSchedulerStats stats;
+    std::atomic<uint32_t> completed;
+    std::atomic<uint32_t> cancelled;
+    std::atomic<uint32_t> maxRunMs;
+    
+    TokenBucket& bucketFor(uint32_t client, uint32_t now);
+    void runNext();
+    static void sendRejection(AsyncWebServerRequest* request, int code,
+                              uint32_t retryAfter, const String& message);
+    static void workerTask(void* parameter);
+};
@@ -1,6 +1,9 @@
 #include "MetaLearningSystem.h"
+#include "MetaSearchScheduler.h"
 #include <SPIFFS.h>
 #include <ArduinoJson.h>
+#include <algorithm>
+#include <cmath>
 
 MetaLearningSystem::MetaLearningSystem() {}
 
@@ -15,20 +18,42 @@ void MetaLearningSystem::addMetaModel(const String& name,
     MetaModel model;
     model.name = name;
     model.architecture = architecture;
+    initializeWeights(model);
     
-    // Initialiser les poids aléatoirement
-    int num_weights = 0;
-    for (size_t i = 1; i < architecture.size(); i++) {
-        num_weights += architecture[i-1] * architecture[i]; // Poids
-        num_weights += architecture[i];                     // Biais
+    m_models[name] = model;
+}
+
+void MetaLearningSystem::removeMetaModel(const String& name) {
+    m_models.erase(name);
+    m_learning_curves.erase(name);
+}
+
+void MetaLearningSystem::addTask(const LearningTask& task) {
+    m_tasks[task.name] = task;
+}
+
+void MetaLearningSystem::removeTask(const String& name) {
+    m_tasks.erase(name);
+}
+
+std::vector<String> MetaLearningSystem::listTasks() const {
+    std::vector<String> names;
+    for (const auto& task : m_tasks) {
+        names.push_back(task.first);
     }
-    
-    model.weights.resize(num_weights);
-    for (float& w : model.weights) {
-        w = (esp_random() / (float)UINT32_MAX) * 2.0f - 1.0f;
+    return names;
+}
+
+void MetaLearningSystem::setConfig(const MetaLearningConfig& config) {
+    m_config = config;
+    // Forcer la réallocation si la taille de lot change
+    if (m_workspace.max_batch != m_config.max_batch_size) {
+        deallocateBuffers();
     }
-    
-    m_models[name] = model;
+}
+
+MetaLearningConfig MetaLearningSystem::getConfig() const {
+    return m_config;
 }
 
 void MetaLearningSystem::trainMetaModel(const String& model_name,
@@ -37,41 +62,683 @@ void MetaLearningSystem::trainMetaModel(const String& model_name,
     if (it == m_models.end()) return;
     
     MetaModel& model = it->second;
-    std::vector<LearningTask> tasks;
+    std::vector<const LearningTask*> tasks = collectTasks(model, task_names);
+    if (tasks.empty()) return;
+    
+    std::vector<float>& curve = m_learning_curves[model_name];
+    curve.clear();
+    
+    runMetaTraining(model, tasks, m_config.num_outer_steps, &curve);
+    model.performance = evaluateTasks(model, tasks);
+}
+
+std::vector<float> MetaLearningSystem::adapt(const String& model_name,
+                                           const LearningTask& task,
+                                           int num_steps) {
+    auto it = m_models.find(model_name);
+    if (it == m_models.end()) return {};
+    
+    const MetaModel& model = it->second;
+    if (!isTaskCompatible(model, task)) return model.weights;
+    
+    allocateBuffers(model);
+    std::vector<float> adapted(model.weights.size());
+    adaptWeights(model, task, num_steps, adapted.data());
+    return adapted;
+}
+
+float MetaLearningSystem::evaluate(const String& model_name,
+                                const LearningTask& task) {
+    auto it = m_models.find(model_name);
+    if (it == m_models.end()) return 0.0f;
+    
+    return evaluateTask(it->second, task);
+}
+
+void MetaLearningSystem::setSearchConfig(const MetaSearchConfig& config) {
+    m_search_config = config;
+}
+
+MetaSearchConfig MetaLearningSystem::getSearchConfig() const {
+    return m_search_config;
+}
+
+void MetaLearningSystem::optimizeHyperparameters(const String& model_name,
+                                               const std::vector<String>& task_names) {
+    auto it = m_models.find(model_name);
+    if (it == m_models.end()) return;
+    
+    std::vector<const LearningTask*> tasks = collectTasks(it->second, task_names);
+    if (tasks.empty()) return;
+    
+    // Tirage aléatoire (log-uniforme pour les taux) autour de l'architecture fixée
+    auto logUniform = [](float low, float high) {
+        float r = esp_random() / (float)UINT32_MAX;
+        return expf(logf(low) + r * (logf(high) - logf(low)));
+    };
+    
+    std::vector<SearchTrial> trials(std::max(1, m_search_config.num_candidates));
+    for (size_t i = 0; i < trials.size(); i++) {
+        SearchTrial& trial = trials[i];
+        trial.model = it->second;
+        trial.config = m_config;
+        
+        // Le premier candidat conserve la configuration courante
+        if (i == 0) continue;
+        trial.config.inner_learning_rate = logUniform(0.001f, 0.2f);
+        trial.config.outer_learning_rate = logUniform(0.0001f, 0.01f);
+        trial.config.num_inner_steps = 1 + esp_random() % 8;
+        trial.config.algorithm = (esp_random() & 1) ? "maml" : "reptile";
+    }
+    
+    MetaSearchScheduler scheduler(m_search_config);
+    int best = scheduler.run(trials, tasks);
+    if (best < 0) return;
+    
+    // Seuls les hyperparamètres sont retenus, pas les poids de l'essai
+    MetaLearningConfig config = m_config;
+    config.inner_learning_rate = trials[best].config.inner_learning_rate;
+    config.outer_learning_rate = trials[best].config.outer_learning_rate;
+    config.num_inner_steps = trials[best].config.num_inner_steps;
+    config.algorithm = trials[best].config.algorithm;
+    setConfig(config);
+}
+
+void MetaLearningSystem::searchArchitecture(const String& model_name,
+                                          const std::vector<String>& task_names) {
+    auto it = m_models.find(model_name);
+    if (it == m_models.end()) return;
+    
+    MetaModel& model = it->second;
+    if (model.architecture.size() < 2) return;
     
-    // Collecter les tâches
+    std::vector<const LearningTask*> tasks = collectTasks(model, task_names);
+    if (tasks.empty()) return;
+    
+    // Entrée et sortie fixées, 1 ou 2 couches cachées de largeur variable
+    static const int WIDTHS[] = {16, 32, 64, 128};
+    const int input_dim = model.architecture.front();
+    const int outputs = model.architecture.back();
+    
+    std::vector<SearchTrial> trials(std::max(1, m_search_config.num_candidates));
+    for (size_t i = 0; i < trials.size(); i++) {
+        SearchTrial& trial = trials[i];
+        trial.config = m_config;
+        trial.model.name = model.name;
+        trial.model.learning_rate = model.learning_rate;
+        trial.model.meta_learning_rate = model.meta_learning_rate;
+        
+        if (i == 0) {
+            trial.model.architecture = model.architecture;
+        } else {
+            trial.model.architecture.push_back(input_dim);
+            int hidden_layers = 1 + esp_random() % 2;
+            for (int l = 0; l < hidden_layers; l++) {
+                trial.model.architecture.push_back(WIDTHS[esp_random() % 4]);
+            }
+            trial.model.architecture.push_back(outputs);
+        }
+        initializeWeights(trial.model);
+    }
+    
+    MetaSearchScheduler scheduler(m_search_config);
+    int best = scheduler.run(trials, tasks);
+    if (best < 0) return;
+    
+    // Remplacer le modèle par le meilleur candidat entraîné
+    model.architecture = trials[best].model.architecture;
+    model.weights = trials[best].model.weights;
+    model.training_steps = trials[best].model.training_steps;
+    model.performance = trials[best].score;
+    deallocateBuffers();
+}
+
+float MetaLearningSystem::getMeanPerformance(const String& model_name) const {
+    auto it = m_models.find(model_name);
+    return it != m_models.end() ? it->second.performance : 0.0f;
+}
+
+std::vector<float> MetaLearningSystem::getLearningCurve(const String& model_name) const {
+    auto it = m_learning_curves.find(model_name);
+    if (it == m_learning_curves.end()) return {};
+    return it->second;
+}
+
+void MetaLearningSystem::initializeWeights(MetaModel& model) {
+    // Xavier uniforme pour les poids, biais à zéro
+    const std::vector<int>& architecture = model.architecture;
+    model.weights.clear();
+    
+    for (size_t i = 1; i < architecture.size(); i++) {
+        int fan_in = architecture[i-1];
+        int fan_out = architecture[i];
+        float limit = sqrtf(6.0f / (fan_in + fan_out));
+        
+        for (int j = 0; j < fan_in * fan_out; j++) {
+            float r = esp_random() / (float)UINT32_MAX;
+            model.weights.push_back((r * 2.0f - 1.0f) * limit);
+        }
+        model.weights.insert(model.weights.end(), fan_out, 0.0f);
+    }
+}
+
+std::vector<const LearningTask*> MetaLearningSystem::collectTasks(const MetaModel& model,
+                                                                const std::vector<String>& task_names) const {
+    // Seules les tâches compatibles avec l'architecture sont retenues
+    std::vector<const LearningTask*> tasks;
     for (const auto& name : task_names) {
         auto task_it = m_tasks.find(name);
-        if (task_it != m_tasks.end()) {
-            tasks.push_back(task_it->second);
+        if (task_it != m_tasks.end() && isTaskCompatible(model, task_it->second)) {
+            tasks.push_back(&task_it->second);
         }
     }
+    return tasks;
+}
+
+void MetaLearningSystem::runMetaTraining(MetaModel& model,
+                                       const std::vector<const LearningTask*>& tasks,
+                                       int num_steps, std::vector<float>* curve) {
+    if (tasks.empty() || model.architecture.size() < 2) return;
+    
+    allocateBuffers(model);
+    std::fill(m_workspace.adam_m.begin(), m_workspace.adam_m.end(), 0.0f);
+    std::fill(m_workspace.adam_v.begin(), m_workspace.adam_v.end(), 0.0f);
+    m_workspace.adam_step = 0;
     
-    // Méta-apprentissage factice pour la démo
-    for (int step = 0; step < m_config.num_outer_steps; step++) {
-        // Mise à jour aléatoire des poids
-        for (float& w : model.weights) {
-            w += ((esp_random() / (float)UINT32_MAX) * 2.0f - 1.0f) * 0.1f;
+    // Boucle externe : un méta-lot de tâches tirées au hasard par étape
+    int batch_size = std::max(1, std::min(m_config.meta_batch_size, (int)tasks.size()));
+    std::vector<const LearningTask*> batch(batch_size);
+    
+    for (int step = 0; step < num_steps; step++) {
+        for (int i = 0; i < batch_size; i++) {
+            batch[i] = tasks[esp_random() % tasks.size()];
         }
         
-        // Enregistrer la courbe d'apprentissage
-        if (step % 10 == 0) {
-            float loss = static_cast<float>(step) / m_config.num_outer_steps;
-            m_learning_curves.back().push_back(loss);
+        outerLoop(model, batch);
+        model.training_steps++;
+        
+        // Enregistrer la courbe d'apprentissage (perte sur les requêtes)
+        if (curve && (step % 10 == 0 || step == num_steps - 1)) {
+            curve->push_back(computeMetaLoss(model, batch));
         }
     }
+}
+
+float MetaLearningSystem::evaluateTask(const MetaModel& model, const LearningTask& task) {
+    if (task.query_set.empty() || !isTaskCompatible(model, task)) return 0.0f;
+    
+    // Adapter sur le support puis mesurer la précision sur les requêtes
+    allocateBuffers(model);
+    float* fast = m_workspace.fast_weights.data();
+    adaptWeights(model, task, m_config.num_inner_steps, fast);
     
-    // Évaluer les performances finales
-    model.performance = evaluate(model_name, tasks[0]);
+    const int* query_targets = task.labels.data() + task.support_set.size();
+    return computeAccuracy(model, fast, task.query_set, query_targets, task.is_regression);
 }
 
-float MetaLearningSystem::evaluate(const String& model_name,
-                                const LearningTask& task) {
-    auto it = m_models.find(model_name);
-    if (it == m_models.end()) return 0.0f;
+float MetaLearningSystem::evaluateTasks(const MetaModel& model,
+                                      const std::vector<const LearningTask*>& tasks) {
+    if (tasks.empty()) return 0.0f;
+    
+    float total = 0.0f;
+    for (const LearningTask* task : tasks) {
+        total += evaluateTask(model, *task);
+    }
+    return total / tasks.size();
+}
+
+size_t MetaLearningSystem::estimateWorkspaceBytes(const std::vector<int>& architecture,
+                                                int max_batch) {
+    size_t units = 0;
+    size_t weights = 0;
+    int max_layer = 0;
+    
+    for (size_t l = 0; l < architecture.size(); l++) {
+        units += architecture[l];
+        max_layer = std::max(max_layer, architecture[l]);
+        if (l > 0) {
+            weights += architecture[l-1] * architecture[l] + architecture[l];
+        }
+    }
+    
+    // Activations + deltas + 6 vecteurs de la taille des poids + le modèle lui-même
+    size_t floats = units * max_batch + 2 * max_layer * max_batch + 7 * weights;
+    return floats * sizeof(float);
+}
+
+void MetaLearningSystem::innerLoop(const MetaModel& model, const LearningTask& task) {
+    adaptWeights(model, task, m_config.num_inner_steps, m_workspace.fast_weights.data());
+}
+
+void MetaLearningSystem::outerLoop(MetaModel& model,
+                                 const std::vector<const LearningTask*>& tasks) {
+    std::vector<float> gradients = computeMetaGradient(model, tasks);
+    updateMetaParameters(model, gradients);
+}
+
+std::vector<float> MetaLearningSystem::computeMetaGradient(const MetaModel& model,
+                                                         const std::vector<const LearningTask*>& tasks) {
+    MetaWorkspace& ws = m_workspace;
+    const size_t n = ws.num_weights;
+    float* meta = ws.meta_gradients.data();
+    std::fill(meta, meta + n, 0.0f);
+    if (tasks.empty()) return ws.meta_gradients;
+    
+    const bool reptile = m_config.algorithm == "reptile";
+    const float scale = 1.0f / tasks.size();
+    
+    for (const LearningTask* task : tasks) {
+        innerLoop(model, *task);
+        const float* fast = ws.fast_weights.data();
+        
+        if (reptile) {
+            // Reptile : direction (phi - theta') moyennée sur le méta-lot
+            for (size_t i = 0; i < n; i++) {
+                meta[i] += (model.weights[i] - fast[i]) * scale;
+            }
+        } else {
+            // MAML premier ordre : gradient de la perte requête aux poids adaptés
+            const int* targets = task->labels.data() + task->support_set.size();
+            const std::vector<std::vector<float>>& set =
+                task->query_set.empty() ? task->support_set : task->query_set;
+            if (task->query_set.empty()) targets = task->labels.data();
+            
+            computeLossAndGradient(model, fast, set, targets, task->is_regression,
+                                  ws.gradients.data());
+            for (size_t i = 0; i < n; i++) {
+                meta[i] += ws.gradients[i] * scale;
+            }
+        }
+    }
+    
+    return ws.meta_gradients;
+}
+
+float MetaLearningSystem::computeMetaLoss(const MetaModel& model,
+                                        const std::vector<const LearningTask*>& tasks) {
+    if (tasks.empty()) return 0.0f;
+    
+    float total = 0.0f;
+    int counted = 0;
+    for (const LearningTask* task : tasks) {
+        if (task->query_set.empty()) continue;
+        
+        float* fast = m_workspace.fast_weights.data();
+        adaptWeights(model, *task, m_config.num_inner_steps, fast);
+        const int* targets = task->labels.data() + task->support_set.size();
+        total += computeLossAndGradient(model, fast, task->query_set, targets,
+                                        task->is_regression, nullptr);
+        counted++;
+    }
+    return counted > 0 ? total / counted : 0.0f;
+}
+
+void MetaLearningSystem::updateMetaParameters(MetaModel& model,
+                                            const std::vector<float>& gradients) {
+    if (m_config.optimizer != "adam") {
+        updateModelWeights(model, gradients, m_config.outer_learning_rate);
+        return;
+    }
+    
+    // Adam sur le méta-gradient
+    const float beta1 = 0.9f;
+    const float beta2 = 0.999f;
+    const float epsilon = 1e-8f;
+    MetaWorkspace& ws = m_workspace;
+    ws.adam_step++;
+    
+    float correction1 = 1.0f - powf(beta1, ws.adam_step);
+    float correction2 = 1.0f - powf(beta2, ws.adam_step);
+    float lr = m_config.outer_learning_rate * sqrtf(correction2) / correction1;
+    
+    for (size_t i = 0; i < model.weights.size(); i++) {
+        float g = gradients[i];
+        ws.adam_m[i] = beta1 * ws.adam_m[i] + (1.0f - beta1) * g;
+        ws.adam_v[i] = beta2 * ws.adam_v[i] + (1.0f - beta2) * g * g;
+        model.weights[i] -= lr * ws.adam_m[i] / (sqrtf(ws.adam_v[i]) + epsilon);
+    }
+}
+
+void MetaLearningSystem::allocateBuffers(const MetaModel& model) {
+    if (m_architecture_allocated == model.architecture &&
+        m_workspace.max_batch == m_config.max_batch_size) {
+        return;
+    }
+    
+    MetaWorkspace& ws = m_workspace;
+    ws.max_batch = std::max(1, m_config.max_batch_size);
+    ws.layer_offsets.clear();
+    ws.weight_offsets.clear();
+    ws.max_layer = 0;
+    ws.num_weights = 0;
+    
+    size_t total_units = 0;
+    for (size_t l = 0; l < model.architecture.size(); l++) {
+        int units = model.architecture[l];
+        ws.layer_offsets.push_back(total_units * ws.max_batch);
+        total_units += units;
+        ws.max_layer = std::max(ws.max_layer, units);
+        
+        if (l > 0) {
+            ws.weight_offsets.push_back(ws.num_weights);
+            ws.num_weights += model.architecture[l-1] * units + units;
+        }
+    }
+    
+    ws.activations.assign(total_units * ws.max_batch, 0.0f);
+    ws.deltas.assign(2 * ws.max_layer * ws.max_batch, 0.0f);
+    ws.fast_weights.assign(ws.num_weights, 0.0f);
+    ws.gradients.assign(ws.num_weights, 0.0f);
+    ws.meta_gradients.assign(ws.num_weights, 0.0f);
+    ws.adam_m.assign(ws.num_weights, 0.0f);
+    ws.adam_v.assign(ws.num_weights, 0.0f);
+    ws.adam_step = 0;
+    
+    m_architecture_allocated = model.architecture;
+}
+
+void MetaLearningSystem::deallocateBuffers() {
+    m_workspace = MetaWorkspace();
+    m_architecture_allocated.clear();
+}
+
+std::vector<float> MetaLearningSystem::forward(const MetaModel& model,
+                                             const std::vector<float>& input) {
+    if (model.architecture.size() < 2 ||
+        (int)input.size() != model.architecture.front()) {
+        return {};
+    }
+    
+    allocateBuffers(model);
+    std::copy(input.begin(), input.end(),
+              m_workspace.activations.begin() + m_workspace.layer_offsets[0]);
+    forwardBatch(model, model.weights.data(), 1);
+    
+    const size_t last = model.architecture.size() - 1;
+    const float* out = m_workspace.activations.data() + m_workspace.layer_offsets[last];
+    std::vector<float> output(out, out + model.architecture[last]);
+    
+    // Probabilités softmax pour la classification
+    if (output.size() > 1) {
+        float max_logit = *std::max_element(output.begin(), output.end());
+        float sum = 0.0f;
+        for (float& o : output) {
+            o = expf(o - max_logit);
+            sum += o;
+        }
+        for (float& o : output) {
+            o /= sum;
+        }
+    }
+    return output;
+}
+
+std::vector<float> MetaLearningSystem::backward(const MetaModel& model,
+                                              const std::vector<float>& gradients) {
+    // Rétropropage dL/dsortie du dernier forward() jusqu'aux poids
+    if (m_architecture_allocated != model.architecture ||
+        (int)gradients.size() != model.architecture.back()) {
+        return {};
+    }
+    
+    std::copy(gradients.begin(), gradients.end(), m_workspace.deltas.begin());
+    std::vector<float> weight_gradients(m_workspace.num_weights, 0.0f);
+    backwardBatch(model, model.weights.data(), 1, weight_gradients.data());
+    return weight_gradients;
+}
+
+void MetaLearningSystem::updateModelWeights(MetaModel& model,
+                                          const std::vector<float>& gradients,
+                                          float learning_rate) {
+    size_t n = std::min(model.weights.size(), gradients.size());
+    for (size_t i = 0; i < n; i++) {
+        model.weights[i] -= learning_rate * gradients[i];
+    }
+}
+
+bool MetaLearningSystem::isTaskCompatible(const MetaModel& model,
+                                        const LearningTask& task) const {
+    if (model.architecture.size() < 2 || task.support_set.empty()) return false;
+    
+    size_t expected_weights = 0;
+    for (size_t l = 1; l < model.architecture.size(); l++) {
+        expected_weights += model.architecture[l-1] * model.architecture[l] + model.architecture[l];
+    }
+    if (model.weights.size() != expected_weights) return false;
+    if (task.labels.size() < task.support_set.size() + task.query_set.size()) return false;
+    
+    const int input_dim = model.architecture.front();
+    const int outputs = model.architecture.back();
+    
+    for (const auto& sample : task.support_set) {
+        if ((int)sample.size() != input_dim) return false;
+    }
+    for (const auto& sample : task.query_set) {
+        if ((int)sample.size() != input_dim) return false;
+    }
+    
+    if (!task.is_regression) {
+        for (int label : task.labels) {
+            if (label < 0 || label >= outputs) return false;
+        }
+    }
+    return true;
+}
+
+void MetaLearningSystem::packBatch(const std::vector<std::vector<float>>& set,
+                                 size_t start, int count) {
+    const int input_dim = m_architecture_allocated.front();
+    float* dst = m_workspace.activations.data() + m_workspace.layer_offsets[0];
+    
+    for (int b = 0; b < count; b++) {
+        memcpy(dst + b * input_dim, set[start + b].data(), input_dim * sizeof(float));
+    }
+}
+
+void MetaLearningSystem::forwardBatch(const MetaModel& model, const float* weights, int count) {
+    const std::vector<int>& arch = model.architecture;
+    float* act = m_workspace.activations.data();
+    
+    for (size_t l = 1; l < arch.size(); l++) {
+        const int in = arch[l-1];
+        const int out = arch[l];
+        const float* W = weights + m_workspace.weight_offsets[l-1];
+        const float* B = W + in * out;
+        const float* A = act + m_workspace.layer_offsets[l-1];
+        float* Z = act + m_workspace.layer_offsets[l];
+        const bool hidden = l < arch.size() - 1;
+        
+        // Z = A * W^T + B, ReLU sur les couches cachées
+        for (int b = 0; b < count; b++) {
+            const float* a = A + b * in;
+            float* z = Z + b * out;
+            for (int j = 0; j < out; j++) {
+                const float* w = W + j * in;
+                float sum = B[j];
+                for (int k = 0; k < in; k++) {
+                    sum += w[k] * a[k];
+                }
+                z[j] = (hidden && sum < 0.0f) ? 0.0f : sum;
+            }
+        }
+    }
+}
+
+void MetaLearningSystem::backwardBatch(const MetaModel& model, const float* weights,
+                                     int count, float* gradients) {
+    // Les deltas de la couche de sortie sont attendus dans la première moitié
+    // de m_workspace.deltas ; les gradients sont accumulés dans 'gradients'.
+    const std::vector<int>& arch = model.architecture;
+    const float* act = m_workspace.activations.data();
+    float* current = m_workspace.deltas.data();
+    float* next = current + m_workspace.max_layer * m_workspace.max_batch;
     
-    // Retourner une performance factice pour la démo
-    return 0.75f + ((esp_random() / (float)UINT32_MAX) * 0.1f);
+    for (size_t l = arch.size() - 1; l >= 1; l--) {
+        const int in = arch[l-1];
+        const int out = arch[l];
+        const float* W = weights + m_workspace.weight_offsets[l-1];
+        float* gW = gradients + m_workspace.weight_offsets[l-1];
+        float* gB = gW + in * out;
+        const float* A = act + m_workspace.layer_offsets[l-1];
+        
+        for (int b = 0; b < count; b++) {
+            const float* d = current + b * out;
+            const float* a = A + b * in;
+            for (int j = 0; j < out; j++) {
+                float dj = d[j];
+                if (dj == 0.0f) continue;
+                gB[j] += dj;
+                float* gw = gW + j * in;
+                for (int k = 0; k < in; k++) {
+                    gw[k] += dj * a[k];
+                }
+            }
+        }
+        
+        if (l == 1) break;
+        
+        // Propager vers la couche précédente (dérivée ReLU)
+        for (int b = 0; b < count; b++) {
+            const float* d = current + b * out;
+            const float* a = A + b * in;
+            float* nd = next + b * in;
+            std::fill(nd, nd + in, 0.0f);
+            
+            for (int j = 0; j < out; j++) {
+                float dj = d[j];
+                if (dj == 0.0f) continue;
+                const float* w = W + j * in;
+                for (int k = 0; k < in; k++) {
+                    nd[k] += dj * w[k];
+                }
+            }
+            for (int k = 0; k < in; k++) {
+                if (a[k] <= 0.0f) nd[k] = 0.0f;
+            }
+        }
+        std::swap(current, next);
+    }
+}
+
+float MetaLearningSystem::computeOutputDeltas(const MetaModel& model, const int* targets,
+                                            int count, float scale, bool is_regression) {
+    const size_t last = model.architecture.size() - 1;
+    const int out = model.architecture[last];
+    const float* Z = m_workspace.activations.data() + m_workspace.layer_offsets[last];
+    float* D = m_workspace.deltas.data();
+    float loss = 0.0f;
+    
+    for (int b = 0; b < count; b++) {
+        const float* z = Z + b * out;
+        float* d = D + b * out;
+        
+        if (is_regression) {
+            // Erreur quadratique sur la première sortie
+            float diff = z[0] - (float)targets[b];
+            loss += 0.5f * diff * diff;
+            std::fill(d, d + out, 0.0f);
+            d[0] = diff * scale;
+            continue;
+        }
+        
+        // Softmax + entropie croisée
+        float max_logit = z[0];
+        for (int j = 1; j < out; j++) max_logit = std::max(max_logit, z[j]);
+        
+        float sum = 0.0f;
+        for (int j = 0; j < out; j++) {
+            d[j] = expf(z[j] - max_logit);
+            sum += d[j];
+        }
+        
+        float inv_sum = 1.0f / sum;
+        for (int j = 0; j < out; j++) {
+            d[j] *= inv_sum;
+        }
+        loss -= logf(std::max(d[targets[b]], 1e-7f));
+        
+        for (int j = 0; j < out; j++) {
+            d[j] = (d[j] - (j == targets[b] ? 1.0f : 0.0f)) * scale;
+        }
+    }
+    
+    return loss;
+}
+
+float MetaLearningSystem::computeLossAndGradient(const MetaModel& model, const float* weights,
+                                               const std::vector<std::vector<float>>& set,
+                                               const int* targets, bool is_regression,
+                                               float* gradients) {
+    // gradients == nullptr : calcul de la perte seule
+    if (gradients) {
+        std::fill(gradients, gradients + m_workspace.num_weights, 0.0f);
+    }
+    if (set.empty()) return 0.0f;
+    
+    const float scale = 1.0f / set.size();
+    float loss = 0.0f;
+    
+    for (size_t start = 0; start < set.size(); start += m_workspace.max_batch) {
+        int count = std::min((size_t)m_workspace.max_batch, set.size() - start);
+        packBatch(set, start, count);
+        forwardBatch(model, weights, count);
+        loss += computeOutputDeltas(model, targets + start, count, scale, is_regression);
+        if (gradients) {
+            backwardBatch(model, weights, count, gradients);
+        }
+    }
+    
+    return loss * scale;
+}
+
+float MetaLearningSystem::computeAccuracy(const MetaModel& model, const float* weights,
+                                        const std::vector<std::vector<float>>& set,
+                                        const int* targets, bool is_regression) {
+    if (set.empty()) return 0.0f;
+    
+    const size_t last = model.architecture.size() - 1;
+    const int out = model.architecture[last];
+    const float* Z = m_workspace.activations.data() + m_workspace.layer_offsets[last];
+    int correct = 0;
+    float squared_error = 0.0f;
+    
+    for (size_t start = 0; start < set.size(); start += m_workspace.max_batch) {
+        int count = std::min((size_t)m_workspace.max_batch, set.size() - start);
+        packBatch(set, start, count);
+        forwardBatch(model, weights, count);
+        
+        for (int b = 0; b < count; b++) {
+            const float* z = Z + b * out;
+            if (is_regression) {
+                float diff = z[0] - (float)targets[start + b];
+                squared_error += diff * diff;
+            } else {
+                int predicted = std::max_element(z, z + out) - z;
+                if (predicted == targets[start + b]) correct++;
+            }
+        }
+    }
+    
+    // Régression : score dans ]0, 1] dérivé de l'erreur quadratique moyenne
+    if (is_regression) {
+        return 1.0f / (1.0f + squared_error / set.size());
+    }
+    return (float)correct / set.size();
+}
+
+void MetaLearningSystem::adaptWeights(const MetaModel& model, const LearningTask& task,
+                                    int num_steps, float* fast_weights) {
+    const size_t n = m_workspace.num_weights;
+    std::copy(model.weights.begin(), model.weights.begin() + n, fast_weights);
+    
+    float* gradients = m_workspace.gradients.data();
+    for (int step = 0; step < num_steps; step++) {
+        computeLossAndGradient(model, fast_weights, task.support_set, task.labels.data(),
+                               task.is_regression, gradients);
+        for (size_t i = 0; i < n; i++) {
+            fast_weights[i] -= m_config.inner_learning_rate * gradients[i];
+        }
+    }
 }
 
 bool MetaLearningSystem::saveMetaModel(const String& name, const String& path) {
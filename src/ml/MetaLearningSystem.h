@@ -27,6 +27,8 @@ struct MetaModel {
 };
 
 // Structure pour une tâche d'apprentissage
+// Les étiquettes couvrent d'abord le support_set puis le query_set
+// (labels.size() == support_set.size() + query_set.size()).
 struct LearningTask {
     String name;
     std::vector<std::vector<float>> support_set;
@@ -52,6 +54,8 @@ struct MetaLearningConfig {
     bool use_first_order;
     bool use_meta_sgd;
     String optimizer;
+    String algorithm;       // "maml" (premier ordre) ou "reptile"
+    int max_batch_size;     // Taille max d'un lot dans l'espace de travail
     
     MetaLearningConfig() :
         num_inner_steps(5),
@@ -61,10 +65,58 @@ struct MetaLearningConfig {
         outer_learning_rate(0.001f),
         use_first_order(true),
         use_meta_sgd(false),
-        optimizer("adam") {}
+        optimizer("adam"),
+        algorithm("maml"),
+        max_batch_size(32) {}
+};
+
+// Configuration de la recherche (successive halving)
+struct MetaSearchConfig {
+    int num_candidates;         // Configurations évaluées au premier palier
+    int eta;                    // Facteur de réduction entre paliers
+    int min_steps;              // Budget (pas externes) du premier palier
+    int max_steps;              // Budget maximal d'un palier
+    int num_workers;            // Tâches de travail (une par cœur sur le S3 ; 0 : une par cœur de l'hôte)
+    uint32_t worker_stack_size;
+    uint32_t worker_priority;   // Priorité FreeRTOS des tâches de travail
+    size_t trial_memory_limit;  // Mémoire max par essai (octets)
+    float validation_fraction;  // Part des tâches réservée au classement des essais
+    
+    MetaSearchConfig() :
+        num_candidates(8),
+        eta(2),
+        min_steps(10),
+        max_steps(80),
+        num_workers(2),
+        worker_stack_size(8192),
+        worker_priority(1),
+        trial_memory_limit(96 * 1024),
+        validation_fraction(0.25f) {}
+};
+
+// Espace de travail pré-alloué pour les passes forward/backward par lots.
+// Toutes les matrices sont contiguës, en ligne majeure (un exemple par ligne).
+struct MetaWorkspace {
+    std::vector<float> activations;   // max_batch x somme des couches (entrée incluse)
+    std::vector<float> deltas;        // 2 x max_batch x plus grande couche
+    std::vector<float> fast_weights;  // Poids adaptés par la boucle interne
+    std::vector<float> gradients;     // Gradient d'un lot
+    std::vector<float> meta_gradients;// Accumulateur de la boucle externe
+    std::vector<float> adam_m;        // Moments de l'optimiseur externe
+    std::vector<float> adam_v;
+    std::vector<size_t> layer_offsets; // Début de chaque couche dans activations
+    std::vector<size_t> weight_offsets;// Début de chaque couche dans les poids
+    int max_batch;
+    int max_layer;
+    size_t num_weights;
+    uint32_t adam_step;
+    
+    MetaWorkspace() : max_batch(0), max_layer(0), num_weights(0), adam_step(0) {}
 };
 
 class MetaLearningSystem {
+    friend class MetaSearchScheduler;
+    
 public:
     MetaLearningSystem();
     bool begin();
@@ -92,6 +144,8 @@ public:
     // Configuration
     void setConfig(const MetaLearningConfig& config);
     MetaLearningConfig getConfig() const;
+    void setSearchConfig(const MetaSearchConfig& config);
+    MetaSearchConfig getSearchConfig() const;
     
     // Optimisation
     void optimizeHyperparameters(const String& model_name,
@@ -111,9 +165,12 @@ public:
 
 private:
     MetaLearningConfig m_config;
+    MetaSearchConfig m_search_config;
     std::map<String, MetaModel> m_models;
     std::map<String, LearningTask> m_tasks;
-    std::vector<std::vector<float>> m_learning_curves;
+    std::map<String, std::vector<float>> m_learning_curves;
+    MetaWorkspace m_workspace;
+    std::vector<int> m_architecture_allocated;
     
 #ifndef TENSORFLOW_LITE_DISABLE
     // TensorFlow Lite
@@ -125,14 +182,22 @@ private:
 #endif
     
     // Méta-apprentissage interne
-    void innerLoop(MetaModel& model, const LearningTask& task);
-    void outerLoop(MetaModel& model, const std::vector<LearningTask>& tasks);
+    void initializeWeights(MetaModel& model);
+    std::vector<const LearningTask*> collectTasks(const MetaModel& model,
+                                                 const std::vector<String>& task_names) const;
+    void runMetaTraining(MetaModel& model, const std::vector<const LearningTask*>& tasks,
+                        int num_steps, std::vector<float>* curve);
+    float evaluateTask(const MetaModel& model, const LearningTask& task);
+    float evaluateTasks(const MetaModel& model, const std::vector<const LearningTask*>& tasks);
+    static size_t estimateWorkspaceBytes(const std::vector<int>& architecture, int max_batch);
+    void innerLoop(const MetaModel& model, const LearningTask& task);
+    void outerLoop(MetaModel& model, const std::vector<const LearningTask*>& tasks);
     std::vector<float> computeMetaGradient(const MetaModel& model,
-                                         const std::vector<LearningTask>& tasks);
+                                         const std::vector<const LearningTask*>& tasks);
     
     // Optimisation
     float computeMetaLoss(const MetaModel& model,
-                         const std::vector<LearningTask>& tasks);
+                         const std::vector<const LearningTask*>& tasks);
     void updateMetaParameters(MetaModel& model,
                             const std::vector<float>& gradients);
     
@@ -148,4 +213,23 @@ private:
     void updateModelWeights(MetaModel& model,
                           const std::vector<float>& gradients,
                           float learning_rate);
+    
+    // Passes par lots sur l'espace de travail
+    bool isTaskCompatible(const MetaModel& model, const LearningTask& task) const;
+    void packBatch(const std::vector<std::vector<float>>& set,
+                  size_t start, int count);
+    void forwardBatch(const MetaModel& model, const float* weights, int count);
+    void backwardBatch(const MetaModel& model, const float* weights,
+                      int count, float* gradients);
+    float computeOutputDeltas(const MetaModel& model, const int* targets,
+                             int count, float scale, bool is_regression);
+    float computeLossAndGradient(const MetaModel& model, const float* weights,
+                                const std::vector<std::vector<float>>& set,
+                                const int* targets, bool is_regression,
+                                float* gradients);
+    float computeAccuracy(const MetaModel& model, const float* weights,
+                         const std::vector<std::vector<float>>& set,
+                         const int* targets, bool is_regression);
+    void adaptWeights(const MetaModel& model, const LearningTask& task,
+                     int num_steps, float* fast_weights);
 };
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "MetaSearchScheduler.h"
+#include <algorithm>
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#endif
+
+MetaSearchScheduler::MetaSearchScheduler(const MetaSearchConfig& config) :
+    m_config(config),
+    m_completed(0),
+#ifdef ARDUINO
+    m_queue(nullptr),
+    m_done(nullptr)
+#else
+    m_done(0)
+#endif
+{}
+
+MetaSearchScheduler::~MetaSearchScheduler() {
+#ifdef ARDUINO
+    if (m_queue) vQueueDelete(m_queue);
+    if (m_done) vSemaphoreDelete(m_done);
+#endif
+}
+
+int MetaSearchScheduler::run(std::vector<SearchTrial>& trials,
+                            const std::vector<const LearningTask*>& tasks) {
+    if (trials.empty() || tasks.empty()) return -1;
+    splitTasks(tasks);
+    m_completed = 0;
+    
+    // Écarter les essais qui dépassent la limite mémoire
+    std::vector<int> survivors;
+    for (size_t i = 0; i < trials.size(); i++) {
+        if (checkMemory(trials[i])) {
+            survivors.push_back(i);
+        }
+    }
+    if (survivors.empty()) return -1;
+    
+    int workers = m_config.num_workers;
+#ifndef ARDUINO
+    if (workers <= 0) workers = std::thread::hardware_concurrency();
+#endif
+    workers = std::max(1, std::min(workers, (int)survivors.size()));
+    if (!startWorkers(workers, trials.size() + workers)) return -1;
+    
+    int steps = std::max(1, m_config.min_steps);
+    const int eta = std::max(2, m_config.eta);
+    
+    while (true) {
+        // Distribuer le palier courant puis attendre tous les résultats
+        for (int index : survivors) {
+            post({ &trials[index], steps });
+        }
+        waitDone(survivors.size());
+        
+        std::sort(survivors.begin(), survivors.end(), [&trials](int a, int b) {
+            return trials[a].score > trials[b].score;
+        });
+        
+        if (survivors.size() <= 1 || steps >= m_config.max_steps) break;
+        
+        // Conserver le meilleur 1/eta et augmenter le budget
+        survivors.resize(std::max<size_t>(1, survivors.size() / eta));
+        steps = std::min(steps * eta, m_config.max_steps);
+    }
+    
+    stopWorkers(workers);
+#ifdef ARDUINO
+    vQueueDelete(m_queue);
+    vSemaphoreDelete(m_done);
+    m_queue = nullptr;
+    m_done = nullptr;
+#endif
+    m_training.clear();
+    m_validation.clear();
+    
+    return trials[survivors.front()].rejected ? -1 : survivors.front();
+}
+
+void MetaSearchScheduler::splitTasks(const std::vector<const LearningTask*>& tasks) {
+    m_training.clear();
+    m_validation.clear();
+    
+    // Une seule tâche : rien à réserver, l'essai est noté sur ses données
+    if (tasks.size() < 2) {
+        m_training = tasks;
+        m_validation = tasks;
+        return;
+    }
+    
+    // Tâches de validation réparties régulièrement dans la liste, au moins
+    // une de chaque côté
+    size_t count = (size_t)(tasks.size() * m_config.validation_fraction + 0.5f);
+    count = std::max<size_t>(1, std::min(count, tasks.size() - 1));
+    for (size_t i = 0; i < tasks.size(); i++) {
+        if ((i * count) / tasks.size() != ((i + 1) * count) / tasks.size()) {
+            m_validation.push_back(tasks[i]);
+        } else {
+            m_training.push_back(tasks[i]);
+        }
+    }
+}
+
+bool MetaSearchScheduler::startWorkers(int count, size_t capacity) {
+#ifdef ARDUINO
+    m_queue = xQueueCreate(capacity, sizeof(WorkItem));
+    m_done = xSemaphoreCreateCounting(capacity, 0);
+    if (!m_queue || !m_done) return false;
+    
+    for (int i = 0; i < count; i++) {
+        String name = "search_" + String(i);
+        if (xTaskCreatePinnedToCore(
+                workerTask,
+                name.c_str(),
+                m_config.worker_stack_size,
+                this,
+                m_config.worker_priority,
+                nullptr,
+                i % portNUM_PROCESSORS) != pdPASS) {
+            stopWorkers(i);
+            return false;
+        }
+    }
+#else
+    (void)capacity;
+    m_queue.clear();
+    m_done = 0;
+    for (int i = 0; i < count; i++) {
+        m_threads.emplace_back(workerTask, this);
+    }
+#endif
+    return true;
+}
+
+void MetaSearchScheduler::stopWorkers(int count) {
+    // Un élément vide par tâche : chacune confirme puis se termine
+    for (int i = 0; i < count; i++) {
+        post({ nullptr, 0 });
+    }
+    waitDone(count);
+    
+#ifndef ARDUINO
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+#endif
+}
+
+void MetaSearchScheduler::post(const WorkItem& item) {
+#ifdef ARDUINO
+    xQueueSend(m_queue, &item, portMAX_DELAY);
+#else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(item);
+    }
+    m_posted.notify_one();
+#endif
+}
+
+bool MetaSearchScheduler::receive(WorkItem& item) {
+#ifdef ARDUINO
+    return xQueueReceive(m_queue, &item, portMAX_DELAY) == pdTRUE;
+#else
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_posted.wait(lock, [this] { return !m_queue.empty(); });
+    item = m_queue.front();
+    m_queue.pop_front();
+    return true;
+#endif
+}
+
+void MetaSearchScheduler::signalDone() {
+#ifdef ARDUINO
+    xSemaphoreGive(m_done);
+#else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done++;
+    }
+    m_finished.notify_one();
+#endif
+}
+
+void MetaSearchScheduler::waitDone(size_t count) {
+#ifdef ARDUINO
+    for (size_t i = 0; i < count; i++) {
+        xSemaphoreTake(m_done, portMAX_DELAY);
+    }
+#else
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this, count] { return m_done >= count; });
+    m_done -= count;
+#endif
+}
+
+void MetaSearchScheduler::workerTask(void* parameter) {
+    MetaSearchScheduler* scheduler = static_cast<MetaSearchScheduler*>(parameter);
+    WorkItem item;
+    
+    while (scheduler->receive(item)) {
+        if (!item.trial) break;
+        
+        scheduler->runTrial(*item.trial, item.steps);
+        scheduler->signalDone();
+    }
+    
+    scheduler->signalDone();
+#ifdef ARDUINO
+    vTaskDelete(nullptr);
+#endif
+}
+
+void MetaSearchScheduler::runTrial(SearchTrial& trial, int steps) {
+    // Revérifier la mémoire disponible au moment de l'exécution
+    if (!checkMemory(trial)) {
+        trial.score = 0.0f;
+        return;
+    }
+    
+    // Système dédié : configuration et espace de travail propres à l'essai.
+    // Le score vient des tâches réservées, jamais vues à l'entraînement
+    MetaLearningSystem runner;
+    runner.setConfig(trial.config);
+    runner.runMetaTraining(trial.model, m_training, steps, nullptr);
+    trial.score = runner.evaluateTasks(trial.model, m_validation);
+    trial.model.performance = trial.score;
+    
+    __atomic_add_fetch(&m_completed, 1, __ATOMIC_RELAXED);
+}
+
+bool MetaSearchScheduler::checkMemory(SearchTrial& trial) const {
+    trial.memory_bytes = MetaLearningSystem::estimateWorkspaceBytes(
+        trial.model.architecture, trial.config.max_batch_size);
+    
+    bool fits = trial.memory_bytes <= m_config.trial_memory_limit;
+#ifdef ARDUINO
+    fits = fits && trial.memory_bytes <= heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+#endif
+    if (!fits) {
+        trial.rejected = true;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include "MetaLearningSystem.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#else
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+// Un essai : une configuration candidate et son modèle en cours d'entraînement
+struct SearchTrial {
+    MetaLearningConfig config;
+    MetaModel model;
+    float score;
+    size_t memory_bytes;
+    bool rejected;
+    
+    SearchTrial() : score(0.0f), memory_bytes(0), rejected(false) {}
+};
+
+// Ordonnanceur successive halving : les essais survivants de chaque palier
+// sont distribués à des tâches de travail épinglées sur les deux cœurs (à N
+// std::thread sur l'hôte). Une part des tâches d'apprentissage est réservée
+// au classement : un essai n'est jamais noté sur les tâches qui l'ont
+// entraîné. Les tâches sont partagées en lecture seule ; chaque essai
+// possède son propre espace de travail.
+class MetaSearchScheduler {
+public:
+    explicit MetaSearchScheduler(const MetaSearchConfig& config = MetaSearchConfig());
+    ~MetaSearchScheduler();
+    
+    // Retourne l'index du meilleur essai, -1 si aucun n'a pu être évalué
+    int run(std::vector<SearchTrial>& trials,
+            const std::vector<const LearningTask*>& tasks);
+    
+    int getCompletedTrials() const { return m_completed; }
+
+private:
+    struct WorkItem {
+        SearchTrial* trial;
+        int steps;
+    };
+    
+    MetaSearchConfig m_config;
+    std::vector<const LearningTask*> m_training;     // Méta-entraînement des essais
+    std::vector<const LearningTask*> m_validation;   // Classement entre paliers
+    int m_completed;
+
+#ifdef ARDUINO
+    QueueHandle_t m_queue;
+    SemaphoreHandle_t m_done;
+#else
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_posted;
+    std::condition_variable m_finished;
+    std::deque<WorkItem> m_queue;
+    size_t m_done;
+#endif
+
+    static void workerTask(void* parameter);
+    void splitTasks(const std::vector<const LearningTask*>& tasks);
+    void runTrial(SearchTrial& trial, int steps);
+    bool startWorkers(int count, size_t capacity);
+    void stopWorkers(int count);
+    void post(const WorkItem& item);
+    bool receive(WorkItem& item);
+    void signalDone();
+    void waitDone(size_t count);
+    bool checkMemory(SearchTrial& trial) const;
+};
@@ -0,0 +1,394 @@
+#include "CacheEngine.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <vector>
+
+CacheEngine::CacheEngine(size_t maxEntries, size_t capacityBytes) :
+    m_nodes(nullptr),
+    m_table(nullptr),
+    m_maxEntries(std::min<size_t>(std::max<size_t>(maxEntries, 1), NONE - 1)),
+    m_tableMask(0),
+    m_freeList(NONE),
+    m_lruHead(NONE),
+    m_lruTail(NONE),
+    m_wheelTick(nowMs() / WHEEL_TICK_MS),
+    m_bytes(0),
+    m_capacity(capacityBytes),
+    m_stats{},
+    m_mutex(xSemaphoreCreateMutex()) {
+    
+    // Table au moins deux fois plus grande que le nombre de nœuds (taux de remplissage <= 0,5)
+    size_t tableSize = 1;
+    while (tableSize < m_maxEntries * 2) tableSize <<= 1;
+    m_tableMask = tableSize - 1;
+    
+    m_nodes = static_cast<Node*>(heap_caps_malloc(m_maxEntries * sizeof(Node), MALLOC_CAP_SPIRAM));
+    if (!m_nodes) {
+        m_nodes = static_cast<Node*>(heap_caps_malloc(m_maxEntries * sizeof(Node), MALLOC_CAP_8BIT));
+    }
+    m_table = static_cast<uint16_t*>(heap_caps_malloc(tableSize * sizeof(uint16_t), MALLOC_CAP_8BIT));
+    if (!m_nodes || !m_table) {
+        m_maxEntries = 0;
+        return;
+    }
+    
+    memset(m_table, 0xFF, tableSize * sizeof(uint16_t));
+    for (size_t i = 0; i < m_maxEntries; i++) {
+        m_nodes[i].heapValue = nullptr;
+        m_nodes[i].lruNext = (i + 1 < m_maxEntries) ? i + 1 : NONE;
+    }
+    m_freeList = 0;
+    for (size_t i = 0; i < WHEEL_SLOTS; i++) {
+        m_wheel[i] = NONE;
+    }
+}
+
+CacheEngine::~CacheEngine() {
+    clear();
+    if (m_nodes) heap_caps_free(m_nodes);
+    if (m_table) heap_caps_free(m_table);
+    if (m_mutex) vSemaphoreDelete(m_mutex);
+}
+
+uint32_t CacheEngine::hashKey(const char* key, size_t length) {
+    // FNV-1a, puis mélange final pour le sondage linéaire
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+uint64_t CacheEngine::nowMs() {
+    return esp_timer_get_time() / 1000;
+}
+
+void CacheEngine::setCapacity(size_t bytes) {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    m_capacity = bytes;
+    while (m_bytes > m_capacity && m_lruTail != NONE) {
+        evictTail();
+    }
+    xSemaphoreGive(m_mutex);
+}
+
+bool CacheEngine::set(const Handle<String>& handle, const String& value, uint32_t ttlMs) {
+    // Terminateur inclus : la lecture reconstruit la chaîne directement
+    return store(handle.m_key, handle.m_hash, typeId<String>(), value.c_str(), value.length() + 1, ttlMs);
+}
+
+bool CacheEngine::get(const Handle<String>& handle, String& value) {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    size_t slot = find(handle.m_key.c_str(), handle.m_key.length(), handle.m_hash);
+    bool found = false;
+    
+    if (slot != SIZE_MAX) {
+        Node& node = m_nodes[m_table[slot]];
+        if (node.type != typeId<String>()) {
+            // Même clé, autre type : traité comme absent
+        } else if (node.expiry != 0 && node.expiry <= nowMs()) {
+            removeSlot(slot);
+            m_stats.expirations++;
+        } else {
+            value = reinterpret_cast<const char*>(valueOf(node));
+            lruUnlink(m_table[slot]);
+            lruPushFront(m_table[slot]);
+            found = true;
+        }
+    }
+    
+    if (found) m_stats.hits++; else m_stats.misses++;
+    xSemaphoreGive(m_mutex);
+    return found;
+}
+
+bool CacheEngine::store(const String& key, uint32_t hash, uint32_t type,
+                        const void* data, size_t size, uint32_t ttlMs) {
+    size_t keyLength = key.length();
+    if (m_maxEntries == 0 || keyLength > MAX_KEY_LENGTH) {
+        xSemaphoreTake(m_mutex, portMAX_DELAY);
+        m_stats.rejected++;
+        xSemaphoreGive(m_mutex);
+        return false;
+    }
+    
+    // Allocation hors verrou pour les grosses valeurs
+    uint8_t* heapValue = nullptr;
+    if (size > INLINE_VALUE_SIZE) {
+        heapValue = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM));
+        if (!heapValue) {
+            heapValue = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_8BIT));
+        }
+    }
+    
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    
+    if ((size > INLINE_VALUE_SIZE && !heapValue) || keyLength + size > m_capacity) {
+        m_stats.rejected++;
+        xSemaphoreGive(m_mutex);
+        if (heapValue) heap_caps_free(heapValue);
+        return false;
+    }
+    
+    // Remplacement : l'ancienne entrée est retirée puis réinsérée en tête
+    size_t existing = find(key.c_str(), keyLength, hash);
+    if (existing != SIZE_MAX) {
+        removeSlot(existing);
+    }
+    
+    while ((m_bytes + keyLength + size > m_capacity || m_freeList == NONE) && m_lruTail != NONE) {
+        evictTail();
+    }
+    
+    uint16_t index = m_freeList;
+    Node& node = m_nodes[index];
+    m_freeList = node.lruNext;
+    
+    node.hash = hash;
+    node.type = type;
+    node.size = size;
+    node.keyLength = keyLength;
+    memcpy(node.key, key.c_str(), keyLength + 1);
+    node.heapValue = heapValue;
+    memcpy(heapValue ? heapValue : node.inlineValue, data, size);
+    node.expiry = ttlMs > 0 ? nowMs() + ttlMs : 0;
+    
+    size_t slot = hash & m_tableMask;
+    while (m_table[slot] != NONE) {
+        slot = (slot + 1) & m_tableMask;
+    }
+    m_table[slot] = index;
+    
+    lruPushFront(index);
+    wheelInsert(index);
+    m_bytes += chargeOf(node);
+    m_stats.entries++;
+    m_stats.inserts++;
+    
+    xSemaphoreGive(m_mutex);
+    return true;
+}
+
+bool CacheEngine::load(const String& key, uint32_t hash, uint32_t type, void* out, size_t size) {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    size_t slot = find(key.c_str(), key.length(), hash);
+    bool found = false;
+    
+    if (slot != SIZE_MAX) {
+        uint16_t index = m_table[slot];
+        Node& node = m_nodes[index];
+        if (node.type != type || node.size != size) {
+            // Même clé, autre type : traité comme absent
+        } else if (node.expiry != 0 && node.expiry <= nowMs()) {
+            removeSlot(slot);
+            m_stats.expirations++;
+        } else {
+            memcpy(out, valueOf(node), size);
+            lruUnlink(index);
+            lruPushFront(index);
+            found = true;
+        }
+    }
+    
+    if (found) m_stats.hits++; else m_stats.misses++;
+    xSemaphoreGive(m_mutex);
+    return found;
+}
+
+bool CacheEngine::remove(const String& key) {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    size_t slot = find(key.c_str(), key.length(), hashKey(key.c_str(), key.length()));
+    if (slot != SIZE_MAX) {
+        removeSlot(slot);
+    }
+    xSemaphoreGive(m_mutex);
+    return slot != SIZE_MAX;
+}
+
+void CacheEngine::clear() {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    while (m_lruTail != NONE) {
+        Node& node = m_nodes[m_lruTail];
+        removeSlot(find(node.key, node.keyLength, node.hash));
+    }
+    xSemaphoreGive(m_mutex);
+}
+
+size_t CacheEngine::expire(uint64_t now) {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    uint64_t tick = now / WHEEL_TICK_MS;
+    size_t expired = 0;
+    
+    // Au plus un tour complet, même après une longue pause
+    uint64_t first = std::max(m_wheelTick + 1, tick >= WHEEL_SLOTS ? tick - WHEEL_SLOTS + 1 : 0);
+    for (uint64_t t = first; t <= tick; t++) {
+        uint16_t index = m_wheel[t % WHEEL_SLOTS];
+        while (index != NONE) {
+            uint16_t next = m_nodes[index].wheelNext;
+            // Les entrées des tours suivants restent dans la case
+            if (m_nodes[index].expiry <= now) {
+                Node& node = m_nodes[index];
+                removeSlot(find(node.key, node.keyLength, node.hash));
+                expired++;
+            }
+            index = next;
+        }
+    }
+    if (tick > m_wheelTick) {
+        m_wheelTick = tick;
+    }
+    
+    m_stats.expirations += expired;
+    xSemaphoreGive(m_mutex);
+    return expired;
+}
+
+CacheStats CacheEngine::getStats() const {
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    CacheStats stats = m_stats;
+    stats.bytes = m_bytes;
+    stats.capacityBytes = m_capacity;
+    xSemaphoreGive(m_mutex);
+    return stats;
+}
+
+size_t CacheEngine::find(const char* key, size_t length, uint32_t hash) const {
+    if (m_maxEntries == 0) return SIZE_MAX;
+    
+    size_t slot = hash & m_tableMask;
+    while (m_table[slot] != NONE) {
+        const Node& node = m_nodes[m_table[slot]];
+        if (node.hash == hash && node.keyLength == length && memcmp(node.key, key, length) == 0) {
+            return slot;
+        }
+        slot = (slot + 1) & m_tableMask;
+    }
+    return SIZE_MAX;
+}
+
+void CacheEngine::removeSlot(size_t slot) {
+    uint16_t index = m_table[slot];
+    Node& node = m_nodes[index];
+    
+    lruUnlink(index);
+    wheelUnlink(index);
+    m_bytes -= chargeOf(node);
+    if (node.heapValue) {
+        heap_caps_free(node.heapValue);
+        node.heapValue = nullptr;
+    }
+    node.lruNext = m_freeList;
+    m_freeList = index;
+    m_stats.entries--;
+    
+    // Décalage arrière : pas de marqueur de suppression, les sondages restent courts
+    size_t hole = slot;
+    size_t next = (hole + 1) & m_tableMask;
+    while (m_table[next] != NONE) {
+        size_t home = m_nodes[m_table[next]].hash & m_tableMask;
+        if (((next - home) & m_tableMask) >= ((next - hole) & m_tableMask)) {
+            m_table[hole] = m_table[next];
+            hole = next;
+        }
+        next = (next + 1) & m_tableMask;
+    }
+    m_table[hole] = NONE;
+}
+
+void CacheEngine::evictTail() {
+    Node& node = m_nodes[m_lruTail];
+    removeSlot(find(node.key, node.keyLength, node.hash));
+    m_stats.evictions++;
+}
+
+void CacheEngine::lruUnlink(uint16_t index) {
+    Node& node = m_nodes[index];
+    if (node.lruPrev != NONE) m_nodes[node.lruPrev].lruNext = node.lruNext; else m_lruHead = node.lruNext;
+    if (node.lruNext != NONE) m_nodes[node.lruNext].lruPrev = node.lruPrev; else m_lruTail = node.lruPrev;
+}
+
+void CacheEngine::lruPushFront(uint16_t index) {
+    Node& node = m_nodes[index];
+    node.lruPrev = NONE;
+    node.lruNext = m_lruHead;
+    if (m_lruHead != NONE) m_nodes[m_lruHead].lruPrev = index; else m_lruTail = index;
+    m_lruHead = index;
+}
+
+void CacheEngine::wheelInsert(uint16_t index) {
+    Node& node = m_nodes[index];
+    if (node.expiry == 0) {
+        node.wheelPrev = node.wheelNext = NONE;
+        return;
+    }
+    
+    // Une case déjà dépassée dans ce tour ne serait revue qu'au tour suivant
+    uint64_t tick = std::max(node.expiry / WHEEL_TICK_MS, m_wheelTick + 1);
+    node.wheelSlot = tick % WHEEL_SLOTS;
+    node.wheelPrev = NONE;
+    node.wheelNext = m_wheel[node.wheelSlot];
+    if (node.wheelNext != NONE) m_nodes[node.wheelNext].wheelPrev = index;
+    m_wheel[node.wheelSlot] = index;
+}
+
+void CacheEngine::wheelUnlink(uint16_t index) {
+    Node& node = m_nodes[index];
+    if (node.expiry == 0) return;
+    
+    if (node.wheelPrev != NONE) m_nodes[node.wheelPrev].wheelNext = node.wheelNext;
+    else m_wheel[node.wheelSlot] = node.wheelNext;
+    if (node.wheelNext != NONE) m_nodes[node.wheelNext].wheelPrev = node.wheelPrev;
+}
+
+CacheBenchmarkResult CacheEngine::benchmark(size_t operations) {
+    const size_t KEYS = 128;
+    CacheBenchmarkResult result = {};
+    result.operations = operations;
+    if (operations == 0) return result;
+    
+    // Clés préparées hors mesure
+    CacheEngine cache(KEYS, 64 * 1024);
+    std::vector<Handle<float>> present;
+    std::vector<Handle<float>> absent;
+    present.reserve(KEYS);
+    absent.reserve(KEYS);
+    for (size_t i = 0; i < KEYS; i++) {
+        present.emplace_back("bench:" + String(i));
+        absent.emplace_back("absent:" + String(i));
+    }
+    
+    float value = 1.0f;
+    int64_t start = esp_timer_get_time();
+    for (size_t i = 0; i < operations; i++) {
+        cache.set(present[i % KEYS], value, 60000);
+    }
+    result.setNs = (esp_timer_get_time() - start) * 1000.0f / operations;
+    
+    start = esp_timer_get_time();
+    for (size_t i = 0; i < operations; i++) {
+        cache.get(present[i % KEYS], value);
+    }
+    result.getHitNs = (esp_timer_get_time() - start) * 1000.0f / operations;
+    
+    start = esp_timer_get_time();
+    for (size_t i = 0; i < operations; i++) {
+        cache.get(absent[i % KEYS], value);
+    }
+    result.getMissNs = (esp_timer_get_time() - start) * 1000.0f / operations;
+    
+    // Capacité pour la moitié des clés : chaque insertion évince
+    cache.setCapacity(cache.getStats().bytes / 2);
+    uint32_t evictionsBefore = cache.getStats().evictions;
+    start = esp_timer_get_time();
+    for (size_t i = 0; i < operations; i++) {
+        cache.set(present[i % KEYS], value, 60000);
+    }
+    result.churnNs = (esp_timer_get_time() - start) * 1000.0f / operations;
+    result.evictions = cache.getStats().evictions - evictionsBefore;
+    
+    return result;
+}
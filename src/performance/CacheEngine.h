@@ -0,0 +1,152 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <type_traits>
+
+struct CacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t inserts;
+    uint32_t evictions;      // Entrées LRU retirées pour faire de la place
+    uint32_t expirations;    // TTL écoulé (roue ou lecture)
+    uint32_t rejected;       // Clé trop longue, valeur trop grosse ou allocation impossible
+    uint32_t entries;
+    size_t bytes;
+    size_t capacityBytes;
+};
+
+struct CacheBenchmarkResult {
+    uint32_t operations;
+    float setNs;             // Par opération
+    float getHitNs;
+    float getMissNs;
+    float churnNs;           // Insertions avec éviction
+    uint32_t evictions;
+};
+
+// Cache clé/valeur à capacité fixe.
+// - Table à adressage ouvert (sondage linéaire, suppression par décalage
+//   arrière) d'index vers des nœuds préalloués ; clé recopiée dans le nœud.
+// - Liste LRU intrusive ; la capacité en octets (clé + valeur) est
+//   respectée en évinçant depuis la queue.
+// - TTL : roue temporelle de 64 cases de 250 ms avancée par expire(), et
+//   contrôle à la lecture.
+// - Valeurs de types trivialement copiables (ou String), copiées à
+//   l'écriture et à la lecture : aucune référence ne sort du verrou.
+//   Jusqu'à 16 octets, la valeur est stockée dans le nœud.
+// - Handle<T> : clé hachée une seule fois et type vérifié à la lecture.
+// Toutes les opérations prennent un mutex FreeRTOS.
+class CacheEngine {
+public:
+    static const size_t MAX_KEY_LENGTH = 31;
+    static const size_t INLINE_VALUE_SIZE = 16;
+    
+    template<typename T>
+    class Handle {
+    public:
+        explicit Handle(const String& key) :
+            m_key(key),
+            m_hash(CacheEngine::hashKey(key.c_str(), key.length())) {}
+        const String& key() const { return m_key; }
+    
+    private:
+        friend class CacheEngine;
+        String m_key;
+        uint32_t m_hash;
+    };
+    
+    explicit CacheEngine(size_t maxEntries = 256, size_t capacityBytes = 64 * 1024);
+    ~CacheEngine();
+    CacheEngine(const CacheEngine&) = delete;
+    CacheEngine& operator=(const CacheEngine&) = delete;
+    
+    // Réduire la capacité évince immédiatement
+    void setCapacity(size_t bytes);
+    
+    // ttlMs = 0 : pas d'expiration
+    template<typename T>
+    bool set(const Handle<T>& handle, const T& value, uint32_t ttlMs) {
+        static_assert(std::is_trivially_copyable<T>::value, "Valeur de cache non copiable octet par octet");
+        return store(handle.m_key, handle.m_hash, typeId<T>(), &value, sizeof(T), ttlMs);
+    }
+    
+    template<typename T>
+    bool get(const Handle<T>& handle, T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Valeur de cache non copiable octet par octet");
+        return load(handle.m_key, handle.m_hash, typeId<T>(), &value, sizeof(T));
+    }
+    
+    bool set(const Handle<String>& handle, const String& value, uint32_t ttlMs);
+    bool get(const Handle<String>& handle, String& value);
+    
+    bool remove(const String& key);
+    void clear();
+    
+    // Avance la roue jusqu'à nowMs ; retourne le nombre d'entrées expirées
+    size_t expire(uint64_t nowMs);
+    
+    CacheStats getStats() const;
+    
+    static uint32_t hashKey(const char* key, size_t length);
+    static uint64_t nowMs();
+    
+    // Mesure sur une instance temporaire (n'affecte pas ce cache)
+    static CacheBenchmarkResult benchmark(size_t operations);
+    
+private:
+    static const uint16_t NONE = 0xFFFF;
+    static const size_t WHEEL_SLOTS = 64;
+    static const uint32_t WHEEL_TICK_MS = 250;
+    
+    struct Node {
+        uint32_t hash;
+        uint32_t type;
+        uint32_t size;
+        uint64_t expiry;                // ms, 0 = jamais
+        uint16_t lruPrev;
+        uint16_t lruNext;               // Aussi chaînage de la liste libre
+        uint16_t wheelPrev;
+        uint16_t wheelNext;
+        uint8_t wheelSlot;
+        uint8_t keyLength;
+        char key[MAX_KEY_LENGTH + 1];
+        uint8_t* heapValue;             // nullptr si la valeur est dans inlineValue
+        uint8_t inlineValue[INLINE_VALUE_SIZE];
+    };
+    
+    Node* m_nodes;
+    uint16_t* m_table;
+    size_t m_maxEntries;
+    size_t m_tableMask;
+    uint16_t m_freeList;
+    uint16_t m_lruHead;                 // Plus récemment utilisé
+    uint16_t m_lruTail;
+    uint16_t m_wheel[WHEEL_SLOTS];
+    uint64_t m_wheelTick;               // Dernière case traitée
+    size_t m_bytes;
+    size_t m_capacity;
+    CacheStats m_stats;
+    SemaphoreHandle_t m_mutex;
+    
+    template<typename T>
+    static uint32_t typeId() {
+        static const char tag = 0;
+        return (uint32_t)(uintptr_t)&tag;
+    }
+    
+    bool store(const String& key, uint32_t hash, uint32_t type, const void* data, size_t size, uint32_t ttlMs);
+    bool load(const String& key, uint32_t hash, uint32_t type, void* out, size_t size);
+    
+    // Appelées verrou pris
+    size_t find(const char* key, size_t length, uint32_t hash) const;
+    void removeSlot(size_t slot);
+    void evictTail();
+    void lruUnlink(uint16_t index);
+    void lruPushFront(uint16_t index);
+    void wheelInsert(uint16_t index);
+    void wheelUnlink(uint16_t index);
+    const uint8_t* valueOf(const Node& node) const { return node.heapValue ? node.heapValue : node.inlineValue; }
+    size_t chargeOf(const Node& node) const { return node.keyLength + node.size; }
+};
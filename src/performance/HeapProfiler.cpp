@@ -0,0 +1,549 @@
+#include "HeapProfiler.h"
+#include <algorithm>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#include <sdkconfig.h>
+#if CONFIG_HEAP_TRACING_STANDALONE
+#include <esp_heap_trace.h>
+#define HEAP_PROFILER_IDF_TRACING 1
+#endif
+#else
+#include <chrono>
+#define HEAP_PROFILER_HOOKS 1
+#endif
+
+namespace {
+    std::atomic<bool> tracking(false);
+    
+    // Compteurs de la fenêtre par trame ; écrits par la seule boucle de vision
+    struct FrameSample {
+        uint32_t allocations;
+        uint32_t frees;
+    };
+    std::mutex frameMutex;
+    FrameSample frameSamples[HeapProfiler::FRAME_WINDOW];
+    size_t frameHead = 0;
+    size_t frameCount = 0;
+    uint32_t lastAllocations = 0;
+    uint32_t lastFrees = 0;
+    bool frameGross = false;
+    
+    uint32_t nowMs() {
+#ifdef ARDUINO
+        return millis();
+#else
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    
+    // Agrégation par couple (site, appelant), sans réallocation en cours de
+    // parcours : le suivi reste actif pendant qu'on lit
+    struct SiteKey {
+        uintptr_t site;
+        uintptr_t caller;
+        bool operator<(const SiteKey& other) const {
+            return site != other.site ? site < other.site : caller < other.caller;
+        }
+    };
+    using SiteMap = std::map<SiteKey, CallSiteStats>;
+    
+    void addSite(SiteMap& sites, uintptr_t site, uintptr_t caller, uint32_t size) {
+        CallSiteStats& stats = sites[{site, caller}];
+        stats.site = site;
+        stats.caller = caller;
+        stats.count++;
+        stats.bytes += size;
+    }
+
+#if HEAP_PROFILER_IDF_TRACING
+    const size_t TRACE_RECORDS = 1000;          // ~ 40 o chacun, RAM interne
+    heap_trace_record_t* traceRecords = nullptr;
+    
+    bool backendStart() {
+        if (!traceRecords) {
+            traceRecords = static_cast<heap_trace_record_t*>(
+                heap_caps_calloc(TRACE_RECORDS, sizeof(heap_trace_record_t), MALLOC_CAP_INTERNAL));
+            if (!traceRecords) return false;
+            if (heap_trace_init_standalone(traceRecords, TRACE_RECORDS) != ESP_OK) {
+                heap_caps_free(traceRecords);
+                traceRecords = nullptr;
+                return false;
+            }
+        }
+        // Mode fuites : un enregistrement disparaît à la libération
+        return heap_trace_start(HEAP_TRACE_LEAKS) == ESP_OK;
+    }
+    
+    void backendStop() {
+        heap_trace_stop();
+    }
+    
+    // Totaux bruts depuis le démarrage du suivi ; IDF < 5.1 : nombre
+    // d'enregistrements vivants seulement
+    bool backendCounts(uint32_t& allocations, uint32_t& frees) {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+        heap_trace_summary_t summary;
+        if (heap_trace_summary(&summary) != ESP_OK) return false;
+        allocations = summary.total_allocations;
+        frees = summary.total_frees;
+        return true;
+#else
+        allocations = heap_trace_get_count();
+        frees = 0;
+        return false;
+#endif
+    }
+    
+    struct ProfilerScope {};
+    
+    bool backendCollect(SiteMap& sites, HeapSnapshot& out) {
+        // Pause le temps du parcours : l'agrégation alloue, et les index
+        // bougeraient sous nos pieds. Ce qui est libéré pendant la pause
+        // reste compté vivant ; la fenêtre est de quelques ms.
+        heap_trace_stop();
+        size_t count = heap_trace_get_count();
+        for (size_t i = 0; i < count; i++) {
+            heap_trace_record_t record;
+            if (heap_trace_get(i, &record) != ESP_OK || record.size == 0) continue;
+            
+            uintptr_t caller = 0;
+#if CONFIG_HEAP_TRACING_STACK_DEPTH > 1
+            caller = (uintptr_t)record.alloced_by[1];
+#endif
+            addSite(sites, (uintptr_t)record.alloced_by[0], caller, record.size);
+            out.liveAllocations++;
+            out.liveBytes += record.size;
+        }
+        out.overflowed = count >= TRACE_RECORDS;
+        heap_trace_resume();
+        return true;
+    }
+#elif HEAP_PROFILER_HOOKS
+    // Table des allocations vivantes (adressage ouvert, suppression par
+    // décalage arrière), statique : les crochets n'allouent jamais
+    const size_t LIVE_CAPACITY = 1 << 16;
+    
+    struct LiveAllocation {
+        uintptr_t address;          // 0 : case libre
+        uintptr_t site;
+        uint32_t size;
+    };
+    
+    LiveAllocation liveTable[LIVE_CAPACITY];
+    size_t liveCount = 0;
+    bool liveOverflowed = false;
+    std::atomic_flag liveLock = ATOMIC_FLAG_INIT;
+    std::atomic<uint32_t> hookAllocations(0);
+    std::atomic<uint32_t> hookFrees(0);
+    
+    // Allocations du profileur lui-même (agrégation) : ignorées
+    thread_local bool insideProfiler = false;
+    
+    // Le temps d'un instantané ou d'un diff
+    struct ProfilerScope {
+        bool previous;
+        ProfilerScope() : previous(insideProfiler) { insideProfiler = true; }
+        ~ProfilerScope() { insideProfiler = previous; }
+    };
+    
+    struct LiveLock {
+        LiveLock() { while (liveLock.test_and_set(std::memory_order_acquire)) {} }
+        ~LiveLock() { liveLock.clear(std::memory_order_release); }
+    };
+    
+    size_t slotFor(uintptr_t address) {
+        return (address >> 4) * 2654435761u & (LIVE_CAPACITY - 1);
+    }
+    
+    void trackAllocation(void* pointer, size_t size, uintptr_t site) {
+        if (!pointer || insideProfiler || !tracking.load(std::memory_order_relaxed)) return;
+        hookAllocations.fetch_add(1, std::memory_order_relaxed);
+        
+        LiveLock lock;
+        if (liveCount >= LIVE_CAPACITY * 3 / 4) {
+            liveOverflowed = true;
+            return;
+        }
+        size_t slot = slotFor((uintptr_t)pointer);
+        while (liveTable[slot].address) {
+            slot = (slot + 1) & (LIVE_CAPACITY - 1);
+        }
+        liveTable[slot] = { (uintptr_t)pointer, site, (uint32_t)size };
+        liveCount++;
+    }
+    
+    void trackFree(void* pointer) {
+        if (!pointer || insideProfiler || !tracking.load(std::memory_order_relaxed)) return;
+        hookFrees.fetch_add(1, std::memory_order_relaxed);
+        
+        LiveLock lock;
+        size_t slot = slotFor((uintptr_t)pointer);
+        while (liveTable[slot].address != (uintptr_t)pointer) {
+            if (!liveTable[slot].address) return;      // Allouée avant le suivi
+            slot = (slot + 1) & (LIVE_CAPACITY - 1);
+        }
+        
+        // Remonte les entrées suivantes qui ont dépassé leur case idéale
+        size_t hole = slot;
+        size_t next = (slot + 1) & (LIVE_CAPACITY - 1);
+        while (liveTable[next].address) {
+            size_t ideal = slotFor(liveTable[next].address);
+            if (((next - ideal) & (LIVE_CAPACITY - 1)) >= ((next - hole) & (LIVE_CAPACITY - 1))) {
+                liveTable[hole] = liveTable[next];
+                hole = next;
+            }
+            next = (next + 1) & (LIVE_CAPACITY - 1);
+        }
+        liveTable[hole].address = 0;
+        liveCount--;
+    }
+    
+    bool backendStart() {
+        LiveLock lock;
+        memset(liveTable, 0, sizeof(liveTable));
+        liveCount = 0;
+        liveOverflowed = false;
+        hookAllocations.store(0);
+        hookFrees.store(0);
+        return true;
+    }
+    
+    void backendStop() {}
+    
+    bool backendCounts(uint32_t& allocations, uint32_t& frees) {
+        allocations = hookAllocations.load(std::memory_order_relaxed);
+        frees = hookFrees.load(std::memory_order_relaxed);
+        return true;
+    }
+    
+    bool backendCollect(SiteMap& sites, HeapSnapshot& out) {
+        // Copie sous verrou dans un tampon brut, agrégation ensuite : les
+        // autres threads n'attendent pas la construction de la map
+        std::vector<LiveAllocation> live;
+        live.reserve(LIVE_CAPACITY * 3 / 4);
+        {
+            LiveLock lock;
+            for (const LiveAllocation& entry : liveTable) {
+                if (entry.address) live.push_back(entry);
+            }
+            out.overflowed = liveOverflowed;
+        }
+        for (const LiveAllocation& entry : live) {
+            addSite(sites, entry.site, 0, entry.size);
+            out.liveAllocations++;
+            out.liveBytes += entry.size;
+        }
+        return true;
+    }
+#else
+    struct ProfilerScope {};
+    
+    bool backendStart() { return false; }
+    void backendStop() {}
+    bool backendCounts(uint32_t&, uint32_t&) { return false; }
+    bool backendCollect(SiteMap&, HeapSnapshot&) { return false; }
+#endif
+}
+
+#if HEAP_PROFILER_HOOKS
+// Crochets du build hôte : site = adresse de retour vers l'appelant de new
+void* operator new(size_t size) {
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    trackAllocation(pointer, size, (uintptr_t)__builtin_return_address(0));
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    trackAllocation(pointer, size, (uintptr_t)__builtin_return_address(0));
+    return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    void* pointer = malloc(size ? size : 1);
+    trackAllocation(pointer, size, (uintptr_t)__builtin_return_address(0));
+    return pointer;
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    void* pointer = malloc(size ? size : 1);
+    trackAllocation(pointer, size, (uintptr_t)__builtin_return_address(0));
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    trackFree(pointer);
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    trackFree(pointer);
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    trackFree(pointer);
+    free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    trackFree(pointer);
+    free(pointer);
+}
+#endif
+
+HeapProfiler::HeapProfiler() :
+    m_nextId(1) {}
+
+bool HeapProfiler::isAvailable() {
+#if HEAP_PROFILER_IDF_TRACING || HEAP_PROFILER_HOOKS
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HeapProfiler::startTracking() {
+    if (tracking.load()) return true;
+    if (!backendStart()) return false;
+    
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        frameHead = 0;
+        frameCount = 0;
+        frameGross = backendCounts(lastAllocations, lastFrees);
+    }
+    tracking.store(true);
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_suspects.clear();
+    return true;
+}
+
+void HeapProfiler::stopTracking() {
+    if (!tracking.exchange(false)) return;
+    backendStop();
+}
+
+bool HeapProfiler::isTracking() {
+    return tracking.load(std::memory_order_relaxed);
+}
+
+void HeapProfiler::markFrame() {
+    if (!tracking.load(std::memory_order_relaxed)) return;
+    
+    uint32_t allocations = 0;
+    uint32_t frees = 0;
+    bool gross = backendCounts(allocations, frees);
+    
+    std::lock_guard<std::mutex> lock(frameMutex);
+    FrameSample& sample = frameSamples[frameHead];
+    frameGross = gross;
+    if (gross) {
+        sample.allocations = allocations - lastAllocations;
+        sample.frees = frees - lastFrees;
+    } else {
+        // Solde des allocations vivantes
+        int32_t net = (int32_t)(allocations - lastAllocations);
+        sample.allocations = net > 0 ? net : 0;
+        sample.frees = net < 0 ? -net : 0;
+    }
+    lastAllocations = allocations;
+    lastFrees = frees;
+    
+    frameHead = (frameHead + 1) % FRAME_WINDOW;
+    if (frameCount < FRAME_WINDOW) frameCount++;
+}
+
+FrameAllocStats HeapProfiler::getFrameStats() {
+    FrameAllocStats stats = {};
+    std::lock_guard<std::mutex> lock(frameMutex);
+    stats.gross = frameGross;
+    stats.frames = frameCount;
+    if (frameCount == 0) return stats;
+    
+    const FrameSample& last = frameSamples[(frameHead + FRAME_WINDOW - 1) % FRAME_WINDOW];
+    stats.lastAllocations = last.allocations;
+    stats.lastFrees = last.frees;
+    
+    uint32_t total = 0;
+    for (size_t i = 0; i < frameCount; i++) {
+        const FrameSample& sample = frameSamples[(frameHead + FRAME_WINDOW - 1 - i) % FRAME_WINDOW];
+        total += sample.allocations;
+        stats.maxAllocations = std::max(stats.maxAllocations, sample.allocations);
+    }
+    stats.avgAllocations = (float)total / frameCount;
+    return stats;
+}
+
+HeapRegionStats HeapProfiler::getRegionStats(uint32_t caps) {
+    HeapRegionStats stats = {};
+#ifdef ARDUINO
+    stats.totalSize = heap_caps_get_total_size(caps);
+    stats.totalFree = heap_caps_get_free_size(caps);
+    stats.largestFree = heap_caps_get_largest_free_block(caps);
+    stats.minFree = heap_caps_get_minimum_free_size(caps);
+    if (stats.totalFree > 0) {
+        stats.fragmentation = 100.0f * (1.0f - (float)stats.largestFree / stats.totalFree);
+    }
+#else
+    (void)caps;
+#endif
+    return stats;
+}
+
+HeapRegionStats HeapProfiler::getInternalStats() {
+#ifdef ARDUINO
+    return getRegionStats(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+    return getRegionStats(0);
+#endif
+}
+
+HeapRegionStats HeapProfiler::getPsramStats() {
+#ifdef ARDUINO
+    return getRegionStats(MALLOC_CAP_SPIRAM);
+#else
+    return getRegionStats(0);
+#endif
+}
+
+bool HeapProfiler::collect(HeapSnapshot& out) const {
+    out = HeapSnapshot();
+    out.timestamp = nowMs();
+    if (!tracking.load()) return false;
+    
+    ProfilerScope scope;
+    SiteMap sites;
+    if (!backendCollect(sites, out)) return false;
+    
+    out.sites.reserve(sites.size());
+    for (const auto& entry : sites) {
+        out.sites.push_back(entry.second);
+    }
+    std::sort(out.sites.begin(), out.sites.end(), [](const CallSiteStats& a, const CallSiteStats& b) {
+        return a.bytes > b.bytes;
+    });
+    
+    // Queue de distribution cumulée dans un site 0
+    if (out.sites.size() > MAX_SITES) {
+        CallSiteStats rest = {};
+        for (size_t i = MAX_SITES - 1; i < out.sites.size(); i++) {
+            rest.count += out.sites[i].count;
+            rest.bytes += out.sites[i].bytes;
+        }
+        out.sites.resize(MAX_SITES - 1);
+        out.sites.push_back(rest);
+    }
+    return true;
+}
+
+uint32_t HeapProfiler::takeSnapshot() {
+    ProfilerScope scope;
+    HeapSnapshot snapshot;
+    if (!collect(snapshot)) return 0;
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snapshot.id = m_nextId++;
+    uint32_t id = snapshot.id;
+    m_snapshots[id] = std::move(snapshot);
+    while (m_snapshots.size() > MAX_SNAPSHOTS) {
+        m_snapshots.erase(m_snapshots.begin());
+    }
+    return id;
+}
+
+bool HeapProfiler::getSnapshot(uint32_t id, HeapSnapshot& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_snapshots.find(id);
+    if (it == m_snapshots.end()) return false;
+    out = it->second;
+    return true;
+}
+
+std::vector<uint32_t> HeapProfiler::listSnapshots() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<uint32_t> ids;
+    for (const auto& entry : m_snapshots) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+void HeapProfiler::computeDiff(const HeapSnapshot& from, const HeapSnapshot& to,
+                               std::vector<CallSiteDelta>& out) {
+    std::map<SiteKey, CallSiteDelta> deltas;
+    for (const CallSiteStats& site : to.sites) {
+        CallSiteDelta& delta = deltas[{site.site, site.caller}];
+        delta.site = site.site;
+        delta.caller = site.caller;
+        delta.count += site.count;
+        delta.bytes += site.bytes;
+    }
+    for (const CallSiteStats& site : from.sites) {
+        CallSiteDelta& delta = deltas[{site.site, site.caller}];
+        delta.site = site.site;
+        delta.caller = site.caller;
+        delta.count -= site.count;
+        delta.bytes -= site.bytes;
+    }
+    
+    out.clear();
+    for (const auto& entry : deltas) {
+        if (entry.second.count != 0 || entry.second.bytes != 0) {
+            out.push_back(entry.second);
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const CallSiteDelta& a, const CallSiteDelta& b) {
+        return a.bytes > b.bytes;
+    });
+}
+
+bool HeapProfiler::diff(uint32_t from, uint32_t to, std::vector<CallSiteDelta>& out) {
+    ProfilerScope scope;
+    HeapSnapshot current;
+    if (to == 0 && !collect(current)) return false;
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto first = m_snapshots.find(from);
+    if (first == m_snapshots.end()) return false;
+    
+    if (to == 0) {
+        computeDiff(first->second, current, out);
+        return true;
+    }
+    auto second = m_snapshots.find(to);
+    if (second == m_snapshots.end()) return false;
+    computeDiff(first->second, second->second, out);
+    return true;
+}
+
+void HeapProfiler::updateLeakSuspects(uint32_t minBytes) {
+    // Le suivi ne voit que les allocations faites depuis son démarrage :
+    // tout ce qui est encore vivant est de la croissance
+    ProfilerScope scope;
+    HeapSnapshot current;
+    if (!collect(current)) return;
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_suspects.clear();
+    for (const CallSiteStats& site : current.sites) {
+        if (site.bytes < minBytes) break;       // Octets décroissants
+        if (site.site == 0) continue;           // Queue cumulée
+        m_suspects.push_back({site.site, site.caller, (int32_t)site.count, (int32_t)site.bytes});
+    }
+}
+
+std::vector<CallSiteDelta> HeapProfiler::getLeakSuspects() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_suspects;
+}
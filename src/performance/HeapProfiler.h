@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// État d'une région du tas (RAM interne ou PSRAM)
+struct HeapRegionStats {
+    uint32_t totalSize;
+    uint32_t totalFree;
+    uint32_t largestFree;       // Plus grand bloc allouable d'un tenant
+    uint32_t minFree;           // Minimum depuis le démarrage
+    float fragmentation;        // 100 * (1 - largestFree / totalFree)
+};
+
+// Allocations par trame de la boucle de vision, sur la fenêtre glissante
+struct FrameAllocStats {
+    uint32_t frames;
+    uint32_t lastAllocations;
+    uint32_t lastFrees;
+    uint32_t maxAllocations;
+    float avgAllocations;
+    bool gross;                 // false : soldes nets (heap tracing sans résumé, IDF < 5.1)
+};
+
+struct CallSiteStats {
+    uintptr_t site;             // Appelant de l'allocateur (addr2line sur firmware.elf)
+    uintptr_t caller;           // Cadre au-dessus, 0 si inconnu
+    uint32_t count;
+    uint32_t bytes;
+};
+
+struct CallSiteDelta {
+    uintptr_t site;
+    uintptr_t caller;
+    int32_t count;
+    int32_t bytes;
+};
+
+struct HeapSnapshot {
+    uint32_t id;
+    uint32_t timestamp;                 // ms
+    uint32_t liveAllocations;
+    uint32_t liveBytes;
+    bool overflowed;                    // Table de suivi pleine : vue partielle
+    std::vector<CallSiteStats> sites;   // Octets décroissants
+};
+
+// Profil des allocations.
+// Suivi à la demande : heap tracing ESP-IDF (mode fuites, activé par
+// CONFIG_HEAP_TRACING_STANDALONE dans sdkconfig) sur la cible, crochets
+// operator new/delete dans le build hôte. Le suivi garde les allocations
+// vivantes et leur site d'appel ; un instantané les agrège par site, un
+// diff entre instantanés fait ressortir les sites qui grossissent.
+// La fragmentation (plus grand bloc libre / total libre) est toujours
+// disponible, suivi actif ou non.
+class HeapProfiler {
+public:
+    static const size_t MAX_SNAPSHOTS = 4;
+    static const size_t MAX_SITES = 128;        // Par instantané ; le reste est cumulé en site 0
+    static const size_t FRAME_WINDOW = 120;
+    
+    HeapProfiler();
+    
+    // false si aucun mécanisme de suivi n'est compilé
+    static bool isAvailable();
+    bool startTracking();
+    void stopTracking();
+    static bool isTracking();
+    
+    // Une fois par trame, depuis la boucle de vision ; sans effet hors suivi
+    static void markFrame();
+    static FrameAllocStats getFrameStats();
+    
+    static HeapRegionStats getRegionStats(uint32_t caps);
+    static HeapRegionStats getInternalStats();
+    static HeapRegionStats getPsramStats();
+    
+    // Agrège les allocations vivantes ; retourne l'id (0 : suivi inactif).
+    // Les MAX_SNAPSHOTS derniers sont conservés.
+    uint32_t takeSnapshot();
+    bool getSnapshot(uint32_t id, HeapSnapshot& out) const;
+    std::vector<uint32_t> listSnapshots() const;
+    
+    // Variation par site de from à to (to = 0 : état courant), triée par
+    // croissance décroissante ; false si un instantané n'existe plus
+    bool diff(uint32_t from, uint32_t to, std::vector<CallSiteDelta>& out);
+    
+    // Sites dont les allocations faites depuis le début du suivi, encore
+    // vivantes, dépassent minBytes
+    void updateLeakSuspects(uint32_t minBytes);
+    std::vector<CallSiteDelta> getLeakSuspects() const;
+    
+private:
+    mutable std::mutex m_mutex;
+    std::map<uint32_t, HeapSnapshot> m_snapshots;
+    uint32_t m_nextId;
+    std::vector<CallSiteDelta> m_suspects;
+    
+    bool collect(HeapSnapshot& out) const;
+    static void computeDiff(const HeapSnapshot& from, const HeapSnapshot& to,
+                            std::vector<CallSiteDelta>& out);
+};
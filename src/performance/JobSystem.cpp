@@ -0,0 +1,365 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+namespace {
+    inline void relax() {
+#ifdef ARDUINO
+        // Attente active courte : l'autre participant finit sa tranche
+        __asm__ __volatile__("nop");
+#else
+        std::this_thread::yield();
+#endif
+    }
+    
+    inline int64_t nowUs() {
+#ifdef ARDUINO
+        return esp_timer_get_time();
+#else
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+}
+
+bool JobSystem::WorkDeque::push(uint32_t range) {
+    int32_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int32_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= (int32_t)CAPACITY) {
+        return false;
+    }
+    m_items[bottom & (CAPACITY - 1)].store(range, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::WorkDeque::take(uint32_t& range) {
+    int32_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int32_t top = m_top.load(std::memory_order_relaxed);
+    
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    range = m_items[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // Dernier élément : course possible avec un voleur
+        bool won = m_top.compare_exchange_strong(top, top + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+bool JobSystem::WorkDeque::steal(uint32_t& range) {
+    int32_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int32_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return false;
+    }
+    
+    range = m_items[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    return m_top.compare_exchange_strong(top, top + 1,
+        std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+const size_t JobSystem::MAX_WORKERS;
+
+JobSystem::JobSystem() :
+    m_workers(1),
+    m_active(1),
+    m_running(false),
+    m_busy(0),
+    m_loops(0),
+    m_serialLoops(0) {
+    m_loop.function = nullptr;
+    m_loop.context = nullptr;
+    m_loop.begin = m_loop.end = 0;
+    m_loop.grain = 1;
+    m_loop.remaining = 0;
+    for (size_t i = 0; i < MAX_WORKERS; i++) {
+        m_chunks[i] = 0;
+        m_steals[i] = 0;
+        m_contexts[i] = { this, i };
+#ifdef ARDUINO
+        m_tasks[i] = nullptr;
+#endif
+    }
+#ifndef ARDUINO
+    m_generation = 0;
+#endif
+}
+
+JobSystem::~JobSystem() {
+    end();
+}
+
+bool JobSystem::begin(size_t workers) {
+    if (m_running) return true;
+    
+    if (workers == 0) {
+#ifdef ARDUINO
+        workers = portNUM_PROCESSORS;
+#else
+        workers = std::thread::hardware_concurrency();
+#endif
+    }
+    m_workers = std::max<size_t>(1, std::min(workers, MAX_WORKERS));
+    m_active = m_workers;
+    m_running = true;
+    
+    // Le participant 0 est l'appelant de parallelFor : une tâche de moins
+    for (size_t i = 1; i < m_workers; i++) {
+#ifdef ARDUINO
+        // Sur les autres cœurs que celui de l'appelant de begin() (la boucle de vision)
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "jobs_%u", (unsigned)i);
+        BaseType_t core = (xPortGetCoreID() + i) % portNUM_PROCESSORS;
+        if (xTaskCreatePinnedToCore(workerTask, name, 4096, &m_contexts[i], 1,
+                                    &m_tasks[i], core) != pdPASS) {
+            m_workers = i;
+            m_active = i;
+            break;
+        }
+#else
+        m_threads[i] = std::thread(workerTask, &m_contexts[i]);
+#endif
+    }
+    return true;
+}
+
+void JobSystem::end() {
+    if (!m_running) return;
+    
+    std::lock_guard<std::mutex> lock(m_loopMutex);
+    m_running = false;
+
+#ifdef ARDUINO
+    for (size_t i = 1; i < m_workers; i++) {
+        while (m_tasks[i]) {
+            xTaskNotifyGive(m_tasks[i]);
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+    }
+#else
+    {
+        std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+        m_generation++;
+    }
+    m_wake.notify_all();
+    for (size_t i = 1; i < m_workers; i++) {
+        if (m_threads[i].joinable()) m_threads[i].join();
+    }
+#endif
+    m_workers = 1;
+    m_active = 1;
+}
+
+void JobSystem::setActiveWorkers(size_t count) {
+    // Sous le verrou : jamais pendant une boucle répartie
+    std::lock_guard<std::mutex> lock(m_loopMutex);
+    m_active = std::max<size_t>(1, std::min(count, m_workers));
+}
+
+JobSystemStats JobSystem::getStats() const {
+    JobSystemStats stats = {};
+    stats.loops = m_loops;
+    stats.serialLoops = m_serialLoops;
+    for (size_t i = 0; i < MAX_WORKERS; i++) {
+        stats.chunks[i] = m_chunks[i];
+        stats.steals[i] = m_steals[i];
+    }
+    return stats;
+}
+
+void JobSystem::run(size_t begin, size_t end, size_t grain, RangeFunction function, void* context) {
+    if (begin >= end) return;
+    
+    grain = std::max<size_t>(grain, 1);
+    size_t count = end - begin;
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks > 0xFFFF) {
+        grain = (count + 0xFFFE) / 0xFFFF;
+        chunks = (count + grain - 1) / grain;
+    }
+    
+    // Imbriqué, concurrent, arrêté ou indivisible : dans l'appelant
+    if (!m_running || m_active <= 1 || chunks <= 1 || !m_loopMutex.try_lock()) {
+        m_serialLoops++;
+        function(context, begin, end);
+        return;
+    }
+    
+    size_t active = m_active;
+    for (size_t i = 0; i < active; i++) {
+        m_deques[i].reset();
+    }
+    m_loop.function = function;
+    m_loop.context = context;
+    m_loop.begin = begin;
+    m_loop.end = end;
+    m_loop.grain = grain;
+    m_deques[0].push(packRange(0, chunks));
+    // Publication : un participant qui voit remaining > 0 voit aussi ce qui précède
+    m_loop.remaining.store(chunks, std::memory_order_release);
+    
+    wakeWorkers();
+    participate(0);
+    
+    // Plus aucun participant ne touche aux deques avant la prochaine remise à zéro
+    while (m_busy.load() > 0) {
+        relax();
+    }
+    
+    m_loops++;
+    m_loopMutex.unlock();
+}
+
+void JobSystem::participate(size_t self) {
+    uint32_t range;
+    while (m_loop.remaining.load(std::memory_order_acquire) > 0) {
+        if (m_deques[self].take(range) || stealAny(self, range)) {
+            execute(self, range);
+        } else {
+            relax();
+        }
+    }
+}
+
+void JobSystem::execute(size_t self, uint32_t range) {
+    uint32_t first = rangeFirst(range);
+    uint32_t last = rangeLast(range);
+    
+    // Découpage paresseux : la moitié haute reste disponible pour les voleurs
+    while (last - first > 1) {
+        uint32_t middle = first + (last - first) / 2;
+        if (!m_deques[self].push(packRange(middle, last))) break;
+        last = middle;
+    }
+    
+    size_t begin = m_loop.begin + first * m_loop.grain;
+    size_t end = std::min(m_loop.end, m_loop.begin + last * m_loop.grain);
+    m_loop.function(m_loop.context, begin, end);
+    
+    m_chunks[self] += last - first;
+    m_loop.remaining.fetch_sub(last - first, std::memory_order_acq_rel);
+}
+
+bool JobSystem::stealAny(size_t self, uint32_t& range) {
+    size_t active = m_active;
+    for (size_t i = 1; i < active; i++) {
+        size_t victim = (self + i) % active;
+        if (m_deques[victim].steal(range)) {
+            m_steals[self]++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::wakeWorkers() {
+#ifdef ARDUINO
+    for (size_t i = 1; i < m_active; i++) {
+        xTaskNotifyGive(m_tasks[i]);
+    }
+#else
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_generation++;
+    }
+    m_wake.notify_all();
+#endif
+}
+
+void JobSystem::workerLoop(size_t self) {
+#ifndef ARDUINO
+    uint32_t seen = 0;
+#endif
+
+    while (m_running) {
+#ifdef ARDUINO
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#else
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait(lock, [&] { return m_generation != seen; });
+            seen = m_generation;
+        }
+#endif
+        if (!m_running) break;
+        
+        // Compté avant toute lecture de la boucle courante (voir run())
+        m_busy++;
+        if (self < m_active) {
+            participate(self);
+        }
+        m_busy--;
+    }
+}
+
+void JobSystem::workerTask(void* parameter) {
+    WorkerContext* context = static_cast<WorkerContext*>(parameter);
+    context->jobs->workerLoop(context->index);
+#ifdef ARDUINO
+    context->jobs->m_tasks[context->index] = nullptr;
+    vTaskDelete(nullptr);
+#endif
+}
+
+JobSystemBenchmark JobSystem::benchmark(JobSystem& jobs, size_t workers, uint32_t iterations) {
+    const int width = 320;
+    const int height = 240;
+    JobSystemBenchmark result = { std::min(workers, jobs.getWorkerCount()), iterations, 0.0f };
+    
+    uint8_t* source = static_cast<uint8_t*>(malloc(width * height));
+    uint8_t* target = static_cast<uint8_t*>(malloc(width * height));
+    if (!source || !target || iterations == 0) {
+        free(source);
+        free(target);
+        return result;
+    }
+    for (int i = 0; i < width * height; i++) {
+        source[i] = (uint8_t)((i * 31) ^ (i >> 7));
+    }
+    memset(target, 0, width * height);
+    
+    size_t previous = jobs.m_active;
+    jobs.setActiveWorkers(workers);
+    
+    // Flou gaussien 3x3 sur une image 320x240, bandes de 8 lignes
+    int64_t start = nowUs();
+    for (uint32_t n = 0; n < iterations; n++) {
+        jobs.parallelFor(1, height - 1, 8, [&](size_t first, size_t last) {
+            for (size_t y = first; y < last; y++) {
+                const uint8_t* above = source + (y - 1) * width;
+                const uint8_t* row = source + y * width;
+                const uint8_t* below = source + (y + 1) * width;
+                for (int x = 1; x < width - 1; x++) {
+                    int sum = above[x - 1] + 2 * above[x] + above[x + 1] +
+                              2 * row[x - 1] + 4 * row[x] + 2 * row[x + 1] +
+                              below[x - 1] + 2 * below[x] + below[x + 1];
+                    target[y * width + x] = sum >> 4;
+                }
+            }
+        });
+    }
+    result.usPerRun = (float)(nowUs() - start) / iterations;
+    
+    jobs.setActiveWorkers(previous);
+    free(source);
+    free(target);
+    return result;
+}
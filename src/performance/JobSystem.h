@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <condition_variable>
+#include <thread>
+#endif
+
+struct JobSystemStats {
+    uint32_t loops;             // parallelFor répartis
+    uint32_t serialLoops;       // Exécutés dans l'appelant (imbriqués, concurrents ou trop petits)
+    uint32_t chunks[8];         // Tranches exécutées par participant (0 = appelant)
+    uint32_t steals[8];
+};
+
+struct JobSystemBenchmark {
+    size_t workers;
+    uint32_t iterations;
+    float usPerRun;             // Convolution 3x3 sur 320x240
+};
+
+// Système de travaux pour les noyaux de vision découpables (bandes de
+// lignes, plages de modèles).
+// L'appelant de parallelFor participe (participant 0) ; les autres sont
+// des tâches FreeRTOS épinglées sur les autres cœurs (sur l'hôte, des
+// std::thread). Chaque participant possède une deque sans verrou
+// (Chase-Lev) de plages de tranches : il découpe sa plage en deux, garde
+// la moitié basse et dépose la haute, que les participants inactifs
+// volent. Un participant préempté ne retient donc que sa tranche en cours.
+// Un seul parallelFor est réparti à la fois ; un appel imbriqué ou
+// concurrent s'exécute simplement dans l'appelant.
+class JobSystem {
+public:
+    static const size_t MAX_WORKERS = 8;        // Appelant compris
+    
+    JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    // workers : participants, appelant compris ; 0 = un par cœur
+    bool begin(size_t workers = 0);
+    void end();
+    size_t getWorkerCount() const { return m_workers; }
+    
+    // Limite les participants sans arrêter les tâches (1 = séquentiel)
+    void setActiveWorkers(size_t count);
+    size_t getActiveWorkers() const { return m_active; }
+#ifdef ARDUINO
+    // Tâche du participant index (>= 1), pour la comptabilité CPU
+    TaskHandle_t getWorkerTask(size_t index) const { return m_tasks[index]; }
+#endif
+    
+    // body(first, last) sur des plages [first, last) alignées sur grain,
+    // depuis plusieurs participants à la fois : body n'écrit que dans ce
+    // qui appartient à sa plage
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& body) {
+        using Body = typename std::remove_reference<F>::type;
+        run(begin, end, grain, [](void* context, size_t first, size_t last) {
+            (*static_cast<Body*>(context))(first, last);
+        }, &body);
+    }
+    
+    JobSystemStats getStats() const;
+    
+    // Même noyau répété avec workers participants
+    static JobSystemBenchmark benchmark(JobSystem& jobs, size_t workers, uint32_t iterations);
+    
+private:
+    using RangeFunction = void (*)(void* context, size_t first, size_t last);
+    
+    // Deque de Chase-Lev à capacité fixe ; le propriétaire empile et dépile
+    // par le bas, les voleurs prennent par le haut. Une plage de tranches
+    // [first, last) tient dans un mot de 32 bits (16 bits chacune).
+    class WorkDeque {
+    public:
+        static const size_t CAPACITY = 64;      // Puissance de 2
+        
+        WorkDeque() : m_top(0), m_bottom(0) {}
+        void reset() { m_top.store(0); m_bottom.store(0); }
+        bool push(uint32_t range);
+        bool take(uint32_t& range);
+        bool steal(uint32_t& range);
+    
+    private:
+        std::atomic<int32_t> m_top;
+        std::atomic<int32_t> m_bottom;
+        std::atomic<uint32_t> m_items[CAPACITY];
+    };
+    
+    struct Loop {
+        RangeFunction function;
+        void* context;
+        size_t begin;
+        size_t end;
+        size_t grain;
+        std::atomic<uint32_t> remaining;        // Tranches non encore exécutées
+    };
+    
+    WorkDeque m_deques[MAX_WORKERS];
+    Loop m_loop;
+    std::mutex m_loopMutex;
+    size_t m_workers;
+    std::atomic<size_t> m_active;
+    std::atomic<bool> m_running;
+    std::atomic<uint32_t> m_busy;               // Participants hors appelant en cours de boucle
+    std::atomic<uint32_t> m_loops;
+    std::atomic<uint32_t> m_serialLoops;
+    std::atomic<uint32_t> m_chunks[MAX_WORKERS];
+    std::atomic<uint32_t> m_steals[MAX_WORKERS];
+
+#ifdef ARDUINO
+    TaskHandle_t m_tasks[MAX_WORKERS];
+#else
+    std::thread m_threads[MAX_WORKERS];
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    uint32_t m_generation;
+#endif
+
+    struct WorkerContext {
+        JobSystem* jobs;
+        size_t index;
+    };
+    WorkerContext m_contexts[MAX_WORKERS];
+    
+    void run(size_t begin, size_t end, size_t grain, RangeFunction function, void* context);
+    void participate(size_t self);
+    void execute(size_t self, uint32_t range);
+    bool stealAny(size_t self, uint32_t& range);
+    void wakeWorkers();
+    void workerLoop(size_t self);
+    static void workerTask(void* parameter);
+    
+    static uint32_t packRange(uint32_t first, uint32_t last) { return (first << 16) | last; }
+    static uint32_t rangeFirst(uint32_t range) { return range >> 16; }
+    static uint32_t rangeLast(uint32_t range) { return range & 0xFFFF; }
+};
+
+// jobs nul (ou pas démarré) : exécution séquentielle dans l'appelant
+template<typename F>
+inline void parallelFor(JobSystem* jobs, size_t begin, size_t end, size_t grain, F&& body) {
+    if (jobs) {
+        jobs->parallelFor(begin, end, grain, std::forward<F>(body));
+    } else if (begin < end) {
+        body(begin, end);
+    }
+}
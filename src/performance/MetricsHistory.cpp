@@ -0,0 +1,174 @@
+#include "MetricsHistory.h"
+#include "PerformanceManager.h"
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+struct MetricsHistory::Slot {
+    std::atomic<uint32_t> sequence;
+    PerformanceMetrics metrics;
+};
+
+namespace {
+    // Capacité et période de chaque niveau
+    const size_t TIER_CAPACITY[] = { 3600, 1440, 720 };       // 1 h, 24 h, 30 jours
+    const uint32_t TIER_PERIOD_MS[] = { 0, 60000, 3600000 };
+}
+
+MetricsHistory::MetricsHistory() {
+    for (int i = 0; i < RESOLUTION_COUNT; i++) {
+        m_tiers[i].slots = nullptr;
+        m_tiers[i].capacity = TIER_CAPACITY[i];
+        m_tiers[i].periodMs = TIER_PERIOD_MS[i];
+        m_tiers[i].head = 0;
+        memset(&m_accumulators[i], 0, sizeof(Accumulator));
+    }
+}
+
+MetricsHistory::~MetricsHistory() {
+    for (Tier& tier : m_tiers) {
+        if (tier.slots) heap_caps_free(tier.slots);
+    }
+}
+
+bool MetricsHistory::begin() {
+    for (Tier& tier : m_tiers) {
+        if (tier.slots) continue;
+        
+        size_t size = tier.capacity * sizeof(Slot);
+        void* memory = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!memory) {
+            memory = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+        }
+        if (!memory) return false;
+        
+        memset(memory, 0, size);
+        tier.slots = static_cast<Slot*>(memory);
+    }
+    return true;
+}
+
+void MetricsHistory::push(const PerformanceMetrics& metrics) {
+    if (!m_tiers[RESOLUTION_RAW].slots) return;
+    
+    append(m_tiers[RESOLUTION_RAW], metrics);
+    accumulate(RESOLUTION_MINUTE, metrics);
+}
+
+void MetricsHistory::append(Tier& tier, const PerformanceMetrics& metrics) {
+    uint32_t index = tier.head.load(std::memory_order_relaxed);
+    Slot& slot = tier.slots[index % tier.capacity];
+    
+    // Impair pendant l'écriture, puis 2 * index + 2
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.metrics = metrics;
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    tier.head.store(index + 1, std::memory_order_release);
+}
+
+void MetricsHistory::accumulate(Resolution resolution, const PerformanceMetrics& metrics) {
+    Accumulator& acc = m_accumulators[resolution];
+    uint64_t bucket = metrics.timestamp / m_tiers[resolution].periodMs;
+    
+    // Nouvelle période : la précédente est publiée (moyenne, tas minimal)
+    if (acc.count > 0 && bucket != acc.bucket) {
+        PerformanceMetrics average;
+        average.cpu_usage = acc.cpu / acc.count;
+        average.memory_usage = acc.memory / acc.count;
+        average.fps = acc.fps / acc.count;
+        average.processing_time = acc.processing / acc.count;
+        average.network_latency = acc.latency / acc.count;
+        average.temperature = acc.temperature / acc.count;
+        average.free_heap = acc.freeHeap / acc.count;
+        average.min_free_heap = acc.minFreeHeap;
+        average.timestamp = acc.timestamp;
+        
+        append(m_tiers[resolution], average);
+        if (resolution + 1 < RESOLUTION_COUNT) {
+            accumulate((Resolution)(resolution + 1), average);
+        }
+        memset(&acc, 0, sizeof(Accumulator));
+    }
+    
+    if (acc.count == 0) {
+        acc.bucket = bucket;
+        acc.minFreeHeap = metrics.min_free_heap;
+    }
+    acc.cpu += metrics.cpu_usage;
+    acc.memory += metrics.memory_usage;
+    acc.fps += metrics.fps;
+    acc.processing += metrics.processing_time;
+    acc.latency += metrics.network_latency;
+    acc.temperature += metrics.temperature;
+    acc.freeHeap += metrics.free_heap;
+    acc.minFreeHeap = std::min(acc.minFreeHeap, metrics.min_free_heap);
+    acc.timestamp = metrics.timestamp;
+    acc.count++;
+}
+
+bool MetricsHistory::readSlot(const Tier& tier, uint32_t index, PerformanceMetrics& out) const {
+    const Slot& slot = tier.slots[index % tier.capacity];
+    uint32_t expected = 2 * index + 2;
+    
+    // Quelques essais si le producteur écrit la case au même moment
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before > expected) return false;        // Déjà réécrite : entrée perdue
+        if (before != expected) continue;           // En cours d'écriture
+        
+        out = slot.metrics;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MetricsHistory::read(Resolution resolution, uint64_t after, uint64_t since,
+                            PerformanceMetrics* out, size_t max) const {
+    const Tier& tier = m_tiers[resolution];
+    if (!tier.slots || max == 0) return 0;
+    
+    uint32_t head = tier.head.load(std::memory_order_acquire);
+    uint32_t low = head > tier.capacity ? head - tier.capacity : 0;
+    uint32_t high = head;
+    uint64_t start = std::max(after + 1, since);
+    
+    // Horodatages croissants : recherche dichotomique du point de reprise.
+    // Une case réécrite entre-temps compte comme trop ancienne.
+    PerformanceMetrics probe;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (!readSlot(tier, middle, probe) || probe.timestamp < start) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    
+    size_t count = 0;
+    for (uint32_t index = low; index < head && count < max; index++) {
+        if (readSlot(tier, index, out[count]) && out[count].timestamp >= start) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool MetricsHistory::latest(PerformanceMetrics& out) const {
+    const Tier& tier = m_tiers[RESOLUTION_RAW];
+    uint32_t head = tier.head.load(std::memory_order_acquire);
+    return tier.slots && head > 0 && readSlot(tier, head - 1, out);
+}
+
+MetricsHistory::Resolution MetricsHistory::resolutionFor(uint64_t durationMs) {
+    for (int i = RESOLUTION_RAW; i < RESOLUTION_HOUR; i++) {
+        // Le niveau brut couvre capacité x intervalle, supposé de 1 s
+        uint64_t span = (uint64_t)TIER_CAPACITY[i] * (TIER_PERIOD_MS[i] ? TIER_PERIOD_MS[i] : 1000);
+        if (durationMs <= span) {
+            return (Resolution)i;
+        }
+    }
+    return RESOLUTION_HOUR;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+struct PerformanceMetrics;
+
+// Historique des métriques à trois résolutions, dans des anneaux
+// préalloués (PSRAM de préférence) :
+//   - 1 échantillon par intervalle de monitoring sur la dernière heure,
+//   - moyenne par minute sur 24 h,
+//   - moyenne par heure sur 30 jours.
+// Un seul producteur (la tâche de monitoring) ; les lecteurs ne prennent
+// aucun verrou. Chaque case porte un numéro de séquence (impair pendant
+// l'écriture, 2 * index + 2 ensuite) : un lecteur reconnaît une case en
+// cours d'écriture ou déjà réécrite et la saute ou recommence.
+class MetricsHistory {
+public:
+    enum Resolution : uint8_t {
+        RESOLUTION_RAW,         // Intervalle de monitoring (1 s par défaut)
+        RESOLUTION_MINUTE,
+        RESOLUTION_HOUR,
+        RESOLUTION_COUNT
+    };
+    
+    MetricsHistory();
+    ~MetricsHistory();
+    
+    bool begin();
+    
+    // Producteur unique ; horodatages croissants
+    void push(const PerformanceMetrics& metrics);
+    
+    // Copie au plus max entrées d'horodatage > after et >= since, dans
+    // l'ordre ; retourne le nombre copié
+    size_t read(Resolution resolution, uint64_t after, uint64_t since,
+                PerformanceMetrics* out, size_t max) const;
+    bool latest(PerformanceMetrics& out) const;
+    
+    // Résolution la plus fine qui couvre encore la durée demandée
+    static Resolution resolutionFor(uint64_t durationMs);
+    
+private:
+    struct Slot;
+    
+    // Moyenne en cours d'une période (minute ou heure)
+    struct Accumulator {
+        float cpu;
+        float memory;
+        float fps;
+        float processing;
+        float latency;
+        float temperature;
+        uint64_t freeHeap;
+        uint32_t minFreeHeap;
+        uint64_t timestamp;             // Dernier échantillon de la période
+        uint32_t count;
+        uint64_t bucket;
+    };
+    
+    struct Tier {
+        Slot* slots;
+        size_t capacity;
+        uint32_t periodMs;                  // 0 : pas d'agrégation (brut)
+        std::atomic<uint32_t> head;         // Nombre d'entrées publiées
+    };
+    
+    Tier m_tiers[RESOLUTION_COUNT];
+    Accumulator m_accumulators[RESOLUTION_COUNT];   // Alimente le niveau de même index
+    
+    void append(Tier& tier, const PerformanceMetrics& metrics);
+    void accumulate(Resolution resolution, const PerformanceMetrics& metrics);
+    bool readSlot(const Tier& tier, uint32_t index, PerformanceMetrics& out) const;
+};
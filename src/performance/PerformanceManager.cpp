@@ -1,18 +1,32 @@
 #include "PerformanceManager.h"
+#include <algorithm>
 #include <esp_heap_caps.h>
 #include <esp_system.h>
 #include <esp_task_wdt.h>
 #include <esp_pm.h>
 
 PerformanceManager::PerformanceManager() : 
+    m_jobs(nullptr),
+    m_jobs_core(1),
+    m_cache(CACHE_MAX_ENTRIES, m_config.cache_size),
     m_monitoring_running(false),
-    m_monitoring_task(nullptr) {
+    m_monitoring_task(nullptr),
+    m_previous_total_runtime(0),
+    m_cpu_interval_us(0),
+    m_core_load{0.0f, 0.0f},
+    m_cpu_history_head(0),
+    m_cpu_history_count(0) {
     m_metrics_mutex = xSemaphoreCreateMutex();
+    m_tasks_mutex = xSemaphoreCreateMutex();
 }
 
 bool PerformanceManager::begin() {
+    // Anneaux d'historique préalloués avant le premier échantillon
+    m_history.begin();
+    
     // Initialiser le monitoring
     if (m_config.enable_monitoring) {
+        m_monitoring_running = true;
         xTaskCreatePinnedToCore(
             monitoringTask,
             "monitor",
@@ -24,17 +38,15 @@ bool PerformanceManager::begin() {
         );
     }
     
-    // Initialiser le multicore si activé
-    if (m_config.enable_multicore) {
-        distributeTasksAcrossCores();
-    }
-    
     return true;
 }
 
 bool PerformanceManager::scheduleTask(const String& name, TaskFunction_t function,
                                     void* parameters, uint32_t stackSize, UBaseType_t priority) {
+    // La tâche de monitoring parcourt m_tasks pendant que l'API en ajoute
+    xSemaphoreTake(m_tasks_mutex, portMAX_DELAY);
     if (m_tasks.find(name) != m_tasks.end()) {
+        xSemaphoreGive(m_tasks_mutex);
         return false; // La tâche existe déjà
     }
     
@@ -48,8 +60,9 @@ bool PerformanceManager::scheduleTask(const String& name, TaskFunction_t functio
     // Créer la tâche
     BaseType_t result;
     if (m_config.enable_multicore) {
-        // Déterminer le meilleur core pour cette tâche
-        int core = 0; // Fallback si getOptimalCore n'est pas implémenté
+        // Non épinglée : l'ordonnanceur la fait passer d'un cœur à l'autre
+        // à chaque commutation, sans la recréer
+        BaseType_t core = tskNO_AFFINITY;
         result = xTaskCreatePinnedToCore(
             function,
             name.c_str(),
@@ -71,11 +84,13 @@ bool PerformanceManager::scheduleTask(const String& name, TaskFunction_t functio
     }
     
     if (result != pdPASS) {
+        xSemaphoreGive(m_tasks_mutex);
         return false;
     }
     
     task.running = true;
     m_tasks[name] = task;
+    xSemaphoreGive(m_tasks_mutex);
     
     return true;
 }
@@ -89,8 +104,123 @@ int PerformanceManager::getOptimalCore(const String& taskName) const {
 float PerformanceManager::calculateTaskCPUUsage(TaskHandle_t handle) const {
     if (!handle) return 0.0f;
     
-    // Version simplifiée - retourne une valeur simulée
-    return (float)(rand() % 100);
+    float usage = 0.0f;
+    if (xSemaphoreTake(m_metrics_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        for (const auto& task : m_task_cpu) {
+            if (task.handle == handle) {
+                usage = task.usage;
+                break;
+            }
+        }
+        xSemaphoreGive(m_metrics_mutex);
+    }
+    return usage;
+}
+
+float PerformanceManager::calculateCPUUsage() {
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    // Marge pour les tâches créées entre le comptage et la capture
+    size_t capacity = uxTaskGetNumberOfTasks() + 4;
+    if (m_task_status.size() < capacity) {
+        m_task_status.resize(capacity);
+    }
+    
+    uint32_t totalRunTime = 0;
+    UBaseType_t count = uxTaskGetSystemState(m_task_status.data(), m_task_status.size(), &totalRunTime);
+    if (count == 0) {
+        return (m_core_load[0] + m_core_load[1]) / 2.0f;
+    }
+    
+    // Compteurs 32 bits : la soustraction non signée absorbe le débordement
+    bool firstSample = m_previous_total_runtime == 0;
+    uint32_t elapsed = totalRunTime - m_previous_total_runtime;
+    m_previous_total_runtime = totalRunTime;
+    
+    TaskHandle_t idle[2] = { xTaskGetIdleTaskHandleForCPU(0), xTaskGetIdleTaskHandleForCPU(1) };
+    uint32_t idleDelta[2] = { 0, 0 };
+    
+    m_runtimes.clear();
+    m_task_cpu.clear();
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t& status = m_task_status[i];
+        
+        // Tâche apparue depuis le dernier échantillon : delta nul ce tour-ci
+        uint32_t previous = status.ulRunTimeCounter;
+        for (const auto& counter : m_previous_runtimes) {
+            if (counter.handle == status.xHandle) {
+                previous = counter.runTime;
+                break;
+            }
+        }
+        uint32_t delta = status.ulRunTimeCounter - previous;
+        m_runtimes.push_back({status.xHandle, status.ulRunTimeCounter});
+        
+        for (int core = 0; core < 2; core++) {
+            if (status.xHandle == idle[core]) idleDelta[core] = delta;
+        }
+        
+        TaskCpuUsage usage;
+        strlcpy(usage.name, status.pcTaskName, sizeof(usage.name));
+        usage.handle = status.xHandle;
+        BaseType_t affinity = xTaskGetAffinity(status.xHandle);
+        usage.core = affinity == tskNO_AFFINITY ? -1 : affinity;
+        usage.priority = status.uxCurrentPriority;
+        usage.usage = (!firstSample && elapsed > 0) ? std::min(100.0f, 100.0f * delta / elapsed) : 0.0f;
+        usage.stackHighWater = status.usStackHighWaterMark;
+        m_task_cpu.push_back(usage);
+    }
+    m_previous_runtimes.swap(m_runtimes);
+    
+    if (firstSample || elapsed == 0) {
+        return 0.0f;
+    }
+    
+    // Un cœur est occupé tout le temps que sa tâche IDLE n'a pas consommé
+    m_cpu_interval_us = elapsed;
+    for (int core = 0; core < 2; core++) {
+        float idleShare = 100.0f * idleDelta[core] / elapsed;
+        m_core_load[core] = std::max(0.0f, std::min(100.0f, 100.0f - idleShare));
+    }
+    
+    CpuLoadSample& sample = m_cpu_history[m_cpu_history_head];
+    sample.timestamp = esp_timer_get_time() / 1000;
+    sample.core[0] = (uint8_t)(m_core_load[0] + 0.5f);
+    sample.core[1] = (uint8_t)(m_core_load[1] + 0.5f);
+    m_cpu_history_head = (m_cpu_history_head + 1) % CPU_HISTORY_SIZE;
+    if (m_cpu_history_count < CPU_HISTORY_SIZE) m_cpu_history_count++;
+    
+    return (m_core_load[0] + m_core_load[1]) / 2.0f;
+#else
+    // Compteurs de run-time absents de la configuration FreeRTOS
+    return 0.0f;
+#endif
+}
+
+CpuReport PerformanceManager::getCpuReport() const {
+    CpuReport report = {};
+    if (xSemaphoreTake(m_metrics_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        report.core[0] = m_core_load[0];
+        report.core[1] = m_core_load[1];
+        report.intervalUs = m_cpu_interval_us;
+        report.tasks = m_task_cpu;
+        xSemaphoreGive(m_metrics_mutex);
+    }
+    return report;
+}
+
+size_t PerformanceManager::readCpuHistory(CpuLoadSample* out, size_t max) const {
+    if (xSemaphoreTake(m_metrics_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return 0;
+    }
+    
+    size_t count = std::min(max, m_cpu_history_count);
+    size_t start = (m_cpu_history_head + CPU_HISTORY_SIZE - count) % CPU_HISTORY_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = m_cpu_history[(start + i) % CPU_HISTORY_SIZE];
+    }
+    
+    xSemaphoreGive(m_metrics_mutex);
+    return count;
 }
 
 void PerformanceManager::monitoringTask(void* parameter) {
@@ -101,6 +231,9 @@ void PerformanceManager::monitoringTask(void* parameter) {
         manager->updateMetrics();
         manager->checkThresholds();
         manager->cleanupCache();
+        if (manager->m_config.enable_multicore) {
+            manager->balanceLoad();
+        }
         
         // Attendre l'intervalle configuré
         vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(manager->m_config.monitoring_interval));
@@ -118,6 +251,7 @@ void PerformanceManager::updateMetrics() {
         metrics.temperature = measureTemperature();
         metrics.free_heap = esp_get_free_heap_size();
         metrics.min_free_heap = esp_get_minimum_free_heap_size();
+        metrics.timestamp = esp_timer_get_time() / 1000;
         
         // Calculer le FPS moyen
         static uint32_t lastFrameTime = 0;
@@ -127,14 +261,46 @@ void PerformanceManager::updateMetrics() {
         }
         lastFrameTime = currentTime;
         
-        // Ajouter aux métriques historiques
-        m_metrics_history.push(metrics);
-        while (m_metrics_history.size() > 3600) { // Garder 1h d'historique
-            m_metrics_history.pop();
-        }
-        
         xSemaphoreGive(m_metrics_mutex);
+        
+        // Historique sans verrou : les lectures du tableau de bord ne bloquent pas le monitoring
+        m_history.push(metrics);
+    }
+}
+
+std::vector<PerformanceMetrics> PerformanceManager::getHistoricalMetrics(uint32_t duration) {
+    std::vector<PerformanceMetrics> result;
+    uint64_t now = esp_timer_get_time() / 1000;
+    uint64_t since = now > duration ? now - duration : 0;
+    MetricsHistory::Resolution resolution = MetricsHistory::resolutionFor(duration);
+    
+    PerformanceMetrics batch[32];
+    uint64_t cursor = 0;
+    size_t count;
+    while ((count = readHistory(resolution, cursor, since, batch, 32)) > 0) {
+        result.insert(result.end(), batch, batch + count);
+        cursor = batch[count - 1].timestamp;
     }
+    return result;
+}
+
+size_t PerformanceManager::readHistory(uint64_t after, uint64_t since,
+                                       PerformanceMetrics* out, size_t max) {
+    uint64_t now = esp_timer_get_time() / 1000;
+    MetricsHistory::Resolution resolution = MetricsHistory::resolutionFor(now > since ? now - since : 0);
+    return m_history.read(resolution, after, since, out, max);
+}
+
+size_t PerformanceManager::readHistory(MetricsHistory::Resolution resolution, uint64_t after,
+                                       uint64_t since, PerformanceMetrics* out, size_t max) {
+    return m_history.read(resolution, after, since, out, max);
+}
+
+PerformanceMetrics PerformanceManager::getMetrics() {
+    // Dernier échantillon publié (valeurs nulles avant le premier)
+    PerformanceMetrics metrics;
+    m_history.latest(metrics);
+    return metrics;
 }
 
 void PerformanceManager::checkThresholds() {
@@ -163,6 +329,8 @@ void PerformanceManager::optimizeMemory() {
         cacheClear();
     }
     
+    defragmentMemory();
+    
     // Identifier et gérer les fuites mémoire
     identifyMemoryLeaks();
 }
@@ -176,65 +344,206 @@ void PerformanceManager::optimizeCPU() {
         balanceLoad();
     }
     
-    // Suspendre les tâches non critiques si nécessaire
+    // Suspendre les tâches non critiques si nécessaire, hors verrou :
+    // suspendTask peut lui-même consulter m_tasks
+    std::vector<String> lowPriority;
+    xSemaphoreTake(m_tasks_mutex, portMAX_DELAY);
     for (auto& task : m_tasks) {
         if (task.second.priority < 3) { // Tâches basse priorité
-            suspendTask(task.first);
+            lowPriority.push_back(task.first);
         }
     }
+    xSemaphoreGive(m_tasks_mutex);
+    for (const String& name : lowPriority) {
+        suspendTask(name);
+    }
+}
+
+void PerformanceManager::setJobSystem(JobSystem* jobs, int callerCore) {
+    xSemaphoreTake(m_tasks_mutex, portMAX_DELAY);
+    m_jobs = jobs;
+    m_jobs_core = callerCore;
+    xSemaphoreGive(m_tasks_mutex);
 }
 
-void PerformanceManager::balanceLoad() {
-    struct CoreLoad {
-        float usage;
-        std::vector<String> tasks;
-    };
+LoadBalanceReport PerformanceManager::balanceLoad() {
+    LoadBalanceReport report = {};
+    CpuReport cpu = getCpuReport();
+    report.core[0] = cpu.core[0];
+    report.core[1] = cpu.core[1];
     
-    std::array<CoreLoad, 2> cores;
+    xSemaphoreTake(m_tasks_mutex, portMAX_DELAY);
     
-    // Calculer la charge par core
-    for (const auto& task : m_tasks) {
-        if (!task.second.running) continue;
+    // Le noyau ESP-IDF classique ne change pas l'affinité d'une tâche à
+    // chaud et une tâche n'est jamais recréée sur l'autre cœur. Le levier
+    // portable est la participation du JobSystem : ses participants du cœur
+    // d'en face prennent une part des boucles de la vision, retirée quand
+    // ce cœur est pris par d'autres tâches.
+    report.participants = 1;
+    if (m_jobs && m_jobs->getWorkerCount() > 1) {
+        // Charge propre aux participants déduite : sinon les retirer ferait
+        // baisser la mesure et les rappellerait à l'intervalle suivant
+        for (const auto& usage : cpu.tasks) {
+            for (size_t i = 1; i < m_jobs->getWorkerCount(); i++) {
+                if (usage.handle == m_jobs->getWorkerTask(i) && usage.core >= 0 && usage.core < 2) {
+                    report.core[usage.core] = std::max(0.0f, report.core[usage.core] - usage.usage);
+                }
+            }
+        }
         
-        int core = xTaskGetAffinity(task.second.handle);
-        if (core >= 0 && core < 2) {
-            cores[core].tasks.push_back(task.first);
-            cores[core].usage += 50.0f;  // Valeur par défaut de 50% par tâche
+        int helperCore = 1 - m_jobs_core;
+        float excess = report.core[helperCore] - report.core[m_jobs_core];
+        size_t active = m_jobs->getActiveWorkers();
+        size_t wanted = active;
+        if (excess > LOAD_IMBALANCE_THRESHOLD) {
+            wanted = 1;
+        } else if (excess < LOAD_BALANCED_THRESHOLD) {
+            wanted = m_jobs->getWorkerCount();
         }
-    }
-    
-    // Rééquilibrer si nécessaire
-    if (std::abs(cores[0].usage - cores[1].usage) > 20.0f) { // Différence > 20%
-        // Déplacer des tâches du core le plus chargé vers le moins chargé
-        int sourceCore = cores[0].usage > cores[1].usage ? 0 : 1;
-        int targetCore = 1 - sourceCore;
         
-        for (const auto& taskName : cores[sourceCore].tasks) {
-            auto& task = m_tasks[taskName];
+        if (wanted != active) {
+            m_jobs->setActiveWorkers(wanted);
+            report.changed = true;
+        }
+        report.available = true;
+        report.participants = wanted;
+    }
+
+#if CONFIG_FREERTOS_SMP && configUSE_CORE_AFFINITY
+    // Noyau SMP : restreindre en plus la tâche planifiée la plus coûteuse
+    // au cœur le moins chargé
+    float imbalance = cpu.core[0] - cpu.core[1];
+    if (std::abs(imbalance) < LOAD_BALANCED_THRESHOLD) {
+        // Écart résorbé : rendre les deux cœurs aux tâches restreintes
+        for (auto& task : m_tasks) {
+            if (task.second.pinned && task.second.running) {
+                vTaskCoreAffinitySet(task.second.handle, tskNO_AFFINITY);
+                report.changed = true;
+            }
+            task.second.pinned = false;
+        }
+    } else if (std::abs(imbalance) > LOAD_IMBALANCE_THRESHOLD) {
+        int targetCore = imbalance > 0 ? 1 : 0;
+        ScheduledTask* heaviest = nullptr;
+        float heaviestUsage = 0.0f;
+        for (auto& task : m_tasks) {
+            if (!task.second.running || task.second.pinned) continue;
             
-            // Recréer la tâche sur l'autre core
-            TaskHandle_t newHandle;
-            if (xTaskCreatePinnedToCore(
-                task.function,
-                task.name.c_str(),
-                task.stackSize,
-                task.parameters,
-                task.priority,
-                &newHandle,
-                targetCore
-            ) == pdPASS) {
-                // Supprimer l'ancienne tâche
-                vTaskDelete(task.handle);
-                task.handle = newHandle;
+            for (const auto& usage : cpu.tasks) {
+                if (usage.handle == task.second.handle && usage.usage > heaviestUsage) {
+                    heaviest = &task.second;
+                    heaviestUsage = usage.usage;
+                }
             }
         }
+        
+        if (heaviest) {
+            vTaskCoreAffinitySet(heaviest->handle, 1 << targetCore);
+            heaviest->pinned = true;
+            report.changed = true;
+        }
+    }
+    report.available = true;
+    for (const auto& task : m_tasks) {
+        if (task.second.pinned) report.pinned++;
     }
+#endif
+
+    xSemaphoreGive(m_tasks_mutex);
+    return report;
 }
 
 void PerformanceManager::identifyMemoryLeaks() {
-    // Version simplifiée sans heap tracing
     cleanupCache();
     monitorStackUsage();
+    
+    // Sites dont les allocations survivent depuis le début du suivi
+    if (m_heap.isTracking()) {
+        m_heap.updateLeakSuspects(LEAK_MIN_BYTES);
+    }
+}
+
+void PerformanceManager::compactHeap() {
+    // Le tas ESP-IDF ne déplace pas les blocs : on ne peut que rendre ce
+    // qu'on retient. Les valeurs expirées du cache libèrent leurs blocs PSRAM.
+    cleanupCache();
+}
+
+void PerformanceManager::defragmentMemory() {
+    compactHeap();
+    
+    // Valeurs du cache : seule grosse population de blocs de tailles
+    // variées qu'on possède en PSRAM. Tout rendre laisse les blocs libres
+    // se fusionner ; le cache se reconstruit à la demande.
+    HeapRegionStats psram = HeapProfiler::getPsramStats();
+    if (psram.totalFree > 0 && psram.fragmentation > FRAGMENTATION_THRESHOLD) {
+        cacheClear();
+    }
+}
+
+bool PerformanceManager::setAllocationTracking(bool enable) {
+    if (!enable) {
+        m_heap.stopTracking();
+        return true;
+    }
+    return m_heap.startTracking();
+}
+
+HeapReport PerformanceManager::getHeapReport() const {
+    HeapReport report;
+    report.internal = HeapProfiler::getInternalStats();
+    report.psram = HeapProfiler::getPsramStats();
+    report.frames = HeapProfiler::getFrameStats();
+    report.trackingAvailable = HeapProfiler::isAvailable();
+    report.tracking = HeapProfiler::isTracking();
+    report.snapshots = m_heap.listSnapshots();
+    report.leakSuspects = m_heap.getLeakSuspects();
+    return report;
+}
+
+uint32_t PerformanceManager::takeHeapSnapshot() {
+    return m_heap.takeSnapshot();
+}
+
+bool PerformanceManager::getHeapSnapshot(uint32_t id, HeapSnapshot& out) const {
+    return m_heap.getSnapshot(id, out);
+}
+
+bool PerformanceManager::diffHeapSnapshots(uint32_t from, uint32_t to, std::vector<CallSiteDelta>& out) {
+    return m_heap.diff(from, to, out);
+}
+
+void PerformanceManager::cacheInvalidate(const String& key) {
+    m_cache.remove(key);
+}
+
+void PerformanceManager::cacheClear() {
+    m_cache.clear();
+}
+
+void PerformanceManager::cleanupCache() {
+    // Avance la roue temporelle : les entrées expirées libèrent leur place
+    m_cache.expire(CacheEngine::nowMs());
+}
+
+CacheStats PerformanceManager::getCacheStats() const {
+    return m_cache.getStats();
+}
+
+CacheBenchmarkResult PerformanceManager::benchmarkCache(size_t operations) {
+    return CacheEngine::benchmark(operations);
+}
+
+void PerformanceManager::setConfig(const PerformanceConfig& config) {
+    m_config = config;
+    m_cache.setCapacity(config.cache_size);
+    if (!config.enable_cache) {
+        m_cache.clear();
+    }
+}
+
+PerformanceConfig PerformanceManager::getConfig() const {
+    return m_config;
 }
 
 // Le reste des méthodes reste inchangé...
\ No newline at end of file
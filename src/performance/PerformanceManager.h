@@ -4,10 +4,12 @@
 #include <freertos/task.h>
 #include <esp_timer.h>
 #include <vector>
-#include <queue>
 #include <map>
-#include <any>
 #include "Config.h"
+#include "CacheEngine.h"
+#include "JobSystem.h"
+#include "MetricsHistory.h"
+#include "HeapProfiler.h"
 
 // Structure pour les statistiques de performance
 struct PerformanceMetrics {
@@ -42,6 +44,7 @@ struct ScheduledTask {
     UBaseType_t priority;
     TaskHandle_t handle;
     bool running;
+    bool pinned;                // Affinité restreinte par balanceLoad
     
     ScheduledTask() :
         function(nullptr),
@@ -49,16 +52,49 @@ struct ScheduledTask {
         stackSize(4096),
         priority(1),
         handle(nullptr),
-        running(false) {}
+        running(false),
+        pinned(false) {}
 };
 
-// Structure pour le cache
-template<typename T>
-struct CacheEntry {
-    T data;
-    uint64_t timestamp;
-    uint32_t ttl;
-    bool valid;
+// Utilisation CPU d'une tâche sur le dernier intervalle de monitoring
+struct TaskCpuUsage {
+    char name[configMAX_TASK_NAME_LEN];
+    TaskHandle_t handle;
+    int8_t core;                // -1 : non épinglée
+    UBaseType_t priority;
+    float usage;                // % d'un cœur
+    uint32_t stackHighWater;    // Octets jamais utilisés
+};
+
+// Échantillon compact de l'historique CPU, un par intervalle
+struct CpuLoadSample {
+    uint32_t timestamp;         // ms depuis le démarrage
+    uint8_t core[2];            // %
+};
+
+struct CpuReport {
+    float core[2];              // % d'occupation (100 - part de la tâche IDLE)
+    uint32_t intervalUs;        // Durée mesurée par le compteur de run-time
+    std::vector<TaskCpuUsage> tasks;
+};
+
+struct HeapReport {
+    HeapRegionStats internal;
+    HeapRegionStats psram;
+    FrameAllocStats frames;
+    bool trackingAvailable;
+    bool tracking;
+    std::vector<uint32_t> snapshots;
+    std::vector<CallSiteDelta> leakSuspects;
+};
+
+// Décision d'un rééquilibrage (balanceLoad)
+struct LoadBalanceReport {
+    float core[2];              // Charge (%) hors participants du JobSystem
+    bool available;             // JobSystem à plusieurs participants rattaché
+    bool changed;               // Participation modifiée par cet appel
+    size_t participants;        // Participants actifs après décision
+    uint8_t pinned;             // Tâches restreintes à un cœur (noyau SMP)
 };
 
 // Configuration du gestionnaire de performances
@@ -66,8 +102,8 @@ struct PerformanceConfig {
     bool enable_multicore;
     bool enable_cache;
     bool enable_monitoring;
-    uint32_t cache_size;
-    uint32_t default_cache_ttl;
+    uint32_t cache_size;          // Octets (clés + valeurs)
+    uint32_t default_cache_ttl;   // ms, utilisé quand cacheSet reçoit ttl = 0
     uint32_t monitoring_interval;
     float cpu_threshold;
     float memory_threshold;
@@ -98,15 +134,35 @@ public:
     bool suspendTask(const String& name);
     bool resumeTask(const String& name);
     
-    // Cache
+    // Cache : types trivialement copiables ou String, copiés à l'écriture
+    // et à la lecture ; une lecture avec un autre type que l'écriture échoue.
+    // Les handles évitent de rehacher la clé à chaque accès.
     template<typename T>
-    bool cacheSet(const String& key, const T& value, uint32_t ttl = 0);
+    bool cacheSet(const String& key, const T& value, uint32_t ttl = 0) {
+        return cacheSet(CacheEngine::Handle<T>(key), value, ttl);
+    }
     
     template<typename T>
-    bool cacheGet(const String& key, T& value);
+    bool cacheGet(const String& key, T& value) {
+        return cacheGet(CacheEngine::Handle<T>(key), value);
+    }
+    
+    template<typename T>
+    bool cacheSet(const CacheEngine::Handle<T>& handle, const T& value, uint32_t ttl = 0) {
+        if (!m_config.enable_cache) return false;
+        return m_cache.set(handle, value, ttl > 0 ? ttl : m_config.default_cache_ttl);
+    }
+    
+    template<typename T>
+    bool cacheGet(const CacheEngine::Handle<T>& handle, T& value) {
+        if (!m_config.enable_cache) return false;
+        return m_cache.get(handle, value);
+    }
     
     void cacheInvalidate(const String& key);
     void cacheClear();
+    CacheStats getCacheStats() const;
+    CacheBenchmarkResult benchmarkCache(size_t operations = 10000);
     
     // Monitoring
     PerformanceMetrics getMetrics();
@@ -114,6 +170,21 @@ public:
     bool isSystemHealthy();
     std::vector<String> getWarnings();
     
+    // Comptabilité CPU (compteurs de run-time FreeRTOS, échantillonnés à
+    // chaque intervalle de monitoring)
+    CpuReport getCpuReport() const;
+    // Copie les max échantillons les plus récents, du plus ancien au plus récent
+    size_t readCpuHistory(CpuLoadSample* out, size_t max) const;
+    
+    // Profil du tas : fragmentation toujours disponible ; suivi des
+    // allocations vivantes par site d'appel à la demande (coûteux)
+    bool setAllocationTracking(bool enable);
+    HeapReport getHeapReport() const;
+    uint32_t takeHeapSnapshot();
+    bool getHeapSnapshot(uint32_t id, HeapSnapshot& out) const;
+    // to = 0 : comparé à l'état courant
+    bool diffHeapSnapshots(uint32_t from, uint32_t to, std::vector<CallSiteDelta>& out);
+    
     // Configuration
     void setConfig(const PerformanceConfig& config);
     PerformanceConfig getConfig() const;
@@ -121,19 +192,45 @@ public:
     // Optimisation
     void optimizeMemory();
     void optimizeCPU();
-    void balanceLoad();
+    // Répartit les boucles du JobSystem selon la charge mesurée par cœur ;
+    // appelée à chaque intervalle de monitoring en multicœur
+    LoadBalanceReport balanceLoad();
+    // callerCore : cœur de l'appelant de parallelFor (boucle de vision)
+    void setJobSystem(JobSystem* jobs, int callerCore);
     
     // Statistiques
     void logMetrics();
     std::vector<PerformanceMetrics> getHistoricalMetrics(uint32_t duration = 3600000);
+    
+    // Lecture par curseur pour les réponses découpées : copie au plus max
+    // entrées d'horodatage > after (et >= since), retourne le nombre copié.
+    // Sans verrou ; la résolution (brute, minute, heure) suit l'ancienneté
+    // de since, ou est imposée.
+    size_t readHistory(uint64_t after, uint64_t since, PerformanceMetrics* out, size_t max);
+    size_t readHistory(MetricsHistory::Resolution resolution, uint64_t after, uint64_t since,
+                       PerformanceMetrics* out, size_t max);
 
 private:
+    static const size_t CACHE_MAX_ENTRIES = 256;
+    static const size_t CPU_HISTORY_SIZE = 300;   // 5 min à 1 s
+    static const uint32_t LEAK_MIN_BYTES = 4096;   // Croissance d'un site signalée
+    static constexpr float FRAGMENTATION_THRESHOLD = 50.0f;   // %
+    static constexpr float LOAD_IMBALANCE_THRESHOLD = 20.0f;  // % d'écart entre cœurs
+    static constexpr float LOAD_BALANCED_THRESHOLD = 10.0f;
+    
+    struct RunTimeCounter {
+        TaskHandle_t handle;
+        uint32_t runTime;
+    };
+    
     PerformanceConfig m_config;
-    std::map<String, ScheduledTask> m_tasks;
-    std::map<String, std::any> m_cache;
-    std::map<String, uint64_t> m_cache_timestamps;
-    std::map<String, uint32_t> m_cache_ttls;
-    std::queue<PerformanceMetrics> m_metrics_history;
+    std::map<String, ScheduledTask> m_tasks;   // Protégée par m_tasks_mutex
+    SemaphoreHandle_t m_tasks_mutex;           // m_tasks et état du rééquilibrage
+    JobSystem* m_jobs;
+    int m_jobs_core;
+    CacheEngine m_cache;
+    MetricsHistory m_history;           // Écrit par la seule tâche de monitoring
+    HeapProfiler m_heap;
     std::vector<String> m_warnings;
     
     // Monitoring interne
@@ -141,6 +238,18 @@ private:
     bool m_monitoring_running;
     SemaphoreHandle_t m_metrics_mutex;
     
+    // Comptabilité CPU, protégée par m_metrics_mutex ; tampons réutilisés
+    std::vector<TaskStatus_t> m_task_status;
+    std::vector<RunTimeCounter> m_runtimes;
+    std::vector<RunTimeCounter> m_previous_runtimes;
+    uint32_t m_previous_total_runtime;
+    uint32_t m_cpu_interval_us;
+    float m_core_load[2];
+    std::vector<TaskCpuUsage> m_task_cpu;
+    CpuLoadSample m_cpu_history[CPU_HISTORY_SIZE];
+    size_t m_cpu_history_head;
+    size_t m_cpu_history_count;
+    
     // Méthodes internes
     static void monitoringTask(void* parameter);
     int getOptimalCore(const String& taskName) const;
@@ -150,15 +259,9 @@ private:
     void cleanupCache();
     uint32_t calculateOptimalStackSize(const String& taskName);
     UBaseType_t calculateOptimalPriority(const String& taskName);
-    void distributeTasksAcrossCores();
-    
-    // Cache helpers
-    bool isKeyValid(const String& key);
-    void removeExpiredEntries();
-    uint64_t getCurrentTimestamp();
     
     // Métriques helpers
-    float calculateCPUUsage();
+    float calculateCPUUsage();      // Échantillonne ; appelée verrou pris
     float calculateMemoryUsage();
     float measureTemperature();
     float calculateProcessingTime(const String& taskName);
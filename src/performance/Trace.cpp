@@ -0,0 +1,294 @@
+#include "Trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+namespace Trace {
+
+namespace {
+    struct Event {
+        std::atomic<uint32_t> sequence;     // Impair pendant l'écriture, 2 * index + 2 ensuite
+        const char* name;
+        uint32_t cycles;                    // Durée
+        uint8_t task;
+        uint64_t timestampUs;               // Fin de la portée, horloge commune aux cœurs
+    };
+    
+    struct Ring {
+        Event* events;
+        std::atomic<uint32_t> head;         // Événements réservés depuis le démarrage
+        std::atomic<uint32_t> floor;        // Premier index exporté (clear)
+    };
+    
+    struct TaskTrack {
+        std::atomic<bool> ready;
+        char name[16];
+    };
+    
+    Ring rings[CORES];
+    std::atomic<size_t> capacity(0);        // 0 : pas démarré
+    std::atomic<uint32_t> migrated(0);
+    std::atomic<uint32_t> taskCount(0);
+    TaskTrack tasks[MAX_TASKS];
+    float cyclesPerUs = 1.0f;
+    
+    // Piste de la tâche courante, attribuée au premier événement
+    thread_local uint8_t currentTask = 0xFF;
+
+#ifndef ARDUINO
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+#endif
+
+    uint64_t nowUs() {
+#ifdef ARDUINO
+        return esp_timer_get_time();
+#else
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+#endif
+    }
+    
+    uint8_t taskTrack() {
+        if (currentTask != 0xFF) return currentTask;
+        
+        // La dernière piste (sans nom) regroupe les tâches en surnombre
+        uint32_t index = taskCount.load(std::memory_order_relaxed);
+        do {
+            if (index >= MAX_TASKS - 1) {
+                index = MAX_TASKS - 1;
+                break;
+            }
+        } while (!taskCount.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+        
+        TaskTrack& track = tasks[index];
+        if (index < MAX_TASKS - 1) {
+#ifdef ARDUINO
+            strncpy(track.name, pcTaskGetName(nullptr), sizeof(track.name) - 1);
+#else
+            snprintf(track.name, sizeof(track.name), "thread %u", (unsigned)index);
+#endif
+            track.ready.store(true, std::memory_order_release);
+        }
+        currentTask = index;
+        return currentTask;
+    }
+    
+    bool readEvent(const Ring& ring, uint32_t index, size_t mask,
+                   const char*& name, uint32_t& cycles, uint8_t& task, uint64_t& timestampUs) {
+        const Event& event = ring.events[index & mask];
+        uint32_t expected = 2 * index + 2;
+        if (event.sequence.load(std::memory_order_acquire) != expected) return false;
+        
+        name = event.name;
+        cycles = event.cycles;
+        task = event.task;
+        timestampUs = event.timestampUs;
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return event.sequence.load(std::memory_order_relaxed) == expected;
+    }
+    
+    // Les size derniers événements au plus, après le dernier clear
+    uint32_t firstIndex(const Ring& ring, uint32_t end, size_t size) {
+        uint32_t oldest = end - std::min<uint32_t>(end, size);
+        uint32_t floor = ring.floor.load();
+        bool floorInRange = (int32_t)(floor - oldest) > 0 && (int32_t)(end - floor) >= 0;
+        return floorInRange ? floor : oldest;
+    }
+}
+
+bool begin(size_t eventsPerCore) {
+    if (capacity.load()) return true;
+    
+    // Arrondi à la puissance de 2 inférieure : index & masque
+    size_t count = 1;
+    while (count * 2 <= eventsPerCore) count *= 2;
+    
+    for (Ring& ring : rings) {
+        size_t size = count * sizeof(Event);
+#ifdef ARDUINO
+        void* memory = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!memory) {
+            memory = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+        }
+#else
+        void* memory = malloc(size);
+#endif
+        if (!memory) return false;
+        
+        memset(memory, 0, size);
+        ring.events = static_cast<Event*>(memory);
+        ring.head.store(0);
+        ring.floor.store(0);
+    }
+
+#ifdef ARDUINO
+    cyclesPerUs = getCpuFrequencyMhz();
+#elif defined(__x86_64__) || defined(__i386__)
+    // Fréquence du TSC mesurée contre l'horloge monotone
+    uint64_t startUs = nowUs();
+    uint32_t startCycles = cycles();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    cyclesPerUs = (float)(uint32_t)(cycles() - startCycles) / (float)(nowUs() - startUs);
+#else
+    cyclesPerUs = 1000.0f;      // Compteur en nanosecondes
+#endif
+
+    capacity.store(count, std::memory_order_release);
+    return true;
+}
+
+void clear() {
+    for (Ring& ring : rings) {
+        ring.floor.store(ring.head.load());
+    }
+}
+
+TraceStats getStats() {
+    TraceStats stats = {};
+    size_t size = capacity.load();
+    for (Ring& ring : rings) {
+        uint32_t head = ring.head.load();
+        uint32_t pending = head - ring.floor.load();
+        stats.recorded += head;
+        stats.overwritten += pending > size ? pending - size : 0;
+    }
+    stats.migrated = migrated.load();
+    stats.capacity = size;
+    stats.tasks = std::min<uint32_t>(taskCount.load(), MAX_TASKS);
+    return stats;
+}
+
+uint8_t currentCore() {
+#ifdef ARDUINO
+    return xPortGetCoreID();
+#elif defined(__linux__)
+    int cpu = sched_getcpu();
+    return cpu > 0 ? cpu % CORES : 0;
+#else
+    return 0;
+#endif
+}
+
+void record(const char* name, uint8_t core, uint32_t startCycles, uint32_t endCycles) {
+    size_t size = capacity.load(std::memory_order_acquire);
+    if (!size) return;
+    
+    // Compteurs de cycles propres à chaque cœur : durée sans signification
+    if (currentCore() != core) {
+        migrated.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    Ring& ring = rings[core];
+    uint32_t index = ring.head.fetch_add(1, std::memory_order_relaxed);
+    Event& event = ring.events[index & (size - 1)];
+    
+    event.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.cycles = endCycles - startCycles;
+    event.task = taskTrack();
+    event.timestampUs = nowUs();
+    event.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+Reader::Reader() :
+    m_stage(0),
+    m_index(0),
+    m_core(0),
+    m_next(0) {
+    size_t size = capacity.load(std::memory_order_acquire);
+    for (size_t core = 0; core < CORES; core++) {
+        m_end[core] = size ? rings[core].head.load(std::memory_order_acquire) : 0;
+    }
+}
+
+size_t Reader::next(char* buffer, size_t size) {
+    int length = 0;
+    
+    // Nom du processus puis une piste nommée par tâche
+    if (m_stage == 0) {
+        m_stage = 1;
+        length = snprintf(buffer, size,
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"HuskyLens\"}}");
+        return length > 0 ? std::min<size_t>(length, size - 1) : 0;
+    }
+    
+    if (m_stage == 1) {
+        size_t count = std::min<size_t>(taskCount.load(), MAX_TASKS);
+        while (m_index < count) {
+            size_t index = m_index++;
+            if (!tasks[index].ready.load(std::memory_order_acquire)) continue;
+            length = snprintf(buffer, size,
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                (unsigned)index, tasks[index].name);
+            return length > 0 ? std::min<size_t>(length, size - 1) : 0;
+        }
+        m_stage = 2;
+        m_core = 0;
+        m_next = firstIndex(rings[0], m_end[0], capacity.load());
+    }
+    
+    size_t ringSize = capacity.load(std::memory_order_acquire);
+    if (!ringSize) return 0;
+    
+    while (m_core < CORES) {
+        if (m_next == m_end[m_core]) {
+            if (++m_core < CORES) {
+                m_next = firstIndex(rings[m_core], m_end[m_core], ringSize);
+            }
+            continue;
+        }
+        
+        const char* name;
+        uint32_t cycles;
+        uint8_t task;
+        uint64_t timestampUs;
+        uint32_t index = m_next++;
+        if (!readEvent(rings[m_core], index, ringSize - 1, name, cycles, task, timestampUs)) {
+            continue;           // Réécrit depuis la création du curseur
+        }
+        
+        double duration = cycles / cyclesPerUs;
+        length = snprintf(buffer, size,
+            "{\"name\":\"%s\",\"cat\":\"core%u\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            name, (unsigned)m_core, (double)timestampUs - duration, duration, (unsigned)task);
+        return length > 0 ? std::min<size_t>(length, size - 1) : 0;
+    }
+    return 0;
+}
+
+#ifdef ARDUINO
+void dump(Print& out) {
+    Reader reader;
+    char record[192];
+    bool first = true;
+    
+    out.print("{\"traceEvents\":[\n");
+    while (size_t length = reader.next(record, sizeof(record))) {
+        if (!first) out.print(",\n");
+        out.write(reinterpret_cast<const uint8_t*>(record), length);
+        first = false;
+    }
+    out.print("\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+#endif
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+#pragma once
+
+// Traçage des portées du chemin critique, exporté au format Chrome Trace
+// Event (chrome://tracing, ui.perfetto.dev).
+// Compilé seulement avec -DTRACE_ENABLED (build_flags) ; sinon les macros
+// ne produisent aucun code et aucune mémoire n'est réservée.
+//
+//   TRACE_SCOPE("DataProcessor::process");    // jusqu'à la fin du bloc
+//
+// L'entrée d'une portée lit le compteur de cycles du cœur ; la sortie
+// écrit l'événement dans l'anneau de ce cœur : case réservée par
+// fetch_add, publiée par numéro de séquence comme dans MetricsHistory.
+// Ni verrou ni allocation ; le lecteur copie sans arrêter les écrivains
+// et saute les cases réécrites entre-temps.
+// Les noms sont des littéraux : seul le pointeur est conservé.
+
+#ifdef TRACE_ENABLED
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include <esp_idf_version.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#ifndef TRACE_EVENTS_PER_CORE
+#define TRACE_EVENTS_PER_CORE 4096      // Puissance de 2 ; 24 octets par événement
+#endif
+
+namespace Trace {
+    static const size_t CORES = 2;
+    static const size_t MAX_TASKS = 24;         // Au-delà : piste commune "autres"
+    
+    struct TraceStats {
+        uint32_t recorded;
+        uint32_t overwritten;       // Écrasés avant d'avoir été lus
+        uint32_t migrated;          // Portées ignorées : tâche passée sur l'autre cœur
+        uint32_t capacity;          // Par cœur
+        uint32_t tasks;
+    };
+    
+    // Alloue les anneaux (PSRAM de préférence) ; avant, les portées ne
+    // coûtent que deux lectures du compteur
+    bool begin(size_t eventsPerCore = TRACE_EVENTS_PER_CORE);
+    // Les lectures suivantes ne commencent qu'après les événements actuels
+    void clear();
+    TraceStats getStats();
+    
+    inline uint32_t cycles() {
+#ifdef ARDUINO
+#if ESP_IDF_VERSION_MAJOR >= 5
+        return esp_cpu_get_cycle_count();
+#else
+        return esp_cpu_get_ccount();
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+        return (uint32_t)__rdtsc();
+#else
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    
+    uint8_t currentCore();
+    void record(const char* name, uint8_t core, uint32_t startCycles, uint32_t endCycles);
+    
+    class Scope {
+    public:
+        explicit Scope(const char* name) :
+            m_name(name),
+            m_core(currentCore()),
+            m_start(cycles()) {}
+        
+        ~Scope() { record(m_name, m_core, m_start, cycles()); }
+        
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    
+    private:
+        const char* m_name;
+        uint8_t m_core;
+        uint32_t m_start;
+    };
+    
+    // Curseur d'export : un objet JSON par appel (métadonnées des pistes,
+    // puis les événements cœur par cœur), sans séparateur. Les événements
+    // publiés après la création du curseur ne sont pas lus.
+    class Reader {
+    public:
+        Reader();
+        // Écrit l'objet suivant dans buffer ; 0 quand la trace est épuisée
+        size_t next(char* buffer, size_t size);
+    
+    private:
+        uint8_t m_stage;
+        size_t m_index;
+        size_t m_core;
+        uint32_t m_next;
+        uint32_t m_end[CORES];
+    };
+
+#ifdef ARDUINO
+    // Trace complète {"traceEvents":[...]} (port série)
+    void dump(Print& out);
+#endif
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_BEGIN() Trace::begin()
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#ifdef ARDUINO
+#define TRACE_DUMP(out) Trace::dump(out)
+#endif
+
+#else
+
+#define TRACE_BEGIN()
+#define TRACE_SCOPE(name)
+#define TRACE_DUMP(out)
+
+#endif
@@ -257,9 +257,13 @@ void SecurityManager::logSecurityEvent(const String& event) {
                      String(static_cast<int>(m_level)) + "|" +
                      event + "\n";
     
-    File file = SPIFFS.open("/secure/security.log", "a");
+    File file = SPIFFS.open(SECURITY_LOG_FILE, "a");
     if (file) {
         file.print(logEntry);
         file.close();
     }
+}
+
+File SecurityManager::openSecurityLog() {
+    return SPIFFS.open(SECURITY_LOG_FILE, "r");
 }
\ No newline at end of file
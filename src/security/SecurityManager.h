@@ -2,6 +2,7 @@
 
 #include <mbedtls/aes.h>
 #include <mbedtls/sha256.h>
+#include <FS.h>
 #include <vector>
 #include <map>
 #include "Config.h"
@@ -73,6 +74,7 @@ public:
     // Monitoring
     void logSecurityEvent(const String& event);
     std::vector<String> getSecurityLogs();
+    File openSecurityLog();     // Lecture en flux du journal (timestamp|niveau|événement)
     bool checkIntegrity();
     
     // Data Protection
@@ -81,6 +83,8 @@ public:
     void sanitizeData();
 
 private:
+    static constexpr const char* SECURITY_LOG_FILE = "/secure/security.log";
+    
     SecurityConfig m_config;
     SecurityLevel m_level;
     mbedtls_aes_context m_aesCtx;